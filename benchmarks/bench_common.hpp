@@ -0,0 +1,109 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace mgl::bench {
+
+    /**
+     * @brief Creates an invisible window with a current OpenGL context, so
+     * benchmarks can issue GL calls without showing anything on screen.
+     */
+    inline GLFWwindow* createHiddenContext(int major = 3, int minor = 3) {
+        if (!glfwInit()) {
+            std::fprintf(stderr, "Failed to initialize GLFW\n");
+            std::exit(EXIT_FAILURE);
+        }
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, major);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, minor);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+        GLFWwindow* window = glfwCreateWindow(1280, 720, "benchmark", nullptr, nullptr);
+        if (!window) {
+            std::fprintf(stderr, "Failed to create OpenGL %d.%d context\n", major, minor);
+            glfwTerminate();
+            std::exit(EXIT_FAILURE);
+        }
+        glfwMakeContextCurrent(window);
+        glfwSwapInterval(0);
+
+        if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+            std::fprintf(stderr, "Failed to initialize GLAD\n");
+            std::exit(EXIT_FAILURE);
+        }
+        glViewport(0, 0, 1280, 720);
+        glEnable(GL_DEPTH_TEST);
+        return window;
+    }
+
+    inline void destroyContext(GLFWwindow* window) {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+    }
+
+    /**
+     * @brief Compiles and links a program from inline sources, binding each
+     * (name, location) pair as a vertex attribute before linking.
+     */
+    inline GLuint buildProgram(const char* vertexSrc, const char* fragmentSrc,
+                               const std::vector<std::pair<const char*, GLuint>>& attributes) {
+        auto compile = [](GLenum type, const char* src) {
+            GLuint shader = glCreateShader(type);
+            glShaderSource(shader, 1, &src, nullptr);
+            glCompileShader(shader);
+            GLint ok = GL_FALSE;
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+            if (!ok) {
+                char log[1024];
+                glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+                std::fprintf(stderr, "Shader compilation failed: %s\n", log);
+                std::exit(EXIT_FAILURE);
+            }
+            return shader;
+        };
+
+        GLuint program = glCreateProgram();
+        GLuint vs = compile(GL_VERTEX_SHADER, vertexSrc);
+        GLuint fs = compile(GL_FRAGMENT_SHADER, fragmentSrc);
+        glAttachShader(program, vs);
+        glAttachShader(program, fs);
+        for (const auto& [name, location] : attributes) {
+            glBindAttribLocation(program, location, name);
+        }
+        glLinkProgram(program);
+        glDeleteShader(vs);
+        glDeleteShader(fs);
+        return program;
+    }
+
+    /// Wall-clock time of a callable, in milliseconds
+    template <typename F>
+    double timeMs(F&& fn) {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        const auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    /// GPU time of a callable issuing GL commands, in milliseconds
+    template <typename F>
+    double gpuTimeMs(F&& fn) {
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        glBeginQuery(GL_TIME_ELAPSED, query);
+        fn();
+        glEndQuery(GL_TIME_ELAPSED);
+        GLuint64 elapsedNs = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsedNs);
+        glDeleteQueries(1, &query);
+        return static_cast<double>(elapsedNs) / 1.0e6;
+    }
+
+} // namespace mgl::bench
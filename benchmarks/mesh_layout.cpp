@@ -0,0 +1,137 @@
+// Compares the separate (one VBO per attribute), interleaved and quantized
+// interleaved vertex layouts of mgl::Mesh: upload/VAO setup time and GPU draw time.
+//
+// Vertices are drawn in a shuffled order so that vertex fetch is not
+// trivially sequential, which is where the layouts differ the most.
+
+#include "bench_common.hpp"
+
+#include <mgl/models/meshes/mglMesh.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <random>
+
+namespace {
+
+    const char* VERTEX_SHADER = R"(
+#version 330 core
+in vec3 inPosition;
+in vec3 inNormal;
+in vec2 inTexcoord;
+in vec4 inColor;
+out vec4 exColor;
+void main() {
+    exColor = inColor * vec4(abs(inNormal), 1.0) + vec4(inTexcoord, 0.0, 0.0);
+    gl_Position = vec4(inPosition * 0.5, 1.0);
+}
+)";
+
+    const char* FRAGMENT_SHADER = R"(
+#version 330 core
+in vec4 exColor;
+out vec4 outColor;
+void main() { outColor = exColor; }
+)";
+
+    // Grid of size x size vertices with every attribute, in shuffled vertex order
+    mgl::MeshData makeGrid(unsigned size) {
+        mgl::MeshData data;
+        const unsigned n = size * size;
+        std::vector<unsigned> perm(n);
+        std::iota(perm.begin(), perm.end(), 0u);
+        std::shuffle(perm.begin(), perm.end(), std::mt19937(42));
+
+        data.positions.resize(n);
+        data.normals.resize(n);
+        data.texcoords.resize(n);
+        data.colors.resize(n);
+        for (unsigned y = 0; y < size; y++) {
+            for (unsigned x = 0; x < size; x++) {
+                const unsigned v = perm[y * size + x];
+                const float u = static_cast<float>(x) / (size - 1);
+                const float w = static_cast<float>(y) / (size - 1);
+                data.positions[v] = mgl::math::vec3(u * 2.0f - 1.0f, w * 2.0f - 1.0f, 0.0f);
+                data.normals[v] = mgl::math::vec3(0.0f, 0.0f, 1.0f);
+                data.texcoords[v] = mgl::math::vec2(u, w);
+                data.colors[v] = mgl::math::vec4(u, w, 1.0f - u, 1.0f);
+            }
+        }
+
+        for (unsigned y = 0; y + 1 < size; y++) {
+            for (unsigned x = 0; x + 1 < size; x++) {
+                const unsigned a = perm[y * size + x], b = perm[y * size + x + 1];
+                const unsigned c = perm[(y + 1) * size + x], d = perm[(y + 1) * size + x + 1];
+                data.indices.insert(data.indices.end(), { a, b, d, a, d, c });
+            }
+        }
+        return data;
+    }
+
+    struct Result {
+        double uploadMs;
+        double gpuMsPerFrame;
+    };
+
+    Result run(const mgl::MeshData& grid, bool interleaved, bool quantized, int frames, int drawsPerFrame) {
+        mgl::Mesh mesh;
+        if (interleaved) mesh.interleaveAttributes();
+        if (quantized) mesh.quantizeAttributes();
+
+        Result result{};
+        result.uploadMs = mgl::bench::timeMs([&]() {
+            mesh.createFromData(grid);
+            glFinish();
+        });
+
+        double total = 0.0;
+        for (int f = 0; f < frames; f++) {
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            total += mgl::bench::gpuTimeMs([&]() {
+                for (int d = 0; d < drawsPerFrame; d++) mesh.draw();
+            });
+        }
+        result.gpuMsPerFrame = total / frames;
+        return result;
+    }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const unsigned gridSize = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 1024;
+    const int frames = 64;
+    const int drawsPerFrame = 8;
+
+    GLFWwindow* window = mgl::bench::createHiddenContext();
+    GLuint program = mgl::bench::buildProgram(VERTEX_SHADER, FRAGMENT_SHADER, {
+        { "inPosition", mgl::Mesh::POSITION },
+        { "inNormal",   mgl::Mesh::NORMAL },
+        { "inTexcoord", mgl::Mesh::TEXCOORD },
+        { "inColor",    mgl::Mesh::COLOR },
+    });
+    glUseProgram(program);
+
+    const mgl::MeshData grid = makeGrid(gridSize);
+    std::printf("mesh: %zu vertices, %zu triangles, %d frames x %d draws\n",
+                grid.positions.size(), grid.indices.size() / 3, frames, drawsPerFrame);
+
+    // warm-up run so driver-side allocations do not skew the first layout
+    run(grid, false, false, 4, 1);
+
+    const Result separate = run(grid, false, false, frames, drawsPerFrame);
+    const Result interleaved = run(grid, true, false, frames, drawsPerFrame);
+    const Result quantized = run(grid, true, true, frames, drawsPerFrame);
+
+    std::printf("%-12s %12s %16s\n", "layout", "upload (ms)", "gpu/frame (ms)");
+    std::printf("%-12s %12.3f %16.3f\n", "separate", separate.uploadMs, separate.gpuMsPerFrame);
+    std::printf("%-12s %12.3f %16.3f\n", "interleaved", interleaved.uploadMs, interleaved.gpuMsPerFrame);
+    std::printf("%-12s %12.3f %16.3f\n", "quantized", quantized.uploadMs, quantized.gpuMsPerFrame);
+    std::printf("speedup (gpu): %.2fx interleaved, %.2fx quantized\n",
+                separate.gpuMsPerFrame / interleaved.gpuMsPerFrame,
+                separate.gpuMsPerFrame / quantized.gpuMsPerFrame);
+
+    glDeleteProgram(program);
+    mgl::bench::destroyContext(window);
+    return 0;
+}
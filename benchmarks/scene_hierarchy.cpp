@@ -0,0 +1,118 @@
+// Compares world transform updates of a pointer-based scene tree - heap
+// nodes with children in a std::map, updated recursively like SceneGraph
+// used to during drawing - with one linear pass over a FlatSceneHierarchy,
+// and with an incremental pass after 1% of the nodes moved.
+//
+// Both hierarchies are the same random tree (every node under a random
+// earlier one, a few roots), from 1k to 100k nodes. The full pass moves
+// every root first, so the whole tree is dirty. No OpenGL is needed.
+
+#include "bench_common.hpp"
+
+#include <mgl/scene/mglFlatSceneHierarchy.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+    using mgl::FlatSceneHierarchy;
+    namespace math = mgl::math;
+
+    struct PointerNode {
+        math::mat4 local = math::mat4::identity();
+        math::mat4 world = math::mat4::identity();
+        std::map<mgl::ui32, std::unique_ptr<PointerNode>> children;
+    };
+
+    void updatePointerTree(PointerNode& node, const math::mat4& parent) {
+        node.world = parent * node.local;
+        for (auto& [id, child] : node.children) updatePointerTree(*child, node.world);
+    }
+
+    math::mat4 randomLocal(std::mt19937& random) {
+        std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+        return math::translate(math::mat4::identity(), math::vec3(offset(random), offset(random), offset(random)));
+    }
+
+    /// Best of 'runs' timings, in milliseconds
+    template <typename F>
+    double bestOf(int runs, F&& fn) {
+        double best = 1e30;
+        for (int r = 0; r < runs; r++) best = std::min(best, mgl::bench::timeMs(fn));
+        return best;
+    }
+
+    /// Best of 'runs' updates, each after nudging 'moved' - untimed
+    double bestUpdateOf(int runs, FlatSceneHierarchy& hierarchy, const std::vector<FlatSceneHierarchy::Handle>& moved) {
+        double best = 1e30;
+        for (int r = 0; r < runs; r++) {
+            for (FlatSceneHierarchy::Handle node : moved) {
+                const math::mat4 local = hierarchy.getLocalTransform(node);
+                hierarchy.setLocalTransform(node, math::translate(local, math::vec3(r % 2 ? -0.5f : 0.5f, 0.0f, 0.0f)));
+            }
+            best = std::min(best, mgl::bench::timeMs([&] { hierarchy.updateWorldTransforms(); }));
+        }
+        return best;
+    }
+
+} // namespace
+
+int main() {
+    std::printf("%10s %18s %14s %9s %17s %10s\n", "nodes", "pointer tree (ms)", "flat pass (ms)", "speedup",
+                "1% moved (ms)", "recomputed");
+    for (const mgl::ui32 count : { 1000u, 10000u, 100000u }) {
+        std::mt19937 random(count);
+
+        // parent of every node: one of the earlier ones, every 1000th a root
+        std::vector<mgl::ui32> parents(count, FlatSceneHierarchy::NONE);
+        for (mgl::ui32 i = 1; i < count; i++) {
+            if (i % 1000 != 0) parents[i] = std::uniform_int_distribution<mgl::ui32>(0, i - 1)(random);
+        }
+        std::vector<math::mat4> locals(count);
+        for (math::mat4& local : locals) local = randomLocal(random);
+
+        PointerNode scene;
+        std::vector<PointerNode*> pointerNodes(count);
+        FlatSceneHierarchy hierarchy;
+        std::vector<FlatSceneHierarchy::Handle> handles(count);
+        for (mgl::ui32 i = 0; i < count; i++) {
+            PointerNode& parent = parents[i] == FlatSceneHierarchy::NONE ? scene : *pointerNodes[parents[i]];
+            auto node = std::make_unique<PointerNode>();
+            node->local = locals[i];
+            pointerNodes[i] = node.get();
+            parent.children.emplace(i, std::move(node));
+
+            handles[i] = hierarchy.create(parents[i] == FlatSceneHierarchy::NONE ? FlatSceneHierarchy::NONE : handles[parents[i]]);
+            hierarchy.setLocalTransform(handles[i], locals[i]);
+        }
+
+        std::vector<FlatSceneHierarchy::Handle> roots, sample;
+        for (mgl::ui32 i = 0; i < count; i++) {
+            if (parents[i] == FlatSceneHierarchy::NONE) roots.push_back(handles[i]);
+            if (i % 100 == 0) sample.push_back(handles[std::uniform_int_distribution<mgl::ui32>(0, count - 1)(random)]);
+        }
+
+        hierarchy.updateWorldTransforms();
+        const double flat = bestUpdateOf(20, hierarchy, roots);
+        const double incremental = bestUpdateOf(20, hierarchy, sample);
+        const double recomputed = 100.0 * hierarchy.getLastUpdate().updated / count;
+
+        // the pointer tree has no dirty tracking - it gets the final locals
+        for (mgl::ui32 i = 0; i < count; i++) pointerNodes[i]->local = hierarchy.getLocalTransform(handles[i]);
+        const double pointer = bestOf(20, [&] { updatePointerTree(scene, math::mat4::identity()); });
+
+        for (mgl::ui32 i = 0; i < count; i++) {
+            if (pointerNodes[i]->world != hierarchy.getWorldTransform(handles[i])) {
+                std::fprintf(stderr, "World transforms differ at node %u\n", i);
+                return EXIT_FAILURE;
+            }
+        }
+        std::printf("%10u %18.3f %14.3f %8.1fx %17.3f %9.1f%%\n", count, pointer, flat, pointer / flat, incremental, recomputed);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+// Scaling of the parallel FlatSceneHierarchy update with the number of
+// worker threads, from 1 to the hardware concurrency, against the serial
+// pass. Every root is moved before each timed update, so the whole tree is
+// recomputed, and the parallel results are checked against the serial ones.
+//
+// The trees are random (every node under a random earlier one, a few
+// roots), of 100k and 1M nodes. No OpenGL is needed.
+
+#include "bench_common.hpp"
+
+#include <mgl/scene/mglFlatSceneHierarchy.hpp>
+#include <utils/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using mgl::FlatSceneHierarchy;
+    namespace math = mgl::math;
+
+    struct Tree {
+        FlatSceneHierarchy hierarchy;
+        std::vector<FlatSceneHierarchy::Handle> handles;
+        std::vector<FlatSceneHierarchy::Handle> roots;
+    };
+
+    void build(Tree& tree, mgl::ui32 count) {
+        std::mt19937 random(count);
+        std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+        tree.handles.resize(count);
+        for (mgl::ui32 i = 0; i < count; i++) {
+            const bool root = i % 1000 == 0;
+            const mgl::ui32 parent = root ? 0 : std::uniform_int_distribution<mgl::ui32>(0, i - 1)(random);
+            tree.handles[i] = tree.hierarchy.create(root ? FlatSceneHierarchy::NONE : tree.handles[parent]);
+            tree.hierarchy.setLocalTransform(tree.handles[i], math::translate(math::mat4::identity(),
+                math::vec3(offset(random), offset(random), offset(random))));
+            if (root) tree.roots.push_back(tree.handles[i]);
+        }
+        tree.hierarchy.updateWorldTransforms();
+    }
+
+    /// Best of 'runs' full updates, in milliseconds. Moving the roots is not timed
+    template <typename F>
+    double bestUpdateOf(int runs, Tree& tree, F&& update) {
+        double best = 1e30;
+        for (int r = 0; r < runs; r++) {
+            for (FlatSceneHierarchy::Handle root : tree.roots) {
+                tree.hierarchy.setLocalTransform(root, math::translate(tree.hierarchy.getLocalTransform(root),
+                    math::vec3(r % 2 ? -0.5f : 0.5f, 0.0f, 0.0f)));
+            }
+            best = std::min(best, mgl::bench::timeMs(update));
+        }
+        return best;
+    }
+
+} // namespace
+
+int main() {
+    const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> workerCounts;
+    for (size_t workers = 1; workers < cores; workers *= 2) workerCounts.push_back(workers);
+    workerCounts.push_back(cores);
+
+    std::printf("%10s %9s %12s %9s\n", "nodes", "workers", "update (ms)", "speedup");
+    for (const mgl::ui32 count : { 100000u, 1000000u }) {
+        Tree tree;
+        build(tree, count);
+
+        const double serial = bestUpdateOf(10, tree, [&] { tree.hierarchy.updateWorldTransforms(); });
+        std::printf("%10u %9s %12.3f %8.2fx\n", count, "serial", serial, 1.0);
+        for (const size_t workers : workerCounts) {
+            util::ThreadPool pool(workers);
+            const double parallel = bestUpdateOf(10, tree, [&] { tree.hierarchy.updateWorldTransforms(pool); });
+            std::printf("%10u %9zu %12.3f %8.2fx\n", count, workers, parallel, serial / parallel);
+        }
+
+        // one more update both ways, from the same state
+        Tree reference = tree;
+        bestUpdateOf(1, reference, [&] { reference.hierarchy.updateWorldTransforms(); });
+        bestUpdateOf(1, tree, [&] { tree.hierarchy.updateWorldTransforms(util::ThreadPool::shared()); });
+        for (mgl::ui32 i = 0; i < count; i++) {
+            if (tree.hierarchy.getWorldTransform(tree.handles[i]) != reference.hierarchy.getWorldTransform(tree.handles[i])) {
+                std::fprintf(stderr, "World transforms differ at node %u\n", i);
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
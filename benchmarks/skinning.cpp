@@ -0,0 +1,289 @@
+// Compares CPU and GPU skinning of many animated characters in a hidden
+// window: the CPU path skins with mgl::Skinning (AVX and scalar) and streams
+// the result through a DynamicMesh, the GPU path uploads one BonePalette per
+// frame and skins in the vertex shader from packed bone attributes.
+//
+// Every character is a procedurally generated tube with a chain of bones
+// playing its own phase of a swaying clip.
+
+#include "bench_common.hpp"
+
+#include <mgl/models/meshes/mglDynamicMesh.hpp>
+#include <mgl/models/skeletal/mglAnimationClip.hpp>
+#include <mgl/models/skeletal/mglBonePalette.hpp>
+#include <mgl/models/skeletal/mglSkinning.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+    const char* CPU_VERTEX_SHADER = R"(
+#version 330 core
+in vec3 inPosition;
+in vec3 inNormal;
+uniform vec2 Offset;
+out vec3 exNormal;
+void main() {
+    exNormal = inNormal;
+    gl_Position = vec4(inPosition.xy * 0.05 + Offset, inPosition.z * 0.05, 1.0);
+}
+)";
+
+    const char* GPU_VERTEX_SHADER = R"(
+#version 330 core
+in vec3 inPosition;
+in vec3 inNormal;
+in uvec4 inBoneIndices;
+in vec4 inBoneWeights;
+uniform samplerBuffer BonePalette;
+uniform int BoneOffset;
+uniform vec2 Offset;
+out vec3 exNormal;
+mat4 bone(uint i) {
+    int t = (BoneOffset + int(i)) * 4;
+    return mat4(texelFetch(BonePalette, t), texelFetch(BonePalette, t + 1),
+                texelFetch(BonePalette, t + 2), texelFetch(BonePalette, t + 3));
+}
+void main() {
+    mat4 skin = bone(inBoneIndices.x) * inBoneWeights.x + bone(inBoneIndices.y) * inBoneWeights.y +
+                bone(inBoneIndices.z) * inBoneWeights.z + bone(inBoneIndices.w) * inBoneWeights.w;
+    vec4 position = skin * vec4(inPosition, 1.0);
+    exNormal = normalize(mat3(skin) * inNormal);
+    gl_Position = vec4(position.xy * 0.05 + Offset, position.z * 0.05, 1.0);
+}
+)";
+
+    const char* FRAGMENT_SHADER = R"(
+#version 330 core
+in vec3 exNormal;
+out vec4 outColor;
+void main() { outColor = vec4(abs(exNormal), 1.0); }
+)";
+
+    constexpr unsigned BONES = 16;
+
+    mgl::math::mat4 translation(float x, float y, float z) {
+        return mgl::math::translate(mgl::math::mat4::identity(), mgl::math::vec3(x, y, z));
+    }
+
+    float boneHeight(unsigned bone) {
+        return -1.0f + 2.0f * static_cast<float>(bone) / BONES;
+    }
+
+    // Chain of bones along the y axis, from y = -1 upwards
+    mgl::Skeleton makeSkeleton() {
+        mgl::Skeleton skeleton;
+        for (unsigned b = 0; b < BONES; b++) {
+            const float y = boneHeight(b);
+            const float parentY = b == 0 ? 0.0f : boneHeight(b - 1);
+            skeleton.addBone({ "bone" + std::to_string(b), static_cast<mgl::i32>(b) - 1,
+                               translation(0.0f, y - parentY, 0.0f), translation(0.0f, -y, 0.0f) });
+        }
+        return skeleton;
+    }
+
+    // Every bone sways around z, alternating directions
+    mgl::AnimationClip makeClip() {
+        mgl::AnimationClip clip;
+        clip.name = "sway";
+        clip.duration = 2.0f;
+        for (unsigned b = 1; b < BONES; b++) {
+            mgl::AnimationClip::Channel channel;
+            channel.bone = static_cast<mgl::i32>(b);
+            channel.translations = { { 0.0f, mgl::math::vec3(0.0f, 2.0f / BONES, 0.0f) } };
+            const float angle = (b % 2 ? 0.15f : -0.1f);
+            for (int k = 0; k <= 4; k++) {
+                const float time = 0.5f * k;
+                channel.rotations.push_back({ time, mgl::math::quat::fromZ(angle * std::sin(time * 3.1415927f)) });
+            }
+            clip.channels.push_back(channel);
+        }
+        return clip;
+    }
+
+    // Tube of rings x segments vertices, skinned to the two closest bones
+    void makeTube(unsigned rings, unsigned segments, mgl::MeshData& data, std::vector<mgl::VertexSkin>& skin) {
+        mgl::SkinBuilder builder(rings * segments);
+        for (unsigned r = 0; r < rings; r++) {
+            const float y = -1.0f + 2.0f * r / (rings - 1);
+            const float bone = std::min((y + 1.0f) * BONES / 2.0f, BONES - 1.0f);
+            const unsigned lower = static_cast<unsigned>(bone);
+            const float blend = bone - lower;
+            for (unsigned s = 0; s < segments; s++) {
+                const float a = 6.2831853f * s / segments;
+                const size_t v = data.positions.size();
+                data.positions.emplace_back(0.1f * std::cos(a), y, 0.1f * std::sin(a));
+                data.normals.emplace_back(std::cos(a), 0.0f, std::sin(a));
+                builder.addInfluence(v, lower, 1.0f - blend);
+                if (lower + 1 < BONES) builder.addInfluence(v, lower + 1, blend);
+            }
+        }
+        for (unsigned r = 0; r + 1 < rings; r++) {
+            for (unsigned s = 0; s < segments; s++) {
+                const unsigned a = r * segments + s, b = r * segments + (s + 1) % segments;
+                const unsigned c = a + segments, d = b + segments;
+                data.indices.insert(data.indices.end(), { a, c, b, b, c, d });
+            }
+        }
+        skin = builder.build();
+    }
+
+    GLint offsetLocation = -1;
+
+    void setOffset(unsigned character, unsigned characters) {
+        const unsigned columns = static_cast<unsigned>(std::ceil(std::sqrt(static_cast<float>(characters))));
+        const float step = 1.8f / columns;
+        glUniform2f(offsetLocation, -0.9f + step * (character % columns + 0.5f),
+                    -0.9f + step * (character / columns + 0.5f));
+    }
+
+    struct Result {
+        double cpuMsPerFrame;
+        double gpuMsPerFrame;
+    };
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const unsigned characters = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 128;
+    const int frames = 64;
+    const float dt = 1.0f / 60.0f;
+
+    GLFWwindow* window = mgl::bench::createHiddenContext();
+
+    {
+        const mgl::Skeleton skeleton = makeSkeleton();
+        const mgl::AnimationClip clip = makeClip();
+        mgl::MeshData tube;
+        std::vector<mgl::VertexSkin> skin;
+        makeTube(128, 32, tube, skin);
+
+        std::vector<mgl::Animator> animators;
+        for (unsigned c = 0; c < characters; c++) {
+            animators.emplace_back(skeleton);
+            animators.back().play(&clip);
+            animators.back().update(0.013f * c); // desynchronize the characters
+        }
+
+        std::printf("%u characters, %zu vertices and %u bones each, %d frames (avx: %s)\n",
+                    characters, tube.positions.size(), BONES, frames, mgl::Skinning::hasAvx() ? "yes" : "no");
+
+        // CPU skinning into one DynamicMesh per character
+        GLuint cpuProgram = mgl::bench::buildProgram(CPU_VERTEX_SHADER, FRAGMENT_SHADER, {
+            { "inPosition", mgl::Mesh::POSITION },
+            { "inNormal",   mgl::Mesh::NORMAL },
+        });
+        std::vector<std::unique_ptr<mgl::DynamicMesh>> dynamicMeshes;
+        for (unsigned c = 0; c < characters; c++) {
+            dynamicMeshes.push_back(std::make_unique<mgl::DynamicMesh>());
+            dynamicMeshes.back()->create(tube);
+        }
+        std::vector<mgl::math::vec3> positions(tube.positions.size()), normals(tube.normals.size());
+
+        auto runCpu = [&](bool avx) {
+            glUseProgram(cpuProgram);
+            offsetLocation = glGetUniformLocation(cpuProgram, "Offset");
+            Result result{};
+            double skinMs = 0.0;
+            for (int f = 0; f < frames; f++) {
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                result.gpuMsPerFrame += mgl::bench::gpuTimeMs([&]() {
+                    result.cpuMsPerFrame += mgl::bench::timeMs([&]() {
+                        for (unsigned c = 0; c < characters; c++) {
+                            animators[c].update(dt);
+                            skinMs += mgl::bench::timeMs([&]() {
+                                if (avx) {
+                                    mgl::Skinning::skin(tube.positions, tube.normals, skin,
+                                                        animators[c].getPalette(), positions, normals);
+                                }
+                                else {
+                                    mgl::Skinning::skinScalar(tube.positions, tube.normals, skin,
+                                                              animators[c].getPalette(), positions, normals);
+                                }
+                            });
+                            dynamicMeshes[c]->updatePositions(positions);
+                            dynamicMeshes[c]->updateNormals(normals);
+                            setOffset(c, characters);
+                            dynamicMeshes[c]->draw();
+                        }
+                    });
+                });
+            }
+            std::printf("  %-10s skinning only: %.3f ms/frame\n", avx ? "cpu avx" : "cpu scalar", skinMs / frames);
+            result.cpuMsPerFrame /= frames;
+            result.gpuMsPerFrame /= frames;
+            return result;
+        };
+
+        // GPU skinning: static meshes with bone attributes and a shared palette
+        GLuint gpuProgram = mgl::bench::buildProgram(GPU_VERTEX_SHADER, FRAGMENT_SHADER, {
+            { "inPosition",    mgl::Mesh::POSITION },
+            { "inNormal",      mgl::Mesh::NORMAL },
+            { "inBoneIndices", mgl::Mesh::BONE_INDICES },
+            { "inBoneWeights", mgl::Mesh::BONE_WEIGHTS },
+        });
+        std::vector<std::unique_ptr<mgl::Mesh>> skinnedMeshes;
+        mgl::BonePalette palette;
+        std::vector<mgl::ui32> paletteOffsets;
+        for (unsigned c = 0; c < characters; c++) {
+            skinnedMeshes.push_back(std::make_unique<mgl::Mesh>());
+            skinnedMeshes.back()->createFromData(tube);
+            skinnedMeshes.back()->setSkin(skin);
+            paletteOffsets.push_back(palette.allocate(BONES));
+        }
+
+        auto runGpu = [&]() {
+            glUseProgram(gpuProgram);
+            offsetLocation = glGetUniformLocation(gpuProgram, "Offset");
+            const GLint boneOffsetLocation = glGetUniformLocation(gpuProgram, "BoneOffset");
+            glUniform1i(glGetUniformLocation(gpuProgram, "BonePalette"), 0);
+            Result result{};
+            for (int f = 0; f < frames; f++) {
+                glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+                result.gpuMsPerFrame += mgl::bench::gpuTimeMs([&]() {
+                    result.cpuMsPerFrame += mgl::bench::timeMs([&]() {
+                        for (unsigned c = 0; c < characters; c++) {
+                            animators[c].update(dt);
+                            palette.write(paletteOffsets[c], animators[c].getPalette());
+                        }
+                        palette.upload();
+                        palette.bind(0);
+                        for (unsigned c = 0; c < characters; c++) {
+                            glUniform1i(boneOffsetLocation, static_cast<GLint>(paletteOffsets[c]));
+                            setOffset(c, characters);
+                            skinnedMeshes[c]->draw();
+                        }
+                    });
+                });
+            }
+            result.cpuMsPerFrame /= frames;
+            result.gpuMsPerFrame /= frames;
+            return result;
+        };
+
+        // warm-up run so driver-side allocations do not skew the first path
+        runCpu(false);
+
+        const Result scalar = runCpu(false);
+        const Result avx = runCpu(true);
+        const Result gpu = runGpu();
+
+        std::printf("%-12s %16s %16s\n", "path", "cpu/frame (ms)", "gpu/frame (ms)");
+        std::printf("%-12s %16.3f %16.3f\n", "cpu scalar", scalar.cpuMsPerFrame, scalar.gpuMsPerFrame);
+        std::printf("%-12s %16.3f %16.3f\n", "cpu avx", avx.cpuMsPerFrame, avx.gpuMsPerFrame);
+        std::printf("%-12s %16.3f %16.3f\n", "gpu", gpu.cpuMsPerFrame, gpu.gpuMsPerFrame);
+        std::printf("speedup (cpu/frame): %.2fx avx, %.2fx gpu\n",
+                    scalar.cpuMsPerFrame / avx.cpuMsPerFrame, scalar.cpuMsPerFrame / gpu.cpuMsPerFrame);
+
+        glDeleteProgram(cpuProgram);
+        glDeleteProgram(gpuProgram);
+    } // meshes and the palette are released before the context
+
+    mgl::bench::destroyContext(window);
+    return 0;
+}
@@ -100,6 +100,12 @@ constexpr mat_t<C,R,T> transpose(const mat_t<R,C,T>& A) {
     return mat_t<C,R,T>{ glm::transpose(typename mat_t<R,C,T>::backend_t(A.m)) };
 }
 
+// inverse: (N×N) -> (N×N)
+template<int N, typename T>
+constexpr mat_t<N,N,T> inverse(const mat_t<N,N,T>& A) {
+    return mat_t<N,N,T>{ glm::inverse(typename mat_t<N,N,T>::backend_t(A.m)) };
+}
+
 // ------------------------------------------------
 // Operator overloads
 // ------------------------------------------------
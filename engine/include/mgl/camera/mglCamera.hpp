@@ -23,6 +23,7 @@ namespace mgl {
     class Camera : public Transform {
 	public:
 		Camera(i32 bindingPoint);
+		~Camera();
 
 		static void orthoResize(OrthoParams* params, i32 winx, i32 winy);
 		static void perspectiveResize(PerspectiveParams* params, i32 winx, i32 winy);
@@ -40,11 +41,17 @@ namespace mgl {
 		void yaw(f32 degrees);
 		void setActive();
 
+		// Camera whose matrices were last bound by setActive(), if any
+		static Camera* getActive();
+
 		math::vec3 getFrontV() const;
 		math::vec3 getRightV() const;
 		math::vec3 getUpV() const;
 		math::vec3 getPosition() const;
 		math::mat4 getViewMatrix() const;
+		math::mat4 getProjectionMatrix() const;
+		// Height in pixels of the window the camera renders to
+		i32 getViewportHeight() const;
 
 		virtual void updateScreenRatio(i32 width, i32 height) = 0;
 
@@ -55,6 +62,7 @@ namespace mgl {
 
 		math::mat4 viewMatrix;
 		math::mat4 projectionMatrix;
+		i32 viewportHeight;
 
 		void updateViewMatrix();
 		void computeViewMatrix();
@@ -63,6 +71,9 @@ namespace mgl {
 		virtual void updateProjectionMatrix();
 		virtual void computeProjectionMatrix() = 0;
 		void setProjectionMatrix();
+
+	private:
+		static inline Camera* activeCamera = nullptr;
 	};
 
 }
@@ -0,0 +1,67 @@
+#ifndef MGL_BOUNDS_HPP
+#define MGL_BOUNDS_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+
+#include <limits>
+#include <span>
+
+namespace mgl {
+
+//////////////////////////////////////////////////////////////////////////// AABB
+/*
+    Axis-aligned bounding box. A default constructed box is empty
+    (min > max) and grows as points or other boxes are added to it.
+*/
+struct AABB {
+    math::vec3 min = math::vec3(std::numeric_limits<float>::max());
+    math::vec3 max = math::vec3(std::numeric_limits<float>::lowest());
+
+    static AABB fromPoints(std::span<const math::vec3> points);
+
+    bool empty() const;
+    math::vec3 center() const;
+    math::vec3 halfExtent() const;
+
+    void expand(const math::vec3& point);
+    void expand(const AABB& box);
+
+    // Box enclosing this one after transforming it by m, computed straight
+    // from the matrix entries instead of the 8 corners (Arvo, Graphics Gems 1990)
+    AABB transformed(const math::mat4& m) const;
+};
+
+//////////////////////////////////////////////////////////////////////////// BoundingSphere
+/*
+    Sphere around a set of points, centered on their AABB. Not the smallest
+    enclosing sphere, but tight for most meshes and cheap to build.
+    A negative radius means empty.
+*/
+struct BoundingSphere {
+    math::vec3 center;
+    float radius = -1.0f;
+
+    static BoundingSphere fromPoints(std::span<const math::vec3> points, const AABB& box);
+
+    bool empty() const;
+
+    // Sphere enclosing this one after transforming it by m - the radius
+    // grows with the largest axis scale
+    BoundingSphere transformed(const math::mat4& m) const;
+};
+
+//////////////////////////////////////////////////////////////////////////// Bounds
+struct Bounds {
+    AABB box;
+    BoundingSphere sphere;
+
+    static Bounds fromPoints(std::span<const math::vec3> points);
+
+    // Bounds enclosing all the given ones
+    static Bounds merge(std::span<const Bounds> parts);
+};
+
+}
+
+#endif // !MGL_BOUNDS_HPP
@@ -33,6 +33,27 @@ const char TANGENT_ATTRIBUTE[] = "inTangent";
 const char BITANGENT_ATTRIBUTE[] = "inBitangent";
 const char COLOR_ATTRIBUTE[] = "inColor";
 
+// Per-instance model matrix of instanced draws (see InstancedSceneObject).
+// A mat4 attribute takes 4 consecutive locations, starting right after
+// the Mesh vertex attributes. Replaces the MODEL_MATRIX uniform.
+const char MODEL_MATRIX_ATTRIBUTE[] = "inModelMatrix";
+const int MODEL_MATRIX_ATTRIBUTE_INDEX = 5;
+
+// GPU skinning (see Mesh::setSkin and BonePalette): bone indices (uvec4) and
+// weights (vec4) per vertex, and the palettes of all skeletons in a
+// samplerBuffer (4 RGBA32F texels per bone), starting at BONE_OFFSET
+const char BONE_INDICES_ATTRIBUTE[] = "inBoneIndices";
+const char BONE_WEIGHTS_ATTRIBUTE[] = "inBoneWeights";
+const char BONE_PALETTE[] = "BonePalette";
+const char BONE_OFFSET[] = "BoneOffset";
+
+// GPU morph targets (see MorphTargetBuffer): the (first, count) delta range
+// of every vertex in a usamplerBuffer, the deltas in a samplerBuffer and one
+// weight per target in a float array
+const char MORPH_RANGES[] = "MorphRanges";
+const char MORPH_DELTAS[] = "MorphDeltas";
+const char MORPH_WEIGHTS[] = "MorphWeights";
+
 ////////////////////////////////////////////////////////////////////////////////
 }  // namespace mgl
 
@@ -96,6 +96,9 @@ protected:
     void updateTransform();
     void normalizeTransform();
 
+    // called whenever transformMatrix changes
+    virtual void onTransformChanged() {}
+
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,111 @@
+#ifndef MGL_DYNAMIC_MESH_HPP
+#define MGL_DYNAMIC_MESH_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+#include <glad/glad.h>
+#include <mgl/models/meshes/mglMesh.hpp>
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * Mesh whose vertex attributes are rewritten at runtime, e.g. deformable
+	 * or procedurally animated geometry. Indices and submeshes are fixed.
+	 *
+	 * Attributes live in a ring of REGIONS copies inside one persistently
+	 * mapped buffer (GL 4.4 buffer storage). Updates go to a CPU copy; the
+	 * first draw after an update moves to the next region, waits for the
+	 * fence placed after that region's last draw, and writes the changed
+	 * vertex ranges into it. The GPU never waits on the CPU and buffers are
+	 * never reallocated. On older contexts a single region is updated with
+	 * glBufferSubData instead.
+	 *
+	 * Vertices are stored as plain floats. LODs and meshlets are not supported,
+	 * since they are derived from static geometry.
+	 */
+	class DynamicMesh : public Mesh {
+	public:
+		static constexpr unsigned REGIONS = 3;
+
+		DynamicMesh();
+		~DynamicMesh();
+		DynamicMesh(const DynamicMesh&) = delete;
+		DynamicMesh& operator=(const DynamicMesh&) = delete;
+
+		/**
+		 * Creates the mesh from its initial data (validated as in
+		 * Mesh::createFromData). Only the attributes given here can be updated.
+		 */
+		void create(MeshData data);
+
+		/**
+		 * Overwrite the vertices [first, first + values.size()) of an attribute.
+		 * Takes effect on the next draw.
+		 */
+		void updatePositions(std::span<const math::vec3> values, size_t first = 0);
+		void updateNormals(std::span<const math::vec3> values, size_t first = 0);
+		void updateTexcoords(std::span<const math::vec2> values, size_t first = 0);
+		void updateColors(std::span<const math::vec4> values, size_t first = 0);
+
+		size_t getVertexCount() const;
+		bool isPersistent() const;
+
+	protected:
+		void performDraw() override;
+		void createVertexBuffers(const MeshView& data, const VertexQuantizer* quantizer) override;
+
+	private:
+		// Vertices changed since a region was last written, as [first, last)
+		struct DirtyRange {
+			size_t first = SIZE_MAX;
+			size_t last = 0;
+		};
+
+		// One attribute array per region, located at 'offset' within the region
+		struct Stream {
+			u8 id = 0;
+			GLint components = 0;
+			size_t elementSize = 0;
+			size_t offset = 0;
+			bool enabled = false;
+			std::array<DirtyRange, REGIONS> dirty = {};
+		};
+
+		std::vector<math::vec3> positions;
+		std::vector<math::vec3> normals;
+		std::vector<math::vec2> texcoords;
+		std::vector<math::vec4> colors;
+		std::vector<ui32> indices;
+		std::vector<Submesh> submeshes;
+
+		std::array<Stream, 4> streams;
+		GLuint ringBuffer = 0;
+		std::byte* mapped = nullptr;
+		std::array<GLsync, REGIONS> fences = {};
+		size_t regionSize = 0;
+		unsigned regions = 1;
+		unsigned current = 0;
+		int pointedRegion = -1;
+		bool changed = false;
+		bool positionsChanged = false;
+
+		template <typename T>
+		void update(Stream& stream, std::vector<T>& shadow, std::span<const T> values, size_t first);
+		const std::byte* shadowOf(const Stream& stream) const;
+
+		/// Moves to the next region and writes the vertices changed since it was last used
+		void commit();
+		void writeRegion(unsigned region);
+		void waitFence(unsigned region);
+		void pointAttributes(unsigned region);
+		void destroyRing();
+	};
+
+}
+
+#endif // !MGL_DYNAMIC_MESH_HPP
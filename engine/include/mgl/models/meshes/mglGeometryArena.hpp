@@ -0,0 +1,113 @@
+#ifndef MGL_GEOMETRY_ARENA_HPP
+#define MGL_GEOMETRY_ARENA_HPP
+
+#include "types.hpp"
+#include <glad/glad.h>
+#include <utils/RangeAllocator.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * Shared vertex and index buffers for every mesh of one vertex format.
+	 *
+	 * Meshes allocate a range of vertices and a range of index bytes from a
+	 * few large buffers instead of owning their own, and are drawn through
+	 * the arena's single VAO with the range's base vertex and index offset.
+	 * Switching between such meshes needs no VAO or buffer changes, which is
+	 * what batching and indirect draws rely on.
+	 *
+	 * Buffers grow (by copying on the GPU) when full. Freed ranges are reused
+	 * first-fit (see util::RangeAllocator); defragment() compacts the live
+	 * ranges and bumps the generation so owners can refresh their offsets.
+	 */
+	class GeometryArena {
+	public:
+		/// Interleaved vertex attribute, as passed to glVertexAttribPointer
+		struct VertexAttribute {
+			GLuint location;
+			GLint components;
+			GLenum type;
+			GLboolean normalized;
+			size_t offset;
+			bool operator==(const VertexAttribute&) const = default;
+		};
+
+		struct VertexFormat {
+			std::vector<VertexAttribute> attributes;
+			size_t stride = 0;
+			bool operator==(const VertexFormat&) const = default;
+		};
+
+		using Handle = ui32;
+		static constexpr Handle INVALID = ~0u;
+
+		/// Current place of an allocation in the arena buffers
+		struct Range {
+			size_t firstVertex;
+			size_t vertexCount;
+			size_t indexOffset; // bytes, 4-byte aligned
+			size_t indexBytes;
+		};
+
+		explicit GeometryArena(const VertexFormat& format, size_t vertexCapacity = 1 << 16,
+		                       size_t indexCapacity = 1 << 20);
+		~GeometryArena();
+		GeometryArena(const GeometryArena&) = delete;
+		GeometryArena& operator=(const GeometryArena&) = delete;
+
+		/// The arena shared by all meshes of a format, created on first use and
+		/// destroyed with the last mesh using it
+		static std::shared_ptr<GeometryArena> forFormat(const VertexFormat& format);
+
+		/// Allocates vertexCount vertices and indexBytes bytes of indices,
+		/// growing the buffers if needed
+		Handle allocate(size_t vertexCount, size_t indexBytes);
+		void release(Handle handle);
+		const Range& getRange(Handle handle) const;
+
+		/**
+		 * Maps the vertices / indices of a range for writing. Only one range
+		 * may be mapped at a time; unmap() before drawing or allocating.
+		 */
+		std::byte* mapVertices(Handle handle);
+		std::byte* mapIndices(Handle handle);
+		void unmap();
+
+		/// Moves all live ranges to the front of fresh buffers
+		void defragment();
+
+		/// Changes whenever ranges move (see defragment)
+		u64 getGeneration() const;
+		GLuint getVao() const;
+		const VertexFormat& getFormat() const;
+
+		/// Fragmentation of the vertex or index space, whichever is worse (see util::RangeAllocator)
+		float fragmentation() const;
+		size_t getVertexCount() const;
+		size_t getIndexBytes() const;
+
+	private:
+		VertexFormat format;
+		GLuint vao = 0;
+		GLuint vertexBuffer = 0;
+		GLuint indexBuffer = 0;
+		util::RangeAllocator vertices;
+		util::RangeAllocator indices;
+		std::vector<Range> ranges;
+		std::vector<char> live;
+		std::vector<Handle> freeHandles;
+		u64 generation = 0;
+
+		/// Replaces buffer with one of 'bytes' bytes holding its first 'copied' bytes
+		static void reallocate(GLuint& buffer, size_t bytes, size_t copied);
+		void setupVao();
+		std::byte* map(GLuint buffer, size_t offset, size_t bytes);
+	};
+
+}
+
+#endif // !MGL_GEOMETRY_ARENA_HPP
@@ -0,0 +1,54 @@
+#ifndef MGL_LOD_SELECTOR_HPP
+#define MGL_LOD_SELECTOR_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+
+#include <span>
+
+namespace mgl {
+
+	/**
+	 * Chooses the LOD of a mesh from the screen-space size of its
+	 * simplification errors: the coarsest LOD whose error projects to at most
+	 * 'pixelError' pixels is drawn.
+	 *
+	 * The selector remembers the current LOD and applies hysteresis around the
+	 * threshold, so an object sitting at a switching distance does not pop
+	 * between two LODs every frame: a coarser LOD is only taken once its error
+	 * drops below pixelError * (1 - hysteresis), and the current one is only
+	 * refined once its error exceeds pixelError * (1 + hysteresis).
+	 */
+	class LodSelector {
+	public:
+		void setPixelError(float pixels);
+		void setHysteresis(float fraction);
+		float getPixelError() const { return _pixelError; }
+		float getHysteresis() const { return _hysteresis; }
+
+		/// LOD chosen by the last select() call
+		unsigned getLevel() const { return _level; }
+
+		/**
+		 * Updates and returns the LOD.
+		 * @param lodErrors object-space error of every simplified LOD, where
+		 * lodErrors[i] belongs to LOD i + 1 - LOD 0 is exact
+		 * @param pixelsPerUnit screen pixels covered by one object-space unit
+		 */
+		unsigned select(std::span<const float> lodErrors, float pixelsPerUnit);
+
+		/**
+		 * Screen pixels covered by one world-space unit seen at 'distance' from
+		 * the camera, for a perspective or orthographic projection.
+		 */
+		static float pixelsPerUnit(const math::mat4& projection, float viewportHeight, float distance);
+
+	private:
+		float _pixelError = 1.0f;
+		float _hysteresis = 0.25f;
+		unsigned _level = 0;
+	};
+
+}
+
+#endif // !MGL_LOD_SELECTOR_HPP
@@ -6,8 +6,14 @@
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include "math/math.hpp"
+#include <mgl/mglBounds.hpp>
+#include <mgl/models/meshes/mglGeometryArena.hpp>
+#include <utils/file.hpp>
 
 #include <assimp/Importer.hpp>
+#include <array>
+#include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -16,6 +22,37 @@
 
 namespace mgl {
 
+    class VertexQuantizer;
+
+    // @brief Range of the mesh index/vertex buffers drawn with a single call.
+    // Indices of a submesh are relative to its baseVertex.
+    struct Submesh {
+        unsigned int n_indices = 0;
+        unsigned int baseIndex = 0;
+        unsigned int baseVertex = 0;
+    };
+
+    // @brief Cluster of up to 64 vertices / 124 triangles of a submesh, drawn
+    // as a contiguous index range (baseIndex is into the whole mesh indices).
+    // Its bounding sphere and normal cone let clusters outside the frustum or
+    // facing away from the camera be skipped. coneCutoff is 1 for clusters
+    // too curved to ever face away.
+    struct Meshlet {
+        unsigned int n_indices = 0;
+        unsigned int baseIndex = 0;
+        unsigned int submesh = 0;
+        math::vec3 center;
+        float radius = 0.0f;
+        math::vec3 coneAxis;
+        float coneCutoff = 1.0f;
+    };
+
+    // @brief Bones influencing a skinned vertex (up to 4) and their weights,
+    // normalized so they add up to 255. Unused slots have weight 0.
+    struct VertexSkin {
+        std::array<u8, 4> bones = {};
+        std::array<u8, 4> weights = {};
+    };
 
     // @brief Structure to hold mesh data with generic types.
     // Usually used for mesh initialization
@@ -28,6 +65,27 @@ namespace mgl {
         // TODO maybe we could make the entire vec the generic type.
         // users may want to use vec3 instead of vec4
         std::vector<math::vec4> colors;
+
+        // Optional - if empty, all indices form a single submesh
+        std::vector<Submesh> submeshes;
+    };
+
+    // @brief Non-owning view over mesh data. Lets geometry that lives outside
+    // a Mesh (e.g. a memory-mapped mesh cache) be uploaded without copies.
+    // Empty optional attributes are treated as not loaded.
+    struct MeshView {
+        std::span<const math::vec3> positions;
+        std::span<const ui32> indices;
+        std::span<const math::vec3> normals;
+        std::span<const math::vec2> texcoords;
+        std::span<const math::vec4> colors;
+        std::span<const Submesh> submeshes;
+        // Simplified LODs: one range per submesh and LOD, LOD-major, with the
+        // object-space error of each LOD (see Mesh::generateLods)
+        std::span<const Submesh> lodSubmeshes;
+        std::span<const float> lodErrors;
+        // Meshlets of the full-detail submeshes (see Mesh::buildMeshlets)
+        std::span<const Meshlet> meshlets;
     };
 
     class Mesh : public IDrawable {
@@ -41,9 +99,40 @@ namespace mgl {
         static const u8 NORMAL = 2;
         static const u8 TEXCOORD = 3;
         static const u8 COLOR = 4;
+        // Skinning attributes follow the instance MODEL_MATRIX_ATTRIBUTE locations
+        static const u8 BONE_INDICES = 9;
+        static const u8 BONE_WEIGHTS = 10;
+
+        /**
+         * @brief Describes how vertex attributes are laid out in GPU memory.
+         *
+         * Separate layouts upload every attribute into its own VBO.
+         * Interleaved layouts pack all attributes of a vertex contiguously in a
+         * single VBO, following 'order'. Attributes missing from the mesh are
+         * skipped. 'stride' may be larger than the packed vertex size to pad
+         * vertices (e.g. to 32 bytes); 0 means tightly packed.
+         * Quantized layouts store attributes in compact normalized formats
+         * (see VertexQuantizer), ~20 instead of 48 bytes per vertex.
+         */
+        struct VertexLayout {
+            bool interleaved = false;
+            std::vector<u8> order = { POSITION, NORMAL, TEXCOORD, COLOR };
+            GLsizei stride = 0;
+            bool quantized = false;
+        };
+
+        /**
+         * @brief Which CPU-side geometry a mesh keeps after it is uploaded.
+         * - Discard: nothing, the GPU copy is the only one
+         * - PositionsAndIndices: enough for picking/collision queries
+         * - Full: every attribute (default)
+         * Discarded data can be brought back with reloadGeometry() when the
+         * mesh was loaded through the mesh cache.
+         */
+        enum class Residency { Discard, PositionsAndIndices, Full };
 
         Mesh();
-        ~Mesh();
+        virtual ~Mesh();
         Mesh(const Mesh&) = delete;
         Mesh& operator=(const Mesh&) = delete;
         Mesh(Mesh&& other) noexcept;
@@ -56,10 +145,217 @@ namespace mgl {
         void generateTexcoords();
         void flipUVs();
 
+        /**
+         * @brief Optimization passes run on the imported geometry, in this
+         * order, before it is cached and uploaded (see MeshOptimizer).
+         * The ACMR before/after is logged when any pass runs.
+         */
+        void optimizeVertexCache();
+        void optimizeOverdraw();
+        void optimizeVertexFetch();
+
+        /**
+         * @brief Generates 'levels' simplified LODs when the mesh is imported,
+         * each keeping about 'reduction' of the previous LOD's triangles
+         * (see MeshSimplifier). LODs are extra index ranges over the same
+         * vertices and are stored in the mesh cache along with the mesh.
+         * Fewer LODs are kept if simplification stops making progress.
+         */
+        void generateLods(unsigned levels = 3, float reduction = 0.5f);
+
+        /**
+         * @brief Number of LODs available for drawing, including the
+         * full-detail LOD 0.
+         */
+        unsigned getLodCount() const;
+
+        /**
+         * @brief Object-space error of every simplified LOD, lodErrors[i]
+         * belonging to LOD i + 1. Feeds LodSelector.
+         */
+        std::span<const float> getLodErrors() const;
+
+        /**
+         * @brief LOD drawn by the following draw() calls, clamped to the
+         * available LODs. SceneObject sets it before drawing.
+         */
+        void setDrawLod(unsigned level);
+
+        /**
+         * @brief Splits every submesh into meshlets of at most maxVertices
+         * vertices and maxTriangles triangles when the mesh is imported (see
+         * Meshlets). They are stored in the mesh cache along with the mesh.
+         */
+        void buildMeshlets(unsigned maxVertices = 64, unsigned maxTriangles = 124);
+        std::span<const Meshlet> getMeshlets() const;
+
+        /**
+         * @brief Culls the meshlets outside the frustum or discarded by face
+         * culling. The next draw() of the full-detail LOD only draws the
+         * remaining ones. SceneObject calls it before drawing.
+         * @param modelViewProjection object to clip space transform
+         * @param cameraPosition camera position in object space
+         * @param cullFace GL_BACK, GL_FRONT or GL_NONE, as set with glCullFace
+         * @returns number of meshlets left to draw
+         */
+        size_t cullMeshlets(const math::mat4& modelViewProjection, const math::vec3& cameraPosition,
+                            GLenum cullFace = GL_BACK);
+
+        /**
+         * @brief Makes the next draw() issue one instanced draw per submesh,
+         * reading a mat4 per instance from instanceBuffer into the
+         * MODEL_MATRIX_ATTRIBUTE. Meshlet culling results are ignored for it.
+         * InstancedSceneObject calls it before drawing.
+         */
+        void setInstances(GLuint instanceBuffer, GLsizei instanceCount);
+
+        /**
+         * @brief Uploads one VertexSkin per vertex for GPU skinning, as the
+         * BONE_INDICES (uvec4) and BONE_WEIGHTS (normalized vec4) attributes.
+         * Must be called after every upload, and the mesh must use its own
+         * buffers (no arena).
+         */
+        void setSkin(std::span<const VertexSkin> skin);
+
+        /**
+         * @brief Enables/disables the binary mesh cache (enabled by default).
+         * When enabled, the first import of a file writes its processed buffers
+         * to the cache, and later imports of the same file content and Assimp
+         * flags are memory-mapped from it instead of going through Assimp.
+         * When disabled (and no optimization pass is enabled), createFromFile()
+         * writes Assimp's arrays directly into mapped GPU buffers and keeps no
+         * CPU-side copy of the geometry.
+         */
+        void useCache(bool enabled);
+
+        /**
+         * @brief Stores the geometry in the GeometryArena shared by every mesh
+         * with the same vertex format, instead of buffers of its own (disabled
+         * by default). Attributes are then interleaved following the layout
+         * order. Takes effect on the next upload.
+         */
+        void useArena(bool enabled);
+
+        /**
+         * @brief Reads .obj files with ObjLoader, a parallel native parser,
+         * instead of Assimp (enabled by default). Files it cannot parse, and
+         * Assimp flags it does not implement (e.g. generating the normals of a
+         * file without them), fall back to Assimp.
+         */
+        void useNativeObj(bool enabled);
+
+        /**
+         * @brief Sets the CPU-side residency policy. Applied right away if the
+         * mesh was already uploaded, otherwise once it is.
+         */
+        void setResidency(Residency residency);
+        Residency getResidency() const;
+
+        /**
+         * @brief Makes the whole geometry available again through view(), by
+         * mapping it from the mesh cache if the residency policy dropped it.
+         * @returns false if the mesh was not loaded through the mesh cache or
+         * its entry is gone
+         */
+        bool reloadGeometry();
+
+        /**
+         * @brief Drops geometry brought back by reloadGeometry(), following
+         * the residency policy again.
+         */
+        void releaseGeometry();
+
+        /**
+         * @brief Bytes of geometry currently held in CPU memory, including
+         * mesh cache entries mapped by the mesh.
+         */
+        size_t cpuBytes() const;
+
+        /**
+         * @brief Bytes of the GPU buffers holding the mesh geometry (its share
+         * of the arena when useArena() is on).
+         */
+        size_t gpuBytes() const;
+
+        /**
+         * @brief Identity of the mesh that createFromFile(filename) would build
+         * with the current settings: a hash of the file content, the Assimp
+         * flags, the processing options (optimizations, LODs, meshlets) and the
+         * GPU layout and residency. Meshes with equal keys are interchangeable.
+         * @returns 0 if the file cannot be read
+         */
+        u64 contentKey(const std::string &filename) const;
+
+        /**
+         * @brief Key of the mesh cache entry load(filename) reads or writes
+         * with the current settings (see MeshCache::makeKey).
+         * @returns 0 if the file cannot be read
+         */
+        u64 cacheKey(const std::string &filename) const;
+
+        /**
+         * @brief contentKey() of the file whose cacheKey() is given, so callers
+         * that also load() the file only hash it once.
+         * @returns 0 if cacheKey is 0
+         */
+        u64 contentKeyOf(u64 cacheKey) const;
+
+        /**
+         * @brief contentKey() of the mesh createFromData(data) would build.
+         */
+        u64 contentKey(const MeshData &data) const;
+
+        /**
+         * @brief Sets the GPU vertex layout. Must be called before the mesh is created.
+         */
+        void setVertexLayout(const VertexLayout& layout);
+
+        /**
+         * @brief Uploads all vertex attributes into a single interleaved VBO.
+         * @param order attribute ids (POSITION, NORMAL, ...) in the order they are packed
+         * @param stride bytes between consecutive vertices, 0 for tightly packed
+         */
+        void interleaveAttributes(std::vector<u8> order = { POSITION, NORMAL, TEXCOORD, COLOR },
+                                  GLsizei stride = 0);
+        const VertexLayout& getVertexLayout() const;
+
+        /**
+         * @brief Uploads attributes in quantized formats: unorm16 positions within
+         * the mesh bounds, snorm 10-10-10-2 normals, half float texcoords and
+         * unorm8 colors. Must be called before the mesh is created.
+         * Positions reach the shader in [0, 1]: the model matrix must be
+         * multiplied by getDequantization(), as SceneObject does.
+         */
+        void quantizeAttributes();
+
+        /**
+         * @brief Matrix mapping the uploaded positions back to model space.
+         * Identity unless the mesh is quantized.
+         */
+        const math::mat4& getDequantization() const;
+
         /**
          * @brief Loads a mesh from a file using Assimp library.
+         * Equivalent to load() followed by upload().
          */
-        void createFromFile(const std::string &filename);
+        void createFromFile(const std::string &filename, u64 cacheKey = 0);
+
+        /**
+         * @brief CPU half of createFromFile(): reads the mesh from the mesh cache
+         * or through the given Assimp importer, without any OpenGL call, so it
+         * may run on a worker thread. The geometry is kept until upload().
+         * A non-zero cacheKey is taken as cacheKey(filename), sparing a second
+         * pass over the file when the caller already hashed it.
+         * @returns false (after logging the error) if the file could not be imported
+         */
+        bool load(const std::string &filename, Assimp::Importer &importer, u64 cacheKey = 0);
+        bool load(const std::string &filename);
+
+        /**
+         * @brief GPU half of createFromFile(): uploads the geometry read by load().
+         * Must be called on the thread owning the OpenGL context.
+         */
+        void upload();
 
         /**
          * @brief Creates a mesh from raw vertex data.
@@ -72,30 +368,148 @@ namespace mgl {
         /**
          * @brief Creates a mesh from raw vertex data using MeshData structure.
          * All attributes are optional except positions and indices
+         * Equivalent to loadData() followed by upload().
          */
         void createFromData(MeshData data);
 
+        /**
+         * @brief CPU half of createFromData(): validates the data and builds
+         * the enabled LODs and meshlets, without any OpenGL call. The
+         * geometry is kept until upload().
+         * @throws std::invalid_argument / std::out_of_range on malformed data
+         */
+        void loadData(MeshData data);
+
         bool hasNormals();
         bool hasTexcoords();
 
+        /**
+         * @brief Model-space bounds of the whole mesh and of every submesh,
+         * computed when the mesh is uploaded.
+         */
+        const Bounds& getBounds() const;
+        std::span<const Bounds> getSubmeshBounds() const;
+
+        /**
+         * @brief View over the CPU-side geometry currently held by the mesh.
+         */
+        MeshView view() const;
+
     protected:
         void performDraw() override;
 
+        /**
+         * @brief VAO the mesh is drawn with - its own, or its arena's.
+         */
+        GLuint getVertexArray() const;
+
+        /**
+         * @brief Recomputes the mesh and submesh bounds from data, e.g. after
+         * its positions changed.
+         */
+        void updateBounds(const MeshView &data);
+
+        /**
+         * @brief Creates the vertex buffers, with the mesh VAO bound: separate
+         * or interleaved, depending on _layout. Meshes storing their vertices
+         * elsewhere override it to skip them - the index buffer is still created.
+         */
+        virtual void createVertexBuffers(const MeshView &data, const VertexQuantizer *quantizer);
+
     private:
+        /**
+         * @brief Hash of the settings shaping the processed geometry (part of the mesh cache key).
+         */
+        u64 processingOptions() const;
+
+        /**
+         * @brief Hash of the settings shaping the GPU copy and the CPU residency.
+         */
+        u64 uploadOptions() const;
+
         ui32 VaoId = 0;
         GLuint BufferIds[6] = {0, 0, 0, 0, 0, 0};
         unsigned int AssimpFlags = 0;
+        ui32 _optimizations = 0;
+        unsigned _lodLevels = 0;
+        float _lodReduction = 0.5f;
+        unsigned _drawLod = 0;
+        unsigned _meshletVertices = 0;
+        unsigned _meshletTriangles = 0;
         bool _normalsLoaded = false;
         bool _texcoordsLoaded = false;
         bool _colorsLoaded = false;
+        bool _cacheEnabled = true;
+        bool _nativeObj = true;
+        u64 _cacheKey = 0;
+        Residency _residency = Residency::Full;
+        VertexLayout _layout;
+        math::mat4 _dequantization;
+        Bounds _bounds;
+        std::vector<Bounds> _submeshBounds;
+
+        std::vector<Submesh> _meshes;
+        std::vector<Submesh> _lodMeshes;
+        std::vector<float> _lodErrors;
+        std::vector<Meshlet> _meshlets;
 
-        struct Submesh {
-            unsigned int n_indices = 0;
-            unsigned int baseIndex = 0;
-            unsigned int baseVertex = 0;
+        // One draw per submesh, followed by those of every LOD. Submeshes whose indices fit 16 bits are stored
+        // as GL_UNSIGNED_SHORT in the index buffer, the rest as GL_UNSIGNED_INT
+        struct DrawRange {
+            GLenum type;
+            size_t offset;
+            GLsizei count;
+            GLint baseVertex;
         };
+        std::vector<DrawRange> _draws;
+        std::vector<DrawRange> _meshletDraws;
 
-        std::vector<Submesh> _meshes;
+        // GL 4.3+: _draws as indirect commands, grouped per LOD and index type
+        // so each group is a single glMultiDrawElementsIndirect call.
+        // _indirectGroups[level * 2 + t], t = 0 for 16-bit and 1 for 32-bit indices
+        struct DrawElementsIndirectCommand {
+            GLuint count;
+            GLuint instanceCount;
+            GLuint firstIndex;
+            GLint baseVertex;
+            GLuint baseInstance;
+        };
+        struct IndirectGroup {
+            size_t offset;
+            GLsizei count;
+        };
+        GLuint _indirectBuffer = 0;
+        std::vector<IndirectGroup> _indirectGroups;
+
+        // Range of the shared arena holding the geometry, when useArena() is
+        // on. _draws address the arena buffers as of _arenaGeneration
+        bool _arenaEnabled = false;
+        std::shared_ptr<GeometryArena> _arena;
+        GeometryArena::Handle _arenaRange = GeometryArena::INVALID;
+        GeometryArena::Range _arenaPlacement{};
+        u64 _arenaGeneration = 0;
+
+        // Meshlet ranges left by cullMeshlets() for the next draw, one
+        // glMultiDrawElementsBaseVertex call per index type
+        struct MultiDraw {
+            std::vector<GLsizei> counts;
+            std::vector<const void *> offsets;
+            std::vector<GLint> baseVertices;
+        };
+        MultiDraw _visible[2];
+        bool _culled = false;
+
+        // Instances of the next draw, set by setInstances()
+        GLuint _instanceBuffer = 0;
+        GLsizei _instanceCount = 0;
+
+        // Bone indices and weights set by setSkin()
+        GLuint _skinBuffer = 0;
+
+        // Mesh cache entry backing the CPU-side geometry, if any - set by
+        // load() on a cache hit and by reloadGeometry()
+        file::MappedFile _mapping;
+        MeshView _mappedView;
 
         std::vector<unsigned int> _indices;
         std::vector<math::vec3> _positions;
@@ -104,27 +518,111 @@ namespace mgl {
         std::vector<math::vec4> _colors;
 
         /**
-         * @brief Processes the entire aiScene from Assimp and loads all meshes.
-         * Used internally by createFromFile().
+         * @brief Reads filename with the importer, logging any error.
+         * @returns the imported scene, or nullptr on failure
+         */
+        const aiScene *importScene(const std::string &filename, Assimp::Importer &importer);
+
+        /**
+         * @brief Whether filename is read by ObjLoader with the current flags.
+         */
+        bool usesNativeObj(const std::string &filename) const;
+
+        /**
+         * @brief Reads filename with ObjLoader into the CPU-side geometry.
+         * @returns false if Assimp must read it instead
+         */
+        bool importObj(const std::string &filename);
+
+        /**
+         * @brief Builds the submesh table and attribute flags of an aiScene.
+         * Used internally by processMeshes() and streamScene().
          */
         void processScene(const aiScene *scene);
 
         /**
-         * @brief Processes an individual aiMesh from Assimp and loads its data.
-         * Used internally by processScene().
+         * @brief Copies all meshes of an aiScene into the CPU-side arrays,
+         * sized once from the scene totals. Used internally by load().
+         */
+        void processMeshes(const aiScene *scene);
+
+        /**
+         * @brief Runs the enabled MeshOptimizer passes on every submesh of the
+         * CPU-side arrays. Vertex fetch is skipped when submeshes share
+         * vertices. Used internally by load().
+         */
+        void optimizeGeometry(const std::string &filename);
+
+        /**
+         * @brief Appends the simplified LODs of every submesh to the CPU-side
+         * index array. Used internally by load() and createFromData().
+         */
+        void buildLods(const std::string &name);
+
+        /**
+         * @brief Splits every submesh into meshlets, reordering its indices.
+         * Used internally by load() and createFromData().
+         */
+        void clusterGeometry(const std::string &name);
+
+        /**
+         * @brief Vertices a submesh reaches from its baseVertex: its highest
+         * index plus one. Submeshes may share or interleave vertex ranges.
          */
-        void processMesh(const aiMesh *mesh);
+        size_t submeshVertexCount(const Submesh &submesh) const;
+
+        /**
+         * @brief Draws every submesh of the given LOD once per instance set
+         * with setInstances(). Used internally by performDraw().
+         */
+        void drawInstances(size_t level);
+
+        /**
+         * @brief Uploads _draws as indirect draw commands when the context
+         * supports glMultiDrawElementsIndirect (GL 4.3). Used internally after
+         * the draws are planned.
+         */
+        void createIndirectBuffer();
+
+        /**
+         * @brief Allocates the geometry's range in the arena of its vertex
+         * format and writes its vertices. Used internally by createBufferObjects().
+         */
+        void createArenaRange(const MeshView &data, const VertexQuantizer *quantizer, size_t indexBytes);
+
+        /**
+         * @brief Rebases the draws if the arena moved the mesh's range.
+         */
+        void syncArena();
+
+        /**
+         * @brief Copies all meshes of an aiScene straight into mapped GPU
+         * buffers, keeping no CPU-side copy. Used internally by createFromFile()
+         * when the mesh cache is disabled.
+         */
+        void streamScene(const aiScene *scene);
 
         /**
          * @brief Creates OpenGL buffer objects and uploads mesh data to GPU.
-         * Currently it builds all vertex data using a single VAO, and separate VBOs.
-         * It uses a separate approach (data is not set contiguous in a single buffer).
-         * 
-         * TODO - this should be updated to be optimized later on to be set interleaved (continuous 
-         * in a single buffer with proper offsets).
+         * All vertex data is bound to a single VAO, either as separate VBOs
+         * (one per attribute) or as one interleaved VBO, depending on _layout.
          */
-        void createBufferObjects();
+        void createBufferObjects(const MeshView& data);
+        void createSeparateBuffers(const MeshView& data, const VertexQuantizer* quantizer);
+        void createInterleavedBuffer(const MeshView& data, const VertexQuantizer* quantizer);
         void destroyBufferObjects();
+
+        /**
+         * @brief Chooses the index type of every submesh from its largest
+         * (baseVertex-relative) index and lays them out in the index buffer.
+         * @returns the index buffer size in bytes
+         */
+        size_t planDraws(std::span<const Submesh> submeshes, const std::vector<ui32>& maxIndex);
+
+        /**
+         * @brief Frees the CPU-side geometry not kept by the residency policy.
+         */
+        void applyResidency();
     };
 
 }  // namespace mgl
@@ -0,0 +1,57 @@
+#ifndef MGL_MESH_CACHE_HPP
+#define MGL_MESH_CACHE_HPP
+
+#include "types.hpp"
+#include <mgl/models/meshes/mglMesh.hpp>
+#include <utils/file.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+
+namespace mgl {
+
+	/**
+	 * Versioned binary cache of processed meshes.
+	 *
+	 * An entry holds the final vertex/index buffers and the submesh table of
+	 * an imported model, exactly as they are uploaded to the GPU, along with
+	 * its generated LOD index ranges, their errors and its meshlets. Entries are
+	 * keyed by a hash of the source file content and the import flags, so
+	 * editing a model or changing its import options produces a new entry.
+	 *
+	 * File layout (host endianness): a fixed header with a section table,
+	 * followed by the sections, each 16-byte aligned so they can be read
+	 * in place from a memory mapping.
+	 */
+	class MeshCache {
+	public:
+		static constexpr ui32 VERSION = 3;
+
+		/// A memory-mapped cache entry - 'view' points into 'file'
+		struct Entry {
+			file::MappedFile file;
+			MeshView view;
+		};
+
+		/// Directory where entries are stored (default: <exe_dir>/cache/meshes)
+		static void setDirectory(const std::filesystem::path& directory);
+		static std::filesystem::path getDirectory();
+
+		/// Key of a source file's content imported with the given Assimp flags
+		/// and processing options (a hash of MeshOptimizer passes, LOD and meshlet settings)
+		static u64 makeKey(std::span<const std::byte> source, ui32 flags, u64 options = 0);
+
+		/// Maps the entry for key, if present and valid
+		static std::optional<Entry> open(u64 key);
+
+		/// Writes an entry for key. Returns false if it could not be written
+		static bool store(u64 key, const MeshView& data);
+
+		static std::filesystem::path entryPath(u64 key);
+	};
+
+}
+
+#endif // !MGL_MESH_CACHE_HPP
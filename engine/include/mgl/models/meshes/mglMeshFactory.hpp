@@ -0,0 +1,58 @@
+#ifndef MGL_MESH_FACTORY_HPP
+#define MGL_MESH_FACTORY_HPP
+
+#include "types.hpp"
+#include <mgl/models/meshes/mglMesh.hpp>
+
+#include <cstddef>
+
+namespace mgl {
+
+	/**
+	 * Procedural primitives generated in memory, so common shapes need
+	 * neither file I/O nor Assimp: pass the result to MeshManager::create or
+	 * Mesh::createFromData.
+	 *
+	 * Every shape is centered on the origin, with positions, unit normals,
+	 * texture coordinates and counter-clockwise front faces. Results are
+	 * cached by shape and parameters - asking twice for the same primitive
+	 * builds it once - and stay valid for the lifetime of the program.
+	 * Invalid parameters throw std::invalid_argument.
+	 */
+	class MeshFactory {
+	public:
+		/// Axis-aligned cube with an edge of 'size' and one texture per face
+		static const MeshData& cube(f32 size = 2.0f);
+
+		/// Sphere of latitude rings and longitude segments, textured by an
+		/// equirectangular (longitude, latitude) mapping
+		static const MeshData& uvSphere(f32 radius = 1.0f, ui32 segments = 32, ui32 rings = 16);
+
+		/// Subdivided icosahedron: evenly spaced triangles, 20 * 4^subdivisions
+		/// of them. Texture coordinates are a spherical projection, with a seam
+		static const MeshData& icoSphere(f32 radius = 1.0f, ui32 subdivisions = 3);
+
+		/// Plane on XZ facing +Y, split into a grid of xSegments by zSegments quads
+		static const MeshData& plane(f32 width = 2.0f, f32 depth = 2.0f, ui32 xSegments = 1, ui32 zSegments = 1);
+
+		/// Cylinder along Y, optionally closed by flat caps
+		static const MeshData& cylinder(f32 radius = 1.0f, f32 height = 2.0f, ui32 segments = 32, bool capped = true);
+
+		/// Torus around Y: a tube of 'tubeRadius' swept along a circle of 'radius'
+		static const MeshData& torus(f32 radius = 1.0f, f32 tubeRadius = 0.25f,
+		                             ui32 segments = 48, ui32 tubeSegments = 16);
+
+		/**
+		 * Single triangle covering clip space [-1, 1] (positions are already in
+		 * clip space, texture coordinates span [0, 1] over the screen). Cheaper
+		 * than a quad for post-processing passes - no diagonal seam to shade twice.
+		 */
+		static const MeshData& fullscreenTriangle();
+
+		/// Number of primitives built so far
+		static size_t cachedCount();
+	};
+
+}
+
+#endif // !MGL_MESH_FACTORY_HPP
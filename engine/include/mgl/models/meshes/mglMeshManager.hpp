@@ -3,18 +3,72 @@
 
 #include <mgl/models/meshes/mglMesh.hpp>
 #include <mgl/mglManager.hpp>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace mgl {
 
 	class MeshManager;
 
+	struct MeshImport {
+		std::string name;
+		std::string filePath;
+	};
+
+	/// <summary>
+	/// Owns the meshes of a scene. Meshes are deduplicated by content (see
+	/// Mesh::contentKey): importing a file, or creating geometry, identical to
+	/// an already managed mesh only adds a name for that mesh, which is built
+	/// and uploaded once.
+	/// </summary>
 	class MeshManager : public Manager<Mesh> {
 	public:
 		MeshManager();
 		~MeshManager();
 		void import(const std::string& name, const std::string& filePath);
+
+		/// <summary>
+		/// Creates a mesh from raw vertex data (see Mesh::createFromData).
+		/// </summary>
+		void create(const std::string& name, MeshData data);
+
+		/// <summary>
+		/// Imports several files at once. Files are parsed in parallel (one Assimp
+		/// importer per worker thread), then uploaded to the GPU serially on the
+		/// calling thread, which must own the OpenGL context.
+		/// </summary>
+		void importBatch(const std::vector<MeshImport>& imports);
+
 		void meshConfigCallback(SetManagedItemCallback callback);
+
+		/// <summary>
+		/// Total bytes of geometry the managed meshes keep in CPU memory, see Mesh::Residency.
+		/// </summary>
+		size_t cpuGeometryBytes();
+
+		/// <summary>
+		/// Distinct meshes among the managed names.
+		/// </summary>
+		size_t uniqueMeshCount();
+
+		/// <summary>
+		/// GPU and CPU geometry bytes that names sharing a mesh did not duplicate.
+		/// </summary>
+		size_t bytesSaved();
+
+	private:
+		std::unordered_map<u64, std::weak_ptr<Mesh>> byContent;
+
+		std::shared_ptr<Mesh> newMesh();
+
+		/// Mesh already managed with this content key, if any
+		std::shared_ptr<Mesh> findContent(u64 key);
+
+		/// Adds name as another name of mesh
+		void addAlias(const std::string& name, const std::shared_ptr<Mesh>& mesh);
+		void addUnique(const std::string& name, u64 key, const std::shared_ptr<Mesh>& mesh);
 	};
 }
 
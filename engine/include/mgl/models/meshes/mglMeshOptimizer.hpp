@@ -0,0 +1,73 @@
+#ifndef MGL_MESH_OPTIMIZER_HPP
+#define MGL_MESH_OPTIMIZER_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * Reorders triangle lists for faster rendering. All functions work on a
+	 * single indexed triangle list whose indices are in [0, vertexCount).
+	 *
+	 * The passes are meant to run in this order:
+	 * 1. optimizeVertexCache - reorders triangles for post-transform cache hits
+	 * 2. optimizeOverdraw    - reorders clusters of triangles so outward facing
+	 *                          ones are drawn first, within an ACMR budget
+	 * 3. optimizeVertexFetch - reorders vertices to match the index order
+	 */
+	class MeshOptimizer {
+	public:
+		/// Toggleable passes, see Mesh::optimizeVertexCache() and friends
+		enum Pass : ui32 {
+			VERTEX_CACHE = 1 << 0,
+			OVERDRAW     = 1 << 1,
+			VERTEX_FETCH = 1 << 2,
+		};
+
+		/// FIFO cache size used to measure ACMR - typical of current GPUs
+		static constexpr unsigned CACHE_SIZE = 16;
+
+		/**
+		 * Average cache miss ratio: transformed vertices per triangle with a
+		 * simulated FIFO post-transform cache. 3 is the worst, ~0.5 the best.
+		 */
+		static float acmr(std::span<const ui32> indices, size_t vertexCount,
+		                  unsigned cacheSize = CACHE_SIZE);
+
+		/// Reorders triangles with Tom Forsyth's linear-speed algorithm
+		static void optimizeVertexCache(std::span<ui32> indices, size_t vertexCount);
+
+		/**
+		 * Splits the triangle order into clusters at cache restarts and sorts
+		 * them by how much they face away from the mesh center, so occluders
+		 * are drawn first. Clusters are only split further while their ACMR
+		 * stays below threshold times the original one.
+		 */
+		static void optimizeOverdraw(std::span<ui32> indices, std::span<const math::vec3> positions,
+		                             float threshold = 1.05f);
+
+		/**
+		 * Renumbers vertices in the order the indices first reference them,
+		 * rewriting the indices. Unreferenced vertices are moved to the end.
+		 * @returns remap table (old vertex -> new vertex) for remapVertices()
+		 */
+		static std::vector<ui32> optimizeVertexFetch(std::span<ui32> indices, size_t vertexCount);
+
+		/// Moves every vertex to its position in the remap table
+		template <typename T>
+		static void remapVertices(std::span<T> vertices, std::span<const ui32> remap) {
+			std::vector<T> source(vertices.begin(), vertices.end());
+			for (size_t i = 0; i < source.size(); i++) {
+				vertices[remap[i]] = source[i];
+			}
+		}
+	};
+
+}
+
+#endif // !MGL_MESH_OPTIMIZER_HPP
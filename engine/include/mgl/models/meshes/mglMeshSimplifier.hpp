@@ -0,0 +1,43 @@
+#ifndef MGL_MESH_SIMPLIFIER_HPP
+#define MGL_MESH_SIMPLIFIER_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * Mesh simplification with quadric error metrics (Garland & Heckbert).
+	 *
+	 * Edges are collapsed onto one of their vertices, so the result is a new
+	 * index list over the same vertices and LODs can share one vertex buffer.
+	 * Vertices on open borders and on attribute seams (several vertices at the
+	 * same position, e.g. with different UVs) never move, which keeps
+	 * silhouettes and texture mapping intact. Normals and texcoords, when
+	 * given, add a penalty to collapses that would distort them.
+	 */
+	class MeshSimplifier {
+	public:
+		/**
+		 * Simplifies an indexed triangle list down to (about) targetIndexCount
+		 * indices. Fewer triangles are removed if every remaining collapse is
+		 * locked or would flip a triangle.
+		 * @param normals, texcoords optional, empty or one per position
+		 * @param error if not null, receives the largest collapse error as an
+		 * object-space distance
+		 */
+		static std::vector<ui32> simplify(std::span<const ui32> indices,
+		                                  std::span<const math::vec3> positions,
+		                                  std::span<const math::vec3> normals,
+		                                  std::span<const math::vec2> texcoords,
+		                                  size_t targetIndexCount,
+		                                  float* error = nullptr);
+	};
+
+}
+
+#endif // !MGL_MESH_SIMPLIFIER_HPP
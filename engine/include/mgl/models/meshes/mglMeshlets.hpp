@@ -0,0 +1,56 @@
+#ifndef MGL_MESHLETS_HPP
+#define MGL_MESHLETS_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+#include <mgl/models/meshes/mglMesh.hpp>
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * Splits submeshes into meshlets - small clusters of neighbouring
+	 * triangles - and culls them against the camera.
+	 *
+	 * Clusters are grown greedily over shared vertices, preferring triangles
+	 * that add the fewest new vertices, so they stay compact and their bounds
+	 * tight. The indices are reordered so every cluster is a contiguous range
+	 * that can be drawn on its own from the regular index buffer.
+	 */
+	class Meshlets {
+	public:
+		static constexpr size_t MAX_VERTICES = 64;
+		static constexpr size_t MAX_TRIANGLES = 124;
+
+		/**
+		 * Reorders 'indices' (one submesh, relative to its vertices) into
+		 * clusters of at most maxVertices unique vertices and maxTriangles
+		 * triangles. Returned meshlets have baseIndex relative to 'indices'
+		 * and submesh 0.
+		 */
+		static std::vector<Meshlet> build(std::span<ui32> indices,
+		                                  std::span<const math::vec3> positions,
+		                                  size_t maxVertices = MAX_VERTICES,
+		                                  size_t maxTriangles = MAX_TRIANGLES);
+
+		/// Normalized frustum planes (ax + by + cz + d >= 0 inside) of a
+		/// clip-space transform, in the space that transform starts from
+		static std::array<math::vec4, 6> frustumPlanes(const math::mat4& modelViewProjection);
+
+		/**
+		 * False if the meshlet is outside the frustum, or if all of its
+		 * triangles would be discarded by face culling. Planes and camera
+		 * position must be in the meshlet's (object) space.
+		 * @param cullFace GL_BACK, GL_FRONT or GL_NONE, as set with glCullFace
+		 */
+		static bool isVisible(const Meshlet& meshlet, const std::array<math::vec4, 6>& planes,
+		                      const math::vec3& cameraPosition, GLenum cullFace = GL_BACK);
+	};
+
+}
+
+#endif // !MGL_MESHLETS_HPP
@@ -0,0 +1,74 @@
+#ifndef MGL_OBJ_LOADER_HPP
+#define MGL_OBJ_LOADER_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+#include <mgl/models/meshes/mglMesh.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * Wavefront OBJ/MTL loader, used by Mesh for .obj files instead of Assimp.
+	 *
+	 * The file is read in place through file::vfs() and split into
+	 * line-aligned chunks parsed in parallel (util::ThreadPool): a first
+	 * pass counts the v/vt/vn lines of every chunk, so the second one can
+	 * write them straight into place and resolve relative (negative) indices.
+	 * Face corners are then welded into vertices with a hash table on their
+	 * (v, vt, vn) indices, so the output is an indexed MeshData. Polygons are triangulated as fans.
+	 *
+	 * A submesh starts at every object, group or material change, like the
+	 * Assimp importer does. Vertex colors ("v x y z r g b") are supported;
+	 * lines and points are skipped.
+	 */
+	class ObjLoader {
+	public:
+		struct Material {
+			std::string name;
+			math::vec3 ambient{ 0.0f };
+			math::vec3 diffuse{ 1.0f };
+			math::vec3 specular{ 0.0f };
+			float shininess = 0.0f;
+			float opacity = 1.0f;
+			std::string diffuseMap;
+		};
+
+		struct Options {
+			bool flipUVs = false;
+			/// Target bytes per chunk - smaller files are parsed by fewer threads
+			size_t chunkSize = 1 << 20;
+		};
+
+		struct Model {
+			MeshData mesh;
+			std::vector<Material> materials;
+			/// Material of every submesh, -1 if none
+			std::vector<i32> submeshMaterials;
+		};
+
+		/// Loads an OBJ resource and the MTL libraries it references, logging any error
+		static std::optional<Model> load(const std::filesystem::path& path, const Options& options);
+		static std::optional<Model> load(const std::filesystem::path& path);
+
+		/**
+		 * Parses OBJ text. Material libraries are read from the resource
+		 * directory 'directory' (none if empty). Returns nullopt on malformed input.
+		 */
+		static std::optional<Model> parse(std::string_view text, const Options& options,
+		                                  const std::filesystem::path& directory = {});
+		static std::optional<Model> parse(std::string_view text);
+
+		/// Parses MTL text
+		static std::vector<Material> parseMaterials(std::string_view text);
+	};
+
+}
+
+#endif // !MGL_OBJ_LOADER_HPP
@@ -0,0 +1,56 @@
+#ifndef MGL_VERTEX_QUANTIZER_HPP
+#define MGL_VERTEX_QUANTIZER_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+
+#include <span>
+
+namespace mgl {
+
+	/**
+	 * Encodes vertex attributes into compact GPU formats that are expanded
+	 * back to floats by the vertex fetch (normalized glVertexAttribPointer):
+	 *
+	 * - positions: 3 x unorm16 inside the mesh bounds (+2 bytes padding)
+	 * - normals:   snorm 10-10-10-2 (GL_INT_2_10_10_10_REV)
+	 * - texcoords: 2 x half float
+	 * - colors:    4 x unorm8
+	 *
+	 * Positions come out of the GPU in [0, 1], so the model matrix must be
+	 * multiplied by dequantization() to restore them. Normals are stored
+	 * pre-scaled by the same bounds, so shaders that derive the normal matrix
+	 * from that combined model matrix still get the original directions.
+	 */
+	class VertexQuantizer {
+	public:
+		/// Bytes per vertex of every encoded attribute
+		static constexpr size_t POSITION_SIZE = 4 * sizeof(u16);
+		static constexpr size_t NORMAL_SIZE = sizeof(ui32);
+		static constexpr size_t TEXCOORD_SIZE = 2 * sizeof(u16);
+		static constexpr size_t COLOR_SIZE = 4 * sizeof(u8);
+
+		VertexQuantizer(const math::vec3& min, const math::vec3& max);
+
+		/// Quantizer over the bounds of the given positions
+		static VertexQuantizer fromPositions(std::span<const math::vec3> positions);
+
+		/// Maps quantized [0, 1] positions back to the original space
+		const math::mat4& dequantization() const { return _dequantization; }
+
+		void position(const math::vec3& p, u16 out[4]) const;
+		ui32 normal(const math::vec3& n) const;
+
+		static u16 toHalf(float value);
+		static float fromHalf(u16 value);
+		static void color(const math::vec4& c, u8 out[4]);
+
+	private:
+		math::vec3 _origin;
+		math::vec3 _extent;
+		math::mat4 _dequantization;
+	};
+
+}
+
+#endif // !MGL_VERTEX_QUANTIZER_HPP
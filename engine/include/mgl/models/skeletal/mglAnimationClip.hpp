@@ -0,0 +1,102 @@
+#ifndef MGL_ANIMATION_CLIP_HPP
+#define MGL_ANIMATION_CLIP_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+#include <mgl/models/skeletal/mglSkeleton.hpp>
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * Keyframed animation of a skeleton's bones and morph target weights.
+	 * Every animated bone has its own translation, rotation and scale keys;
+	 * sampling interpolates them linearly (rotations with slerp) and bones
+	 * without a channel keep their bind pose. Morph channels animate the
+	 * weight of one morph target each. Times are in seconds.
+	 */
+	class AnimationClip {
+	public:
+		struct VectorKey {
+			float time;
+			math::vec3 value;
+		};
+
+		struct RotationKey {
+			float time;
+			math::quat value;
+		};
+
+		struct WeightKey {
+			float time;
+			float value;
+		};
+
+		struct Channel {
+			i32 bone = -1;
+			std::vector<VectorKey> translations;
+			std::vector<RotationKey> rotations;
+			std::vector<VectorKey> scales;
+		};
+
+		struct MorphChannel {
+			i32 target = -1;
+			std::vector<WeightKey> weights;
+		};
+
+		std::string name;
+		float duration = 0.0f;
+		std::vector<Channel> channels;
+		std::vector<MorphChannel> morphChannels;
+
+		/**
+		 * Overwrites the local transforms of the animated bones with their
+		 * pose at 'time', clamped to the keys of each channel.
+		 */
+		void sample(float time, std::span<math::mat4> local) const;
+
+		/// Overwrites the weights of the animated morph targets with their value at 'time'
+		void sampleWeights(float time, std::span<float> weights) const;
+	};
+
+	/**
+	 * Plays an AnimationClip on a skeleton and keeps its skinning palette
+	 * (see Skeleton::computePalette) and morph target weights up to date.
+	 * Morph-only meshes use an empty skeleton.
+	 */
+	class Animator {
+	public:
+		explicit Animator(const Skeleton& skeleton);
+
+		void play(const AnimationClip* clip, bool loop = true);
+		void setSpeed(float speed);
+		float getTime() const;
+
+		/// Advances the clip by 'seconds' and recomputes the palette
+		void update(float seconds);
+
+		std::span<const math::mat4> getPalette() const;
+
+		/// Sets the number of morph target weights and their rest values (0 by default)
+		void setMorphWeights(std::span<const float> rest);
+		std::span<const float> getMorphWeights() const;
+
+	private:
+		const Skeleton* skeleton;
+		const AnimationClip* clip = nullptr;
+		float time = 0.0f;
+		float speed = 1.0f;
+		bool loop = true;
+		std::vector<math::mat4> local;
+		std::vector<math::mat4> global;
+		std::vector<math::mat4> palette;
+		std::vector<float> restWeights;
+		std::vector<float> weights;
+	};
+
+}
+
+#endif // !MGL_ANIMATION_CLIP_HPP
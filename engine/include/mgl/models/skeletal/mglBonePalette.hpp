@@ -0,0 +1,63 @@
+#ifndef MGL_BONE_PALETTE_HPP
+#define MGL_BONE_PALETTE_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+#include <glad/glad.h>
+#include <mgl/shaders/ShaderProgram.hpp>
+
+#include <span>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * Skinning palettes of many skinned objects, shared by all their draws
+	 * through one texture buffer (GL_RGBA32F, 4 texels per bone matrix).
+	 *
+	 * Every object reserves a range of bones and writes its palette there;
+	 * upload() then streams all of them in a single buffer update per frame.
+	 * Skinning vertex shaders read their bones at BONE_OFFSET + index from
+	 * the BONE_PALETTE samplerBuffer:
+	 *
+	 *   mat4 bone(uint i) {
+	 *       int t = (BoneOffset + int(i)) * 4;
+	 *       return mat4(texelFetch(BonePalette, t), texelFetch(BonePalette, t + 1),
+	 *                   texelFetch(BonePalette, t + 2), texelFetch(BonePalette, t + 3));
+	 *   }
+	 */
+	class BonePalette {
+	public:
+		BonePalette();
+		~BonePalette();
+		BonePalette(const BonePalette&) = delete;
+		BonePalette& operator=(const BonePalette&) = delete;
+
+		/// Reserves boneCount bones, returning the offset of the first one
+		ui32 allocate(size_t boneCount);
+		void clear();
+		size_t size() const;
+
+		/// Copies a palette to the bones reserved at offset. Uploaded by upload()
+		void write(ui32 offset, std::span<const math::mat4> palette);
+
+		/// Uploads every palette - once per frame, before the skinned draws
+		void upload();
+
+		/// Binds the palette texture to a texture unit
+		void bind(GLuint unit) const;
+
+		/// Binds the palette to a texture unit and sets the BONE_PALETTE and
+		/// BONE_OFFSET uniforms of shaders, when they use them
+		void setUniforms(ShaderProgram& shaders, GLuint unit, ui32 offset) const;
+
+	private:
+		GLuint buffer = 0;
+		GLuint texture = 0;
+		size_t capacity = 0;
+		std::vector<math::mat4> matrices;
+	};
+
+}
+
+#endif // !MGL_BONE_PALETTE_HPP
@@ -0,0 +1,58 @@
+#ifndef MGL_MORPH_TARGET_BUFFER_HPP
+#define MGL_MORPH_TARGET_BUFFER_HPP
+
+#include "types.hpp"
+#include <glad/glad.h>
+#include <mgl/models/skeletal/mglMorphTargets.hpp>
+#include <mgl/shaders/ShaderProgram.hpp>
+
+#include <span>
+
+namespace mgl {
+
+	/**
+	 * Morph targets of a mesh on the GPU, blended in the vertex shader.
+	 *
+	 * The sparse deltas are regrouped by vertex: MORPH_RANGES holds the first
+	 * delta and delta count of every vertex (RG32UI), MORPH_DELTAS 2 texels
+	 * per delta (RGBA32F): the position delta with its target in w, then the
+	 * normal delta. Vertices no target moves cost a single fetch:
+	 *
+	 *   uvec2 range = texelFetch(MorphRanges, gl_VertexID).xy;
+	 *   for (uint d = range.x; d < range.x + range.y; d++) {
+	 *       vec4 delta = texelFetch(MorphDeltas, int(d) * 2);
+	 *       float weight = MorphWeights[int(delta.w)];
+	 *       position += weight * delta.xyz;
+	 *       normal += weight * texelFetch(MorphDeltas, int(d) * 2 + 1).xyz;
+	 *   }
+	 *
+	 * gl_VertexID includes the submesh base vertex, so the mesh must own its
+	 * vertex buffer (not share a GeometryArena).
+	 */
+	class MorphTargetBuffer {
+	public:
+		MorphTargetBuffer();
+		~MorphTargetBuffer();
+		MorphTargetBuffer(const MorphTargetBuffer&) = delete;
+		MorphTargetBuffer& operator=(const MorphTargetBuffer&) = delete;
+
+		/// Uploads the deltas of every target
+		void create(const MorphTargets& targets);
+		size_t size() const;
+
+		/**
+		 * Binds the ranges to texture unit 'unit' and the deltas to unit + 1,
+		 * and sets the MORPH_* uniforms of shaders, when they use them.
+		 * @param weights one per target
+		 */
+		void setUniforms(ShaderProgram& shaders, GLuint unit, std::span<const float> weights) const;
+
+	private:
+		GLuint buffers[2] = {};
+		GLuint textures[2] = {};
+		size_t targetCount = 0;
+	};
+
+}
+
+#endif // !MGL_MORPH_TARGET_BUFFER_HPP
@@ -0,0 +1,93 @@
+#ifndef MGL_MORPH_TARGETS_HPP
+#define MGL_MORPH_TARGETS_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * Morph target (blend shape) as sparse deltas: only the vertices it moves,
+	 * with their position and, optionally, normal offsets from the base mesh.
+	 */
+	struct MorphTarget {
+		std::string name;
+		std::vector<ui32> vertices;
+		std::vector<math::vec3> positions;
+		std::vector<math::vec3> normals; // empty, or one per vertex
+
+		/**
+		 * Builds the sparse deltas of a dense target (e.g. an imported
+		 * aiAnimMesh), keeping the vertices that move more than epsilon.
+		 * @param baseNormals, targetNormals both empty, or one per position
+		 */
+		static MorphTarget fromDense(std::string name,
+		                             std::span<const math::vec3> basePositions,
+		                             std::span<const math::vec3> targetPositions,
+		                             std::span<const math::vec3> baseNormals = {},
+		                             std::span<const math::vec3> targetNormals = {},
+		                             float epsilon = 1e-6f);
+	};
+
+	/**
+	 * Morph targets of a mesh, blended on the CPU by apply().
+	 *
+	 * Deltas of all targets are packed in one array, 4 floats per changed
+	 * vertex, so blending is one SIMD multiply-add per delta into a dense
+	 * accumulator. Memory grows with the vertices each target changes, not
+	 * with the mesh size. The result is typically written into a DynamicMesh;
+	 * MorphTargetBuffer blends the same deltas in a vertex shader instead.
+	 */
+	class MorphTargets {
+	public:
+		/// Maximum targets of a mesh - the size of the GPU weight array
+		static constexpr size_t MAX_TARGETS = 64;
+
+		explicit MorphTargets(size_t vertexCount = 0);
+
+		/// Adds a target, whose vertices must be below the vertex count. Returns its index
+		i32 addTarget(const MorphTarget& target);
+		i32 find(const std::string& name) const;
+		const std::string& getName(size_t target) const;
+		size_t size() const;
+		size_t getVertexCount() const;
+		bool hasNormals() const;
+
+		/// Changed vertices of a target and their deltas (4 floats each, w unused)
+		std::span<const ui32> getVertices(size_t target) const;
+		std::span<const float> getPositionDeltas(size_t target) const;
+		std::span<const float> getNormalDeltas(size_t target) const;
+
+		/// Bytes used by the deltas of every target
+		size_t getMemoryUsage() const;
+
+		/**
+		 * Blends the targets with the given weights (one per target, zero
+		 * weights are skipped) over the base mesh. Normals are renormalized.
+		 * @param baseNormals, outNormals both empty, or one per vertex
+		 */
+		void apply(std::span<const float> weights,
+		           std::span<const math::vec3> basePositions, std::span<const math::vec3> baseNormals,
+		           std::span<math::vec3> outPositions, std::span<math::vec3> outNormals) const;
+
+	private:
+		struct Target {
+			std::string name;
+			size_t first;
+			size_t count;
+		};
+
+		size_t vertexCount;
+		std::vector<Target> targets;
+		std::vector<ui32> vertices;
+		std::vector<float> positionDeltas;
+		std::vector<float> normalDeltas; // empty until a target has normals
+	};
+
+}
+
+#endif // !MGL_MORPH_TARGETS_HPP
@@ -0,0 +1,82 @@
+#ifndef MGL_SKELETON_HPP
+#define MGL_SKELETON_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+#include <mgl/models/meshes/mglMesh.hpp>
+
+#include <span>
+#include <string>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * Bone of a skeleton. 'bindLocal' is its rest transform relative to its
+	 * parent, 'inverseBind' takes mesh-space vertices into the bone's space.
+	 */
+	struct Bone {
+		std::string name;
+		i32 parent = -1;
+		math::mat4 bindLocal;
+		math::mat4 inverseBind;
+	};
+
+	/**
+	 * Bone hierarchy of a skinned mesh. Bones are stored parents first, so a
+	 * single forward pass computes all global transforms.
+	 */
+	class Skeleton {
+	public:
+		/// Maximum bones of a skeleton - VertexSkin addresses them with 8 bits
+		static constexpr size_t MAX_BONES = 256;
+
+		/// Adds a bone, whose parent must already be in the skeleton. Returns its index
+		i32 addBone(const Bone& bone);
+		i32 find(const std::string& name) const;
+		const Bone& getBone(size_t index) const;
+		size_t size() const;
+
+		/// Transform applied after the bone globals, e.g. the inverse of the root node transform
+		void setRootTransform(const math::mat4& transform);
+
+		/// Local transforms of the bind pose
+		void bindPose(std::span<math::mat4> local) const;
+
+		/**
+		 * Computes the skinning palette from local bone transforms:
+		 * palette[b] = root * global[b] * inverseBind[b].
+		 * @param global scratch, receives the global transform of every bone
+		 */
+		void computePalette(std::span<const math::mat4> local, std::span<math::mat4> global,
+		                    std::span<math::mat4> palette) const;
+
+	private:
+		std::vector<Bone> bones;
+		math::mat4 root = math::mat4::identity();
+	};
+
+	/**
+	 * Accumulates the bone influences of a vertex and keeps the 4 strongest,
+	 * e.g. while reading per-bone weight lists of an imported mesh.
+	 */
+	class SkinBuilder {
+	public:
+		explicit SkinBuilder(size_t vertexCount);
+
+		void addInfluence(size_t vertex, ui32 bone, float weight);
+
+		/// Weights of every vertex normalized to 255, strongest bones first
+		std::vector<VertexSkin> build() const;
+
+	private:
+		struct Influences {
+			ui32 bones[4] = {};
+			float weights[4] = {};
+		};
+		std::vector<Influences> vertices;
+	};
+
+}
+
+#endif // !MGL_SKELETON_HPP
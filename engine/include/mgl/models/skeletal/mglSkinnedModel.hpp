@@ -0,0 +1,40 @@
+#ifndef MGL_SKINNED_MODEL_HPP
+#define MGL_SKINNED_MODEL_HPP
+
+#include <mgl/models/meshes/mglMesh.hpp>
+#include <mgl/models/skeletal/mglAnimationClip.hpp>
+#include <mgl/models/skeletal/mglMorphTargets.hpp>
+#include <mgl/models/skeletal/mglSkeleton.hpp>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * Skinned model imported with Assimp: the bind-pose geometry of all its
+	 * meshes (one submesh each), the bones and weights of every vertex, the
+	 * morph targets of its meshes (aiAnimMesh) as sparse deltas, and its
+	 * animation clips, with their morph weight channels.
+	 *
+	 * The skeleton holds the bones and their ancestors in the node hierarchy,
+	 * so clips animating any of them apply. The geometry is meant for
+	 * Mesh::createFromData + Mesh::setSkin (GPU skinning) or
+	 * DynamicMesh::create + Skinning (CPU skinning).
+	 */
+	struct SkinnedModel {
+		MeshData mesh;
+		std::vector<VertexSkin> skin;
+		Skeleton skeleton;
+		MorphTargets morphs;
+		std::vector<float> morphWeights; // rest weight of every morph target
+		std::vector<AnimationClip> clips;
+
+		/// Imports a model file (relative to the resource folder), logging any error
+		static std::optional<SkinnedModel> load(const std::string& filename);
+	};
+
+}
+
+#endif // !MGL_SKINNED_MODEL_HPP
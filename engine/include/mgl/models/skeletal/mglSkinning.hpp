@@ -0,0 +1,44 @@
+#ifndef MGL_SKINNING_HPP
+#define MGL_SKINNING_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+#include <mgl/models/meshes/mglMesh.hpp>
+
+#include <span>
+
+namespace mgl {
+
+	/**
+	 * CPU linear blend skinning: every vertex is transformed by the weighted
+	 * sum of its bones' palette matrices.
+	 *
+	 * On x86 CPUs with AVX (detected at runtime) vertices are skinned 8 at a
+	 * time: each vertex's matrices are blended half a matrix per register,
+	 * then the 8 blended matrices are transposed and the positions and normals
+	 * transformed one vertex per lane; otherwise a portable scalar path is used. Results are typically written into a
+	 * DynamicMesh. Bone indices past the palette are clamped to its last bone.
+	 */
+	class Skinning {
+	public:
+		static bool hasAvx();
+
+		/**
+		 * Skins bind-pose positions and, if given, normals. Normals use the
+		 * blended matrix as is (palettes without non-uniform scale) and are
+		 * renormalized.
+		 * @param normals, outNormals both empty, or one per position
+		 */
+		static void skin(std::span<const math::vec3> positions, std::span<const math::vec3> normals,
+		                 std::span<const VertexSkin> skin, std::span<const math::mat4> palette,
+		                 std::span<math::vec3> outPositions, std::span<math::vec3> outNormals);
+
+		/// skin() with the portable path, whatever the CPU
+		static void skinScalar(std::span<const math::vec3> positions, std::span<const math::vec3> normals,
+		                       std::span<const VertexSkin> skin, std::span<const math::mat4> palette,
+		                       std::span<math::vec3> outPositions, std::span<math::vec3> outNormals);
+	};
+
+}
+
+#endif // !MGL_SKINNING_HPP
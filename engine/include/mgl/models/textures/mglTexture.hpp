@@ -2,6 +2,7 @@
 
 #include <string>
 #include <mgl/models/textures/mglSampler.hpp>
+#include <mgl/models/textures/mglTextureCache.hpp>
 #include <mgl/shaders/ShaderProgram.hpp>
 
 namespace mgl {
@@ -27,6 +28,9 @@ public:
 protected:
     void genAndBindTextureOpenGL(ui32  texType, ui32 channels,
         ui32 width, ui32 height, void* image, ui32 type);
+    // Uploads every level of a compiled texture (see TextureCache), decoding
+    // block compressed ones the driver cannot sample
+    void genAndBindCompiledTextureOpenGL(ui32 texType, const TextureCache::Entry& entry);
 };
 
 /////////////////////////////////////////////////////////////////////// TEXTURES
@@ -35,6 +39,7 @@ class Texture2D : public Texture {
 public:
   void bind() override;
   void unbind() override;
+  // Loads an image, or its compiled mip chain if mgl-assetc compiled it
   void load(const std::string &filename);
   void genPerlinNoise(ui32 size, ui32 octaves, 
       f64 atenuation, f64 frequency);
@@ -0,0 +1,69 @@
+#ifndef MGL_TEXTURE_CACHE_HPP
+#define MGL_TEXTURE_CACHE_HPP
+
+#include "types.hpp"
+#include <mgl/models/textures/mglTextureCompressor.hpp>
+#include <utils/file.hpp>
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * Versioned binary cache of compiled 2D textures, written by mgl-assetc.
+	 *
+	 * An entry holds the whole mip chain of an image, decoded and flipped as
+	 * Texture2D::load() uploads it, raw or block compressed. Entries are keyed
+	 * by a hash of the source image file, so editing it makes Texture2D
+	 * fall back to decoding the image until it is compiled again.
+	 *
+	 * File layout (host endianness): a fixed header with a level table,
+	 * followed by the levels, each 16-byte aligned so they can be uploaded
+	 * straight from a memory mapping.
+	 */
+	class TextureCache {
+	public:
+		static constexpr ui32 VERSION = 1;
+		static constexpr ui32 MAX_LEVELS = 16;
+
+		struct Level {
+			ui32 width;
+			ui32 height;
+			std::span<const u8> data;
+		};
+
+		/// A memory-mapped cache entry - 'levels' point into 'file'
+		struct Entry {
+			file::MappedFile file;
+			TextureCompressor::Format format;
+			ui32 channels;
+			std::vector<Level> levels;
+		};
+
+		/// Directory where entries are stored (default: <exe_dir>/cache/textures)
+		static void setDirectory(const std::filesystem::path& directory);
+		static std::filesystem::path getDirectory();
+
+		/// Key of a source image file's content
+		static u64 makeKey(std::span<const std::byte> source);
+
+		/// Maps the entry for key, if present and valid
+		static std::optional<Entry> open(u64 key);
+
+		/**
+		 * Writes an entry for key. levels[i] holds mip i of a width x height
+		 * image, in format. Returns false if it could not be written.
+		 */
+		static bool store(u64 key, TextureCompressor::Format format, ui32 channels,
+		                  ui32 width, ui32 height, std::span<const std::vector<u8>> levels);
+
+		static std::filesystem::path entryPath(u64 key);
+	};
+
+}
+
+#endif // !MGL_TEXTURE_CACHE_HPP
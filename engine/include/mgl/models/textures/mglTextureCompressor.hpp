@@ -0,0 +1,54 @@
+#ifndef MGL_TEXTURE_COMPRESSOR_HPP
+#define MGL_TEXTURE_COMPRESSOR_HPP
+
+#include "types.hpp"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * CPU side of compiled textures: mip chain generation and block
+	 * compression (BC1/3/4/5, a.k.a. DXT1/DXT5/RGTC1/RGTC2).
+	 *
+	 * Every 4x4 block is encoded independently: colors are fit on their
+	 * principal axis (BC1 and the color half of BC3), single channels on
+	 * their range (BC4, the alpha half of BC3 and both halves of BC5).
+	 * Decoders are provided for drivers without S3TC support and for tests.
+	 */
+	class TextureCompressor {
+	public:
+		enum class Format : ui32 { RAW, BC1, BC3, BC4, BC5 };
+
+		/// 8 bits per channel, rows in upload order
+		struct Image {
+			ui32 width = 0;
+			ui32 height = 0;
+			ui32 channels = 0;
+			std::vector<u8> pixels;
+		};
+
+		/// Block format for images with 'channels' channels (1 -> BC4 ... 4 -> BC3)
+		static Format formatFor(ui32 channels);
+
+		/// Bytes of a width x height level of image with 'channels' channels stored as format
+		static size_t levelSize(Format format, ui32 width, ui32 height, ui32 channels);
+
+		/// Half-size image, each texel the average of a 2x2 footprint (2x1 or 1x2 along a size 1 side)
+		static Image downsample(const Image& image);
+
+		/// The image followed by all its downsampled levels, down to 1x1
+		static std::vector<Image> mipChain(Image image);
+
+		/// Encodes image in format; RAW returns the pixels unchanged
+		static std::vector<u8> compress(const Image& image, Format format);
+
+		/// Decodes a level back to 8-bit channels (3 for BC1, 4 for BC3, 1 for BC4, 2 for BC5)
+		static Image decompress(std::span<const u8> data, Format format, ui32 width, ui32 height);
+	};
+
+}
+
+#endif // !MGL_TEXTURE_COMPRESSOR_HPP
@@ -0,0 +1,184 @@
+#ifndef MGL_FLAT_SCENE_HIERARCHY_HPP
+#define MGL_FLAT_SCENE_HIERARCHY_HPP
+
+#include "types.hpp"
+#include "math/math.hpp"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace util {
+	class ThreadPool;
+}
+
+namespace mgl {
+
+	/**
+	 * Transform hierarchy stored as flat arrays: local transforms, world
+	 * transforms and parent indices, one entry per node, with parents always
+	 * before their children. World transforms are then updated in a single
+	 * linear pass, every parent's already final when its children read it.
+	 *
+	 * Nodes are referred to by handles, which stay valid while nodes are
+	 * added, removed or reparented - the array slot behind a handle does not.
+	 * Reparenting a node under one stored after it restores the order lazily,
+	 * on the next update, by laying the nodes out depth-first so every
+	 * subtree is contiguous.
+	 *
+	 * Updates are incremental: changing a node's local transform or parent
+	 * marks it dirty, and an update only recomputes dirty nodes and their
+	 * descendants - a node is recomputed if it is dirty or its parent was
+	 * recomputed by the same pass, so dirtiness reaches the whole subtree
+	 * without visiting it. The pass starts at the first dirty node, since
+	 * nothing stored before it can depend on it.
+	 *
+	 * Large hierarchies can be updated on a thread pool, one depth level at
+	 * a time: nodes of a level only read the previous one, and each is
+	 * written by a single task with the same arithmetic as the serial pass,
+	 * so the results are identical. For that the nodes are laid out level by
+	 * level instead, which still puts parents first and lasts until the
+	 * structure changes.
+	 *
+	 * SceneNodes keep their transforms here (see SceneNode::getHierarchy).
+	 * Not thread-safe, like the scene graph itself.
+	 */
+	class FlatSceneHierarchy {
+	public:
+		using Handle = ui32;
+		static constexpr ui32 NONE = ~0u;
+
+		/// <summary>
+		/// Nodes recomputed and skipped by updates
+		/// </summary>
+		struct UpdateCounters {
+			size_t updates = 0;
+			size_t updated = 0;
+			size_t skipped = 0;
+		};
+
+		/// <summary>
+		/// Adds a node with an identity local transform, as a root or under 'parent'
+		/// </summary>
+		Handle create(Handle parent = NONE);
+
+		/// <summary>
+		/// Removes a node. Its children become roots. The handle may be reused.
+		/// </summary>
+		void destroy(Handle node);
+
+		/// <summary>
+		/// Moves a node, with its subtree, under 'parent' (NONE for a root).
+		/// Throws std::invalid_argument if parent is the node or one of its descendants
+		/// </summary>
+		void setParent(Handle node, Handle parent);
+		Handle getParent(Handle node) const;
+
+		/// <summary>
+		/// Sets the transform relative to the parent. Marks the node dirty unless unchanged
+		/// </summary>
+		void setLocalTransform(Handle node, const math::mat4& transform);
+		const math::mat4& getLocalTransform(Handle node) const;
+
+		/// <summary>
+		/// World transform as of the last updateWorldTransforms()
+		/// </summary>
+		const math::mat4& getWorldTransform(Handle node) const;
+
+		/// <summary>
+		/// Update that last recomputed the world transform of the node (0 if
+		/// none yet). Changes whenever the world transform may have changed
+		/// </summary>
+		ui32 getWorldVersion(Handle node) const;
+
+		/// <summary>
+		/// Recomputes the world transforms of dirty nodes and their descendants, parents first
+		/// </summary>
+		void updateWorldTransforms();
+
+		/// <summary>
+		/// Same as updateWorldTransforms(), splitting every depth level across
+		/// the workers of 'pool'. Hierarchies under PARALLEL_MIN_NODES, and
+		/// levels under PARALLEL_CHUNK nodes, are updated on the calling thread
+		/// </summary>
+		void updateWorldTransforms(util::ThreadPool& pool);
+
+		static constexpr size_t PARALLEL_MIN_NODES = 8192;
+		static constexpr size_t PARALLEL_CHUNK = 1024;
+
+		/// <summary>
+		/// True if some node is dirty
+		/// </summary>
+		bool needsUpdate() const;
+
+		/// <summary>
+		/// Totals of every update since construction or resetCounters(),
+		/// and of the last update alone
+		/// </summary>
+		const UpdateCounters& getCounters() const;
+		const UpdateCounters& getLastUpdate() const;
+		void resetCounters();
+
+		bool contains(Handle node) const;
+		size_t size() const;
+
+		/// <summary>
+		/// The arrays, parents before children. Parent indices are positions in
+		/// these arrays. Invalidated by any change to the hierarchy
+		/// </summary>
+		std::span<const math::mat4> localTransforms() const;
+		std::span<const math::mat4> worldTransforms() const;
+		std::span<const ui32> parentIndices() const;
+
+	private:
+		// per slot, in topological order
+		std::vector<math::mat4> locals;
+		std::vector<math::mat4> worlds;
+		std::vector<ui32> parents;
+		std::vector<ui32> childCounts;
+		std::vector<Handle> handles;
+		std::vector<ui32> versions;
+		std::vector<u8> dirty;
+
+		// per handle: its slot, or NONE if free
+		std::vector<ui32> slots;
+		std::vector<Handle> freeHandles;
+
+		bool unordered = false;
+		// lowest dirty slot, NONE if none
+		ui32 firstDirty = NONE;
+		ui32 updateCount = 0;
+		UpdateCounters counters;
+		UpdateCounters lastUpdate;
+
+		// while laid out by depth: first slot of every depth, and the end
+		std::vector<ui32> levelStarts;
+		bool byDepth = false;
+
+		/// Slot of a live node, throws std::invalid_argument otherwise
+		ui32 slotOf(Handle node) const;
+
+		/// Moves the node of slot 'from' into slot 'to'
+		void moveSlot(ui32 from, ui32 to);
+
+		void markDirty(ui32 slot);
+
+		/// Recomputes the world transform of a slot if it or its parent
+		/// changed in pass 'version'. Returns whether it did
+		bool updateSlot(ui32 slot, ui32 version);
+		void finishUpdate(size_t updated);
+
+		/// Lays the nodes out depth-first, roots in their current order
+		void sortTopologically();
+
+		/// Lays the nodes out by depth, keeping their order within a level,
+		/// and finds where every level starts
+		void sortByDepth();
+
+		/// Moves the node of slot order[i] into slot i, for every i
+		void reorder(const std::vector<ui32>& order);
+	};
+
+}
+
+#endif // !MGL_FLAT_SCENE_HIERARCHY_HPP
@@ -0,0 +1,86 @@
+#ifndef MGL_INSTANCED_SCENE_OBJECT_HPP
+#define MGL_INSTANCED_SCENE_OBJECT_HPP
+
+#include <glad/glad.h>
+#include <mgl/models/meshes/mglMesh.hpp>
+#include <mgl/models/materials/mglMaterial.hpp>
+#include <mgl/scene/mglSceneGraph.hpp>
+#include <mgl/scene/mglSceneObject.hpp>
+#include <vector>
+
+namespace mgl {
+
+	/**
+	 * Draws many copies of one mesh, with a shared material and shader program,
+	 * in one instanced draw call per submesh instead of one SceneObject each.
+	 *
+	 * Every instance has its own transform, relative to this node. The final
+	 * model matrices are uploaded to an instance buffer whenever instances or
+	 * the node move, and reach the shaders through MODEL_MATRIX_ATTRIBUTE
+	 * (a per-instance mat4) instead of the MODEL_MATRIX uniform.
+	 * All instances are drawn with the mesh's full-detail LOD, without meshlet culling.
+	 */
+	class InstancedSceneObject : public SceneNode {
+	public:
+		InstancedSceneObject(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material, std::shared_ptr<ShaderProgram> shaders);
+		~InstancedSceneObject();
+
+		/// <summary>
+		/// Adds an instance, returning its index
+		/// </summary>
+		size_t addInstance(const math::mat4& transform);
+		void setInstance(size_t index, const math::mat4& transform);
+		const math::mat4& getInstance(size_t index) const;
+
+		/// <summary>
+		/// Removes an instance, moving the last one into its index
+		/// </summary>
+		void removeInstance(size_t index);
+		void clearInstances();
+		size_t getInstanceCount() const;
+
+		void setScene(Scene* scene) override;
+		void setSkybox(std::shared_ptr<TextureSampler> skybox) override;
+		Material& getMaterial();
+
+		/// <summary>
+		/// Sets a callback used whenever drawing these instances.
+		/// Useful when shaders have custom properties
+		/// </summary>
+		void setShaderUniformCallback(SetShaderUniformCallback callback);
+
+	protected:
+		/// <summary>
+		/// Uploads the instance matrices if needed, then draws all instances
+		/// </summary>
+		void performDraw() override;
+
+		/// <summary>
+		/// Instance matrices depend on AbsoluteTransform - schedules their upload,
+		/// which also recomputes the world bounds
+		/// </summary>
+		void updateWorldBounds() override;
+
+	private:
+		Scene* scene = nullptr;
+		std::shared_ptr<ShaderProgram> shaders;
+		std::shared_ptr<Mesh> mesh;
+		std::shared_ptr<Material> material;
+		std::vector<SetShaderUniformCallback> shaderUniformCallbacks;
+
+		std::vector<math::mat4> instances;
+		std::vector<math::mat4> modelMatrices;
+		GLuint instanceBuffer = 0;
+		size_t instanceCapacity = 0;
+		bool instancesDirty = true;
+
+		/// <summary>
+		/// Computes the model matrix of every instance and its world bounds,
+		/// and uploads the matrices to the instance buffer
+		/// </summary>
+		void uploadInstances();
+	};
+
+}
+
+#endif
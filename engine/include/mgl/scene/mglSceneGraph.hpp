@@ -4,7 +4,9 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <mgl/mglTransform.hpp>
+#include <mgl/mglBounds.hpp>
 #include <mgl/scene/mglDrawable.hpp>
+#include <mgl/scene/mglFlatSceneHierarchy.hpp>
 #include <mgl/scene/mglLight.hpp>
 #include <mgl/scene/mglLightManager.hpp>
 #include <mgl/camera/mglCameraManager.hpp>
@@ -63,20 +65,67 @@ namespace mgl {
 
 	/** Represents an abstract node in the SceneGraph.
 	 * Stores a reference to its parent.
+	 *
+	 * Its local and world transforms live in the shared FlatSceneHierarchy,
+	 * under getHandle(), mirroring the graph's parent-child relationships:
+	 * world transforms of all nodes are updated in one pass before drawing
+	 * (see updateTransforms), instead of node by node during the traversal.
 	 */
 	class SceneNode : public IDrawable , public Transform {
 	public:
 		SceneGraph* Parent;
 		math::mat4 AbsoluteTransform;
 
+		SceneNode(const SceneNode&) = delete;
+		SceneNode& operator=(const SceneNode&) = delete;
+
+		/// <summary>
+		/// Hierarchy holding the transforms of every scene node
+		/// </summary>
+		static FlatSceneHierarchy& getHierarchy();
+		FlatSceneHierarchy::Handle getHandle() const;
+
+		/// <summary>
+		/// Updates the world transforms of every node, on the shared thread pool
+		/// for large hierarchies. Scene::draw runs it before the traversal;
+		/// graphs drawn directly update on their first node instead
+		/// </summary>
+		static void updateTransforms();
+
 		math::vec3 getAbsolutePosition() const;
 		virtual void setScene(Scene* scene) = 0;
 		virtual void setSkybox(std::shared_ptr<TextureSampler> skybox) = 0;
 
+		/// <summary>
+		/// World-space AABB of the node, as of its last draw: its transformed
+		/// mesh bounds for objects, the union of its children's for graphs
+		/// </summary>
+		const AABB& getWorldBounds() const;
+
 	protected:
 		static SceneGraph* NO_PARENT;
+		AABB worldBounds;
+
 		SceneNode();
-		~SceneNode() = default;
+		~SceneNode();
+
+		/// <summary>
+		/// Reads AbsoluteTransform from the hierarchy, updating it first if
+		/// stale, calling updateWorldBounds() only if the hierarchy recomputed it
+		/// </summary>
+		void updateAbsoluteTransform();
+
+		void onTransformChanged() override;
+
+		/// <summary>
+		/// Refreshes worldBounds after AbsoluteTransform changed
+		/// </summary>
+		virtual void updateWorldBounds() {}
+
+	private:
+		FlatSceneHierarchy::Handle handle;
+		ui32 worldVersion = 0;
+		bool boundsDirty = true;
 	};
 
 	//////////////////////////////////////////////////////////////// Scene Graph
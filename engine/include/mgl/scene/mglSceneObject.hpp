@@ -5,6 +5,7 @@
 #include <GLFW/glfw3.h>
 #include <mgl/mglTransform.hpp>
 #include <mgl/models/meshes/mglMesh.hpp>
+#include <mgl/models/meshes/mglLodSelector.hpp>
 #include <mgl/models/materials/mglMaterial.hpp>
 #include <mgl/models/textures/mglTexture.hpp>
 #include <mgl/scene/mglSceneGraph.hpp>
@@ -50,6 +51,21 @@ namespace mgl {
 		/// <param name="callback"></param>
 		void setShaderUniformCallback(SetShaderUniformCallback callback);
 
+		/// <summary>
+		/// LOD selection settings (pixel error, hysteresis) of this object.
+		/// Only used when its mesh has LODs (see Mesh::generateLods)
+		/// </summary>
+		LodSelector& getLodSelector();
+
+		/// <summary>
+		/// Faces culled while this object is drawn - GL_BACK (the engine
+		/// default), GL_FRONT or GL_NONE. Objects whose beforeDraw callback
+		/// changes glCullFace declare it here, so meshlet culling matches
+		/// without querying OpenGL state every draw
+		/// </summary>
+		void setCullFace(GLenum face);
+		GLenum getCullFace() const;
+
 	protected:
 		/// <summary>
 		/// Bind the shaders associated to this object, set the shader information
@@ -57,12 +73,30 @@ namespace mgl {
 		/// </summary>
 		void performDraw() override;
 
+		/// <summary>
+		/// Transforms the mesh bounds into world space
+		/// </summary>
+		void updateWorldBounds() override;
+
 	private:
 		Scene* scene;
 		std::shared_ptr<ShaderProgram> shaders;
 		std::shared_ptr<Mesh> mesh;
 		std::shared_ptr<Material> material;
 		std::vector<SetShaderUniformCallback> shaderUniformCallbacks;
+		LodSelector lodSelector;
+		GLenum cullFace = GL_BACK;
+
+		/// <summary>
+		/// Picks the mesh LOD from its errors projected through the active camera
+		/// </summary>
+		void selectLod();
+
+		/// <summary>
+		/// Culls the mesh meshlets against the active camera and the object's
+		/// cull face
+		/// </summary>
+		void cullMeshlets();
 
 	};
 
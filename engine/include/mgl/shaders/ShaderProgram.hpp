@@ -9,6 +9,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <span>
 
 namespace mgl {
 
@@ -106,6 +107,9 @@ namespace mgl {
         void setUniform(i32 loc, const math::vec4& v);
         void setUniform(i32 loc, const math::mat4& m);
 
+        // Arrays (set from their first element)
+        void setUniform(i32 loc, std::span<const f32> v);
+
         void assertUniform(const std::string &name);
 
     };
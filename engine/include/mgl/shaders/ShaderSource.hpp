@@ -0,0 +1,54 @@
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mgl {
+
+    /**
+     * @brief GLSL source of a shader file, with its #include "file" directives expanded.
+     * Included paths are relative to the including file, and every file is
+     * included once. #line directives keep compiler messages pointing at the
+     * original files: the source string number is the file's index in dependencies.
+     *
+     * mgl-assetc stores expanded sources in the shader cache, with their
+     * dependency lists, so load() only expands files that changed since.
+     */
+    struct ShaderSource {
+        std::string code;
+        // Resource paths of the file, then of every file it includes
+        std::vector<std::string> dependencies;
+
+        /**
+         * @brief Reads filename from the resources and expands its includes.
+         * @returns nullopt (after logging the error) if a file is missing
+         */
+        static std::optional<ShaderSource> preprocess(const std::string &filename);
+
+        /**
+         * @brief The expanded source from the shader cache if none of its
+         * dependencies is newer, preprocess(filename) otherwise.
+         */
+        static std::optional<ShaderSource> load(const std::string &filename);
+
+        /**
+         * @brief Whether the shader cache holds an expanded source of filename
+         * newer than all of its dependencies.
+         */
+        static bool isCompiled(const std::string &filename);
+
+        /**
+         * @brief Writes the source and its dependency list to the shader cache,
+         * as the compiled version of filename.
+         * @returns false if they could not be written
+         */
+        bool store(const std::string &filename) const;
+
+        // Directory where expanded sources are stored (default: <exe_dir>/cache/shaders)
+        static void setCacheDirectory(const std::filesystem::path &directory);
+        static std::filesystem::path getCacheDirectory();
+    };
+
+} // namespace mgl
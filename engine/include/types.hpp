@@ -9,5 +9,7 @@ namespace mgl {
     using i32 = int;
     using u32 = unsigned;
     using u8 = std::uint8_t;
+    using u16 = std::uint16_t;
     using ui32 = std::uint32_t;
+    using u64 = std::uint64_t;
 }
\ No newline at end of file
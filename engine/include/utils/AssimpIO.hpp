@@ -0,0 +1,84 @@
+#ifndef UTILS_ASSIMP_IO_HPP
+#define UTILS_ASSIMP_IO_HPP
+
+#include <utils/file.hpp>
+
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace util {
+
+    /**
+     * @brief Assimp file system reading through file::vfs(), so models and the
+     * files they reference (e.g. OBJ material libraries) load from mounted
+     * packs as well as loose files. Paths are resource paths.
+     * Install with importer.SetIOHandler(new AssimpIO()) - the importer owns it.
+     */
+    class AssimpIO : public Assimp::IOSystem {
+    public:
+        bool Exists(const char* path) const override {
+            return file::vfs().exists(path);
+        }
+
+        char getOsSeparator() const override {
+            return '/';
+        }
+
+        Assimp::IOStream* Open(const char* path, const char* mode = "rb") override {
+            if (std::strchr(mode, 'w') || std::strchr(mode, 'a')) return nullptr;
+            file::Resource resource = file::vfs().open(path);
+            return resource ? new Stream(std::move(resource)) : nullptr;
+        }
+
+        void Close(Assimp::IOStream* stream) override {
+            delete stream;
+        }
+
+    private:
+        // Reads a resource view in place
+        class Stream : public Assimp::IOStream {
+        public:
+            explicit Stream(file::Resource resource) : resource(std::move(resource)) {}
+
+            size_t Read(void* buffer, size_t size, size_t count) override {
+                if (size == 0) return 0;
+                count = std::min(count, (resource.size() - position) / size);
+                std::memcpy(buffer, resource.data() + position, size * count);
+                position += size * count;
+                return count;
+            }
+
+            size_t Write(const void*, size_t, size_t) override {
+                return 0;
+            }
+
+            aiReturn Seek(size_t offset, aiOrigin origin) override {
+                const size_t base = origin == aiOrigin_SET ? 0 : origin == aiOrigin_CUR ? position : resource.size();
+                if (base + offset > resource.size()) return aiReturn_FAILURE;
+                position = base + offset;
+                return aiReturn_SUCCESS;
+            }
+
+            size_t Tell() const override {
+                return position;
+            }
+
+            size_t FileSize() const override {
+                return resource.size();
+            }
+
+            void Flush() override {}
+
+        private:
+            file::Resource resource;
+            size_t position = 0;
+        };
+    };
+
+} // namespace util
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef UTILS_RANGE_ALLOCATOR_HPP
+#define UTILS_RANGE_ALLOCATOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace util {
+
+    /**
+     * @brief Suballocates [offset, offset + size) ranges of a linear space,
+     * e.g. the elements of a GPU buffer.
+     *
+     * Free ranges are kept in a free list ordered by offset and allocations
+     * take the first one that fits (first fit). Freed ranges are merged with
+     * their free neighbours, so the list never holds two adjacent ranges.
+     * Alignment padding stays in the free list.
+     */
+    class RangeAllocator {
+    public:
+        static constexpr size_t INVALID = SIZE_MAX;
+
+        explicit RangeAllocator(size_t capacity = 0) : total(capacity) {
+            if (capacity > 0) freeRanges.emplace(0, capacity);
+        }
+
+        /**
+         * @brief Offset of a new range of 'size' units (at least 1) aligned
+         * to 'alignment', or INVALID if no free range can hold it.
+         */
+        size_t allocate(size_t size, size_t alignment = 1) {
+            size = std::max<size_t>(size, 1);
+            alignment = std::max<size_t>(alignment, 1);
+            for (auto it = freeRanges.begin(); it != freeRanges.end(); ++it) {
+                const size_t start = it->first, end = it->first + it->second;
+                const size_t offset = (start + alignment - 1) / alignment * alignment;
+                if (offset + size > end) continue;
+
+                freeRanges.erase(it);
+                if (offset > start) freeRanges.emplace(start, offset - start);
+                if (offset + size < end) freeRanges.emplace(offset + size, end - offset - size);
+                allocations.emplace(offset, size);
+                usedUnits += size;
+                return offset;
+            }
+            return INVALID;
+        }
+
+        /// @brief Returns a range obtained from allocate() to the free list
+        void free(size_t offset) {
+            const auto allocation = allocations.find(offset);
+            if (allocation == allocations.end()) {
+                throw std::invalid_argument("RangeAllocator::free: no range allocated at offset");
+            }
+            size_t start = offset, size = allocation->second;
+            usedUnits -= size;
+            allocations.erase(allocation);
+
+            auto next = freeRanges.lower_bound(start);
+            if (next != freeRanges.end() && start + size == next->first) {
+                size += next->second;
+                next = freeRanges.erase(next);
+            }
+            if (next != freeRanges.begin()) {
+                const auto previous = std::prev(next);
+                if (previous->first + previous->second == start) {
+                    start = previous->first;
+                    size += previous->second;
+                    freeRanges.erase(previous);
+                }
+            }
+            freeRanges.emplace(start, size);
+        }
+
+        /// @brief Extends the space to 'capacity' units. Never shrinks it
+        void grow(size_t capacity) {
+            if (capacity <= total) return;
+            size_t start = total;
+            if (!freeRanges.empty()) {
+                const auto last = std::prev(freeRanges.end());
+                if (last->first + last->second == total) {
+                    start = last->first;
+                    freeRanges.erase(last);
+                }
+            }
+            freeRanges.emplace(start, capacity - start);
+            total = capacity;
+        }
+
+        /// @brief Size of the range allocated at offset
+        size_t sizeOf(size_t offset) const {
+            const auto allocation = allocations.find(offset);
+            return allocation == allocations.end() ? 0 : allocation->second;
+        }
+
+        size_t capacity() const { return total; }
+        size_t used() const { return usedUnits; }
+        size_t allocationCount() const { return allocations.size(); }
+        size_t freeRangeCount() const { return freeRanges.size(); }
+
+        size_t largestFree() const {
+            size_t largest = 0;
+            for (const auto& [offset, size] : freeRanges) largest = std::max(largest, size);
+            return largest;
+        }
+
+        /**
+         * @brief 0 when all free space is one range, approaching 1 as it is
+         * scattered in small ranges.
+         */
+        float fragmentation() const {
+            const size_t available = total - usedUnits;
+            return available == 0 ? 0.0f : 1.0f - static_cast<float>(largestFree()) / available;
+        }
+
+    private:
+        size_t total = 0;
+        size_t usedUnits = 0;
+        std::map<size_t, size_t> freeRanges;            // offset -> size
+        std::unordered_map<size_t, size_t> allocations; // offset -> size
+    };
+
+}
+
+#endif // !UTILS_RANGE_ALLOCATOR_HPP
@@ -0,0 +1,137 @@
+#ifndef UTILS_THREAD_POOL_HPP
+#define UTILS_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace util {
+
+    /**
+     * @brief Fixed set of worker threads that run data-parallel loops.
+     *
+     * Work is handed out one index at a time from a shared counter, so uneven
+     * items (e.g. files of very different sizes) balance themselves. Each call
+     * to the loop body receives the index of the worker running it, which can
+     * be used to address per-worker scratch state without locking.
+     */
+    class ThreadPool {
+    public:
+        using Task = std::function<void(size_t index, size_t worker)>;
+
+        explicit ThreadPool(size_t threads = std::thread::hardware_concurrency()) {
+            threads = std::max<size_t>(1, threads);
+            for (size_t w = 0; w < threads; w++) {
+                workers.emplace_back([this, w]() { workerLoop(w); });
+            }
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+            for (std::thread& worker : workers) worker.join();
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        size_t size() const { return workers.size(); }
+
+        /**
+         * @brief Runs fn(index, worker) for every index in [0, count) and blocks
+         * until all of them finished. Calls from several threads are serialized.
+         * A call from one of the pool's own workers (a nested loop) runs inline
+         * on that worker, with its index.
+         */
+        void parallelFor(size_t count, const Task& fn) {
+            if (count == 0) return;
+            if (currentPool == this) {
+                for (size_t i = 0; i < count; i++) fn(i, currentWorker);
+                return;
+            }
+            std::lock_guard<std::mutex> serial(submitMutex);
+            std::unique_lock<std::mutex> lock(mutex);
+            // workers still leaving the previous loop must not see the new counter
+            done.wait(lock, [this]() { return active == 0; });
+            task = &fn;
+            taskSize = count;
+            next = 0;
+            pending = count;
+            generation++;
+            lock.unlock();
+            wake.notify_all();
+
+            lock.lock();
+            done.wait(lock, [this]() { return pending == 0 && active == 0; });
+            task = nullptr;
+        }
+
+        /// Process-wide pool sized to the hardware concurrency
+        static ThreadPool& shared() {
+            static ThreadPool pool;
+            return pool;
+        }
+
+    private:
+        std::vector<std::thread> workers;
+        std::mutex submitMutex;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+
+        const Task* task = nullptr;
+        size_t taskSize = 0;
+        std::atomic<size_t> next{ 0 };
+        size_t pending = 0;
+        size_t active = 0;
+        size_t generation = 0;
+        bool stopping = false;
+
+        // pool and index of the worker running on this thread, if any
+        static inline thread_local const ThreadPool* currentPool = nullptr;
+        static inline thread_local size_t currentWorker = 0;
+
+        void workerLoop(size_t worker) {
+            currentPool = this;
+            currentWorker = worker;
+            size_t seen = 0;
+            while (true) {
+                const Task* current;
+                size_t count;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [&]() { return stopping || generation != seen; });
+                    if (stopping) return;
+                    seen = generation;
+                    current = task;
+                    count = taskSize;
+                    active++;
+                }
+
+                size_t finished = 0;
+                if (current) {
+                    for (size_t i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+                        (*current)(i, worker);
+                        finished++;
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                pending -= finished;
+                active--;
+                if (active == 0) done.notify_all();
+            }
+        }
+    };
+
+} // namespace util
+
+#endif
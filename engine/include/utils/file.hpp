@@ -2,8 +2,34 @@
 
 #include <filesystem>
 #include <fstream>
-#include <sstream>
-#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 #define FILE_DOESNT_EXIST "FILE_DOESNT_EXIST"
 
@@ -11,26 +37,333 @@ namespace file {
     namespace fs = std::filesystem;
 
     inline fs::path exe_dir() {
-        // Linux: resolve the running executable, then take its directory
-        return fs::canonical("/proc/self/exe").parent_path();
+        // resolve the running executable once, then take its directory
+#ifdef _WIN32
+        static const fs::path dir = [] {
+            std::wstring path(MAX_PATH, L'\0');
+            DWORD length;
+            while ((length = ::GetModuleFileNameW(nullptr, path.data(), static_cast<DWORD>(path.size()))) == path.size()) {
+                path.resize(path.size() * 2);
+            }
+            path.resize(length);
+            return fs::path(path).parent_path();
+        }();
+#else
+        static const fs::path dir = fs::canonical("/proc/self/exe").parent_path();
+#endif
+        return dir;
+    }
+
+    // Directory resource paths are relative to (default: "<exe_dir>/resources")
+    inline fs::path& resource_dir() {
+        static fs::path dir = exe_dir() / "resources";
+        return dir;
+    }
+
+    inline void set_resource_dir(const fs::path& dir) {
+        resource_dir() = dir;
     }
 
-    // Builds "<exe_dir>/resources/<relativeFilePath>"
+    // Builds "<resource_dir>/<relativeFilePath>"
     inline fs::path resource_path(const std::string& relativeFilePath) {
-        return exe_dir() / "resources" / fs::path(relativeFilePath);
+        return resource_dir() / fs::path(relativeFilePath);
     }
 
-    // Reads a text file from resources/, returns contents or "FILE_DOESNT_EXIST"
-    inline std::string readFile(const std::string& relativeFilePath) {
-        const fs::path fullPath = resource_path(relativeFilePath);
+    /**
+     * Read-only memory mapping of a whole file. The mapping stays valid for
+     * the lifetime of the object; an empty/failed mapping evaluates to false.
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        explicit MappedFile(const fs::path& path) {
+#ifdef _WIN32
+            const HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE) return;
+
+            LARGE_INTEGER size {};
+            if (::GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+                const HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (mapping) {
+                    void* ptr = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    if (ptr) {
+                        data_ = static_cast<const std::byte*>(ptr);
+                        size_ = static_cast<size_t>(size.QuadPart);
+                    }
+                    // the view keeps its own reference to the mapping
+                    ::CloseHandle(mapping);
+                }
+            }
+            ::CloseHandle(file);
+#else
+            const int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return;
+
+            struct stat info {};
+            if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+                void* ptr = ::mmap(nullptr, static_cast<size_t>(info.st_size),
+                                   PROT_READ, MAP_PRIVATE, fd, 0);
+                if (ptr != MAP_FAILED) {
+                    data_ = static_cast<const std::byte*>(ptr);
+                    size_ = static_cast<size_t>(info.st_size);
+                }
+            }
+            // the mapping keeps its own reference to the file
+            ::close(fd);
+#endif
+        }
+        ~MappedFile() { unmap(); }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept
+            : data_(other.data_), size_(other.size_) {
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        MappedFile& operator=(MappedFile&& other) noexcept {
+            if (this != &other) {
+                unmap();
+                data_ = other.data_;
+                size_ = other.size_;
+                other.data_ = nullptr;
+                other.size_ = 0;
+            }
+            return *this;
+        }
+
+        explicit operator bool() const { return data_ != nullptr; }
+        const std::byte* data() const { return data_; }
+        size_t size() const { return size_; }
+        std::span<const std::byte> bytes() const { return { data_, size_ }; }
+
+    private:
+        const std::byte* data_ = nullptr;
+        size_t size_ = 0;
+
+        void unmap() {
+#ifdef _WIN32
+            if (data_) ::UnmapViewOfFile(data_);
+#else
+            if (data_) ::munmap(const_cast<std::byte*>(data_), size_);
+#endif
+            data_ = nullptr;
+            size_ = 0;
+        }
+    };
+
+    /**
+     * Read-only, zero-copy view of a resource: a slice of a mounted pack or a
+     * mapping of a loose file. The view keeps what it points into alive, so
+     * it stays valid even if its pack is unmounted. Evaluates to false when
+     * the resource was not found (empty files included).
+     */
+    class Resource {
+    public:
+        Resource() = default;
+        Resource(std::shared_ptr<const MappedFile> owner, std::span<const std::byte> bytes)
+            : owner_(std::move(owner)), bytes_(bytes) {}
+
+        explicit operator bool() const { return owner_ != nullptr; }
+        const std::byte* data() const { return bytes_.data(); }
+        size_t size() const { return bytes_.size(); }
+        std::span<const std::byte> bytes() const { return bytes_; }
+        std::string_view text() const { return { reinterpret_cast<const char*>(bytes_.data()), bytes_.size() }; }
+
+    private:
+        std::shared_ptr<const MappedFile> owner_;
+        std::span<const std::byte> bytes_;
+    };
+
+    /**
+     * Read-only archive of resources: a header, the file contents, each
+     * 16-byte aligned, then an index of (name, offset, size) entries and a
+     * name table. Names are resource paths ('/' separated, relative to the
+     * resource directory). The whole archive is memory-mapped once.
+     */
+    class PackFile {
+    public:
+        static constexpr std::uint32_t VERSION = 1;
+
+        struct Input {
+            std::string name;
+            fs::path source;
+        };
+
+        // Maps and indexes a pack. Returns nullptr if it is missing or invalid
+        static std::shared_ptr<const PackFile> open(const fs::path& path) {
+            auto pack = std::shared_ptr<PackFile>(new PackFile());
+            pack->mapping_ = std::make_shared<const MappedFile>(path);
+            const MappedFile& file = *pack->mapping_;
+            if (!file || file.size() < sizeof(Header)) return nullptr;
 
-        std::cout << "reading from file: " << fullPath.string() << std::endl;
+            Header header;
+            std::memcpy(&header, file.data(), sizeof(Header));
+            if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION ||
+                header.indexOffset > file.size() ||
+                header.entryCount > (file.size() - header.indexOffset) / sizeof(Entry)) {
+                return nullptr;
+            }
+            for (std::uint64_t e = 0; e < header.entryCount; e++) {
+                Entry entry;
+                std::memcpy(&entry, file.data() + header.indexOffset + e * sizeof(Entry), sizeof(Entry));
+                if (entry.offset > file.size() || entry.size > file.size() - entry.offset ||
+                    entry.nameOffset > file.size() || entry.nameSize > file.size() - entry.nameOffset) {
+                    return nullptr;
+                }
+                const std::string name(reinterpret_cast<const char*>(file.data() + entry.nameOffset), entry.nameSize);
+                pack->entries_[name] = { file.data() + entry.offset, static_cast<size_t>(entry.size) };
+            }
+            return pack;
+        }
 
-        std::ifstream in(fullPath);
-        if (!in.is_open()) return "FILE_DOESNT_EXIST";
+        // Writes a pack holding every input. Returns false if a source cannot be read or the pack written
+        static bool write(const fs::path& path, const std::vector<Input>& inputs) {
+            std::vector<Entry> entries(inputs.size());
+            std::vector<MappedFile> sources;
+            std::uint64_t offset = alignUp(sizeof(Header));
+            for (size_t i = 0; i < inputs.size(); i++) {
+                sources.emplace_back(inputs[i].source);
+                std::error_code error;
+                if (!sources.back() && fs::file_size(inputs[i].source, error) != 0) return false;
+                entries[i].offset = offset;
+                entries[i].size = sources.back().size();
+                offset = alignUp(offset + sources.back().size());
+            }
+            Header header{};
+            std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+            header.version = VERSION;
+            header.entryCount = inputs.size();
+            header.indexOffset = offset;
+            std::uint64_t nameOffset = offset + inputs.size() * sizeof(Entry);
+            for (size_t i = 0; i < inputs.size(); i++) {
+                entries[i].nameOffset = nameOffset;
+                entries[i].nameSize = inputs[i].name.size();
+                nameOffset += inputs[i].name.size();
+            }
 
-        std::ostringstream buf;
-        buf << in.rdbuf();
-        return buf.str();
+            // written next to the target, then renamed over it
+            fs::path tmp = path;
+            tmp += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+            {
+                std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+                const char padding[ALIGNMENT] = {};
+                out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+                std::uint64_t written = sizeof(Header);
+                for (size_t i = 0; i < inputs.size(); i++) {
+                    out.write(padding, entries[i].offset - written);
+                    out.write(reinterpret_cast<const char*>(sources[i].data()), sources[i].size());
+                    written = entries[i].offset + sources[i].size();
+                }
+                out.write(padding, header.indexOffset - written);
+                out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(Entry));
+                for (const Input& input : inputs) out.write(input.name.data(), input.name.size());
+                if (!out) {
+                    std::error_code error;
+                    fs::remove(tmp, error);
+                    return false;
+                }
+            }
+            std::error_code error;
+            fs::rename(tmp, path, error);
+            return !error;
+        }
+
+        Resource find(const std::string& name) const {
+            const auto found = entries_.find(name);
+            if (found == entries_.end()) return {};
+            return { mapping_, found->second };
+        }
+
+        size_t size() const { return entries_.size(); }
+
+    private:
+        struct Header {
+            char magic[4];
+            std::uint32_t version;
+            std::uint64_t entryCount;
+            std::uint64_t indexOffset;
+        };
+
+        struct Entry {
+            std::uint64_t nameOffset;
+            std::uint64_t nameSize;
+            std::uint64_t offset;
+            std::uint64_t size;
+        };
+
+        static constexpr char MAGIC[4] = { 'M', 'G', 'L', 'P' };
+        static constexpr std::uint64_t ALIGNMENT = 16;
+
+        static std::uint64_t alignUp(std::uint64_t value) {
+            return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+        }
+
+        PackFile() = default;
+
+        std::shared_ptr<const MappedFile> mapping_;
+        std::unordered_map<std::string, std::span<const std::byte>> entries_;
+    };
+
+    /**
+     * Resolves resource paths to their contents. Mounted packs are searched
+     * first, the last mounted first, then loose files under the resource
+     * directory. Absolute paths always name loose files.
+     */
+    class VirtualFileSystem {
+    public:
+        static VirtualFileSystem& instance() {
+            static VirtualFileSystem vfs;
+            return vfs;
+        }
+
+        // Mounts a pack on top of the others. Returns false if it cannot be opened
+        bool mount(const fs::path& pack) {
+            std::shared_ptr<const PackFile> opened = PackFile::open(pack);
+            if (!opened) return false;
+            std::unique_lock lock(mutex_);
+            packs_.push_back(std::move(opened));
+            return true;
+        }
+
+        void unmountAll() {
+            std::unique_lock lock(mutex_);
+            packs_.clear();
+        }
+
+        Resource open(const std::string& path) const {
+            const fs::path normalized = fs::path(path).lexically_normal();
+            if (normalized.is_relative()) {
+                const std::string name = normalized.generic_string();
+                std::shared_lock lock(mutex_);
+                for (auto pack = packs_.rbegin(); pack != packs_.rend(); ++pack) {
+                    if (Resource resource = (*pack)->find(name)) return resource;
+                }
+            }
+            auto loose = std::make_shared<const MappedFile>(resource_dir() / normalized);
+            if (!*loose) return {};
+            const std::span<const std::byte> bytes = loose->bytes();
+            return { std::move(loose), bytes };
+        }
+
+        bool exists(const std::string& path) const {
+            return static_cast<bool>(open(path));
+        }
+
+    private:
+        mutable std::shared_mutex mutex_;
+        std::vector<std::shared_ptr<const PackFile>> packs_;
+    };
+
+    inline VirtualFileSystem& vfs() {
+        return VirtualFileSystem::instance();
+    }
+
+    // Reads a text resource, returns contents or "FILE_DOESNT_EXIST"
+    inline std::string readFile(const std::string& relativeFilePath) {
+        const Resource resource = vfs().open(relativeFilePath);
+        if (!resource) return FILE_DOESNT_EXIST;
+        return std::string(resource.text());
     }
-} // namespace file
\ No newline at end of file
+} // namespace file
@@ -0,0 +1,47 @@
+#ifndef UTILS_HASH_HPP
+#define UTILS_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace util {
+
+    constexpr std::uint64_t HASH_SEED = 0xcbf29ce484222325ull;
+
+    /**
+     * @brief 64-bit non-cryptographic hash of a byte range (FNV-1a folded over
+     * 8-byte words). Fast enough to hash large asset files on load; only meant
+     * to detect content changes, not to resist collisions on purpose.
+     */
+    inline std::uint64_t hash64(const void* data, std::size_t size,
+                                std::uint64_t seed = HASH_SEED) {
+        constexpr std::uint64_t prime = 0x100000001b3ull;
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        std::uint64_t h = seed ^ (size * prime);
+
+        std::size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + i, 8);
+            h = (h ^ word) * prime;
+            h ^= h >> 32;
+        }
+        for (; i < size; i++) {
+            h = (h ^ bytes[i]) * prime;
+        }
+        // final avalanche so nearby inputs spread over all bits
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdull;
+        h ^= h >> 33;
+        return h;
+    }
+
+    /// Combines a value into an existing hash
+    inline std::uint64_t hashCombine(std::uint64_t h, std::uint64_t value) {
+        return hash64(&value, sizeof(value), h);
+    }
+
+} // namespace util
+
+#endif
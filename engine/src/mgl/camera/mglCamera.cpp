@@ -10,13 +10,22 @@ namespace mgl {
 		glBufferData(GL_UNIFORM_BUFFER, sizeof(math::mat4) * 2 + sizeof(math::vec3), 0, GL_STREAM_DRAW);
 		glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		viewportHeight = viewport[3];
+
 		// register resize callback
 		InputManager::getInstance().registerWindowSizeCallback(
 			[this](i32 width, i32 height) {
+			viewportHeight = height;
 			updateScreenRatio(width, height);
 			});
 	}
 
+	Camera::~Camera() {
+		if (activeCamera == this) activeCamera = nullptr;
+	}
+
 	void Camera::orthoResize(OrthoParams* params,
 		i32 winx, i32 winy) {
 		GLfloat screenRation = static_cast<float>(winx) / winy;
@@ -35,6 +44,11 @@ namespace mgl {
 		glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, uboId);
 		setViewMatrix();
 		setProjectionMatrix();
+		activeCamera = this;
+	}
+
+	Camera* Camera::getActive() {
+		return activeCamera;
 	}
 
 	void Camera::pitch(GLfloat degrees) {
@@ -64,6 +78,14 @@ namespace mgl {
 	math::mat4 Camera::getViewMatrix() const {
 		return viewMatrix;
 	}
+
+	math::mat4 Camera::getProjectionMatrix() const {
+		return projectionMatrix;
+	}
+
+	i32 Camera::getViewportHeight() const {
+		return viewportHeight;
+	}
 	/////////////////////////////////////////////////////////////////// Position
 
 	void Camera::lookAtFrom(const Transform* target, const math::vec3& _position) {
@@ -3,6 +3,7 @@
 #include "mgl/mglError.hpp"
 #include <mgl/mglInputManager.hpp>
 #include <utils/Logger.hpp>
+#include <utils/file.hpp>
 
 #include <iostream>
 
@@ -174,8 +175,20 @@ void displayInfo() {
     std::cout << GLM_VERSION_MESSAGE << std::endl;
 }
 
+static void mountResourcePack() {
+    // packed by mgl-assetc --pack - resources it holds are read from it
+    const std::filesystem::path pack = file::exe_dir() / "resources.mglpack";
+    if (!std::filesystem::exists(pack)) return;
+    if (file::vfs().mount(pack)) {
+        MGL_INFO("Mounted resource pack {}", pack.string());
+    } else {
+        MGL_WARN("Could not mount resource pack {}", pack.string());
+    }
+}
+
 void Engine::init() {
     mgl::log::init();
+    mountResourcePack();
     setupGLFW();
     setupGLAD();
     setupOpenGL();
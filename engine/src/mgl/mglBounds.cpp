@@ -0,0 +1,119 @@
+#include <mgl/mglBounds.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mgl {
+
+////////////////////////////////////////////////////////////////// AABB
+
+AABB AABB::fromPoints(std::span<const math::vec3> points) {
+    AABB box;
+    for (const math::vec3& p : points) {
+        box.expand(p);
+    }
+    return box;
+}
+
+bool AABB::empty() const {
+    return min[0] > max[0] || min[1] > max[1] || min[2] > max[2];
+}
+
+math::vec3 AABB::center() const {
+    return (min + max) * 0.5f;
+}
+
+math::vec3 AABB::halfExtent() const {
+    return (max - min) * 0.5f;
+}
+
+void AABB::expand(const math::vec3& point) {
+    for (int i = 0; i < 3; i++) {
+        min[i] = std::min(min[i], point[i]);
+        max[i] = std::max(max[i], point[i]);
+    }
+}
+
+void AABB::expand(const AABB& box) {
+    if (box.empty()) return;
+    expand(box.min);
+    expand(box.max);
+}
+
+AABB AABB::transformed(const math::mat4& m) const {
+    if (empty()) return *this;
+
+    // start from the translation, then add the smaller and larger product of
+    // every matrix entry with the box extent along its column
+    AABB result;
+    for (int r = 0; r < 3; r++) {
+        result.min[r] = result.max[r] = m(r, 3);
+        for (int c = 0; c < 3; c++) {
+            const float a = m(r, c) * min[c];
+            const float b = m(r, c) * max[c];
+            result.min[r] += std::min(a, b);
+            result.max[r] += std::max(a, b);
+        }
+    }
+    return result;
+}
+
+////////////////////////////////////////////////////////////////// BoundingSphere
+
+BoundingSphere BoundingSphere::fromPoints(std::span<const math::vec3> points, const AABB& box) {
+    BoundingSphere sphere;
+    if (points.empty()) return sphere;
+    sphere.center = box.center();
+    float radius2 = 0.0f;
+    for (const math::vec3& p : points) {
+        radius2 = std::max(radius2, (p - sphere.center).length2());
+    }
+    sphere.radius = std::sqrt(radius2);
+    return sphere;
+}
+
+bool BoundingSphere::empty() const {
+    return radius < 0.0f;
+}
+
+BoundingSphere BoundingSphere::transformed(const math::mat4& m) const {
+    if (empty()) return *this;
+    BoundingSphere result;
+    for (int r = 0; r < 3; r++) {
+        result.center[r] = m(r, 0) * center[0] + m(r, 1) * center[1] + m(r, 2) * center[2] + m(r, 3);
+    }
+    float scale2 = 0.0f;
+    for (int c = 0; c < 3; c++) {
+        scale2 = std::max(scale2, m(0, c) * m(0, c) + m(1, c) * m(1, c) + m(2, c) * m(2, c));
+    }
+    result.radius = radius * std::sqrt(scale2);
+    return result;
+}
+
+////////////////////////////////////////////////////////////////// Bounds
+
+Bounds Bounds::fromPoints(std::span<const math::vec3> points) {
+    Bounds bounds;
+    bounds.box = AABB::fromPoints(points);
+    bounds.sphere = BoundingSphere::fromPoints(points, bounds.box);
+    return bounds;
+}
+
+Bounds Bounds::merge(std::span<const Bounds> parts) {
+    Bounds bounds;
+    for (const Bounds& part : parts) {
+        bounds.box.expand(part.box);
+    }
+    if (bounds.box.empty()) return bounds;
+
+    // sphere around the merged box center reaching the farthest part sphere
+    bounds.sphere.center = bounds.box.center();
+    for (const Bounds& part : parts) {
+        if (part.sphere.empty()) continue;
+        bounds.sphere.radius = std::max(bounds.sphere.radius,
+            (part.sphere.center - bounds.sphere.center).length() + part.sphere.radius);
+    }
+    return bounds;
+}
+
+}
@@ -60,6 +60,7 @@ void Transform::resetTransform() {
     math::quat rotation{ 0.0f , 0.0f, 0.0f, 0.0f };
     math::vec3 scaleV{ 1, 1, 1 };
     math::vec3 translationV{ 0, 0, 0 };
+    onTransformChanged();
 }
 
 /**
@@ -148,6 +149,7 @@ void Transform::computeTransformMatrix() {
     math::mat4 translateM =  math::translate(I, positionV);
     math::mat4 rotationM  = rotation.toMat4();
     transformMatrix = translateM * rotationM * scaleM;
+    onTransformChanged();
 }
 
 void Transform::normalizeTransform() {
@@ -250,6 +252,7 @@ Transform* Transform::translate(const math::vec3& translateVec) {
     transformMatrix(1,3) = positionV.y();
     transformMatrix(2,3) = positionV.z();
     if (!trackingEnabled) targetPoint += translateVec;
+    onTransformChanged();
     return this;
 }
 
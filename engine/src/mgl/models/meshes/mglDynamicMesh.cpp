@@ -0,0 +1,234 @@
+#include <mgl/models/meshes/mglDynamicMesh.hpp>
+#include <utils/Logger.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace mgl {
+
+namespace {
+
+	constexpr size_t REGION_ALIGNMENT = 256;
+
+	size_t alignUp(size_t value, size_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+}
+
+DynamicMesh::DynamicMesh() {
+	streams[0] = { .id = POSITION, .components = 3, .elementSize = sizeof(math::vec3) };
+	streams[1] = { .id = NORMAL, .components = 3, .elementSize = sizeof(math::vec3) };
+	streams[2] = { .id = TEXCOORD, .components = 2, .elementSize = sizeof(math::vec2) };
+	streams[3] = { .id = COLOR, .components = 4, .elementSize = sizeof(math::vec4) };
+}
+
+DynamicMesh::~DynamicMesh() {
+	destroyRing();
+}
+
+void DynamicMesh::destroyRing() {
+	for (GLsync& fence : fences) {
+		if (fence) glDeleteSync(fence);
+		fence = nullptr;
+	}
+	if (ringBuffer) {
+		if (mapped) {
+			glBindBuffer(GL_COPY_WRITE_BUFFER, ringBuffer);
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		}
+		glDeleteBuffers(1, &ringBuffer);
+	}
+	ringBuffer = 0;
+	mapped = nullptr;
+}
+
+// vertices live in the ring, see pointAttributes
+void DynamicMesh::createVertexBuffers(const MeshView&, const VertexQuantizer*) {}
+
+void DynamicMesh::create(MeshData data) {
+	// CPU copies are kept here, as plain floats
+	VertexLayout layout;
+	setVertexLayout(layout);
+	useArena(false);
+	positions = data.positions;
+	normals = data.normals;
+	texcoords = data.texcoords;
+	colors = data.colors;
+	indices = data.indices;
+	submeshes = data.submeshes;
+	if (submeshes.empty()) {
+		submeshes.push_back({ static_cast<unsigned int>(indices.size()), 0, 0 });
+	}
+
+	createFromData(std::move(data));
+	if (getLodCount() > 1 || !getMeshlets().empty()) {
+		throw std::logic_error("DynamicMesh: LODs and meshlets need static geometry");
+	}
+	setResidency(Residency::Discard);
+
+	streams[0].enabled = true;
+	streams[1].enabled = !normals.empty();
+	streams[2].enabled = !texcoords.empty();
+	streams[3].enabled = !colors.empty();
+	regionSize = 0;
+	for (Stream& stream : streams) {
+		stream.offset = regionSize;
+		if (stream.enabled) regionSize += stream.elementSize * positions.size();
+	}
+	regionSize = alignUp(regionSize, REGION_ALIGNMENT);
+
+	destroyRing();
+	glGenBuffers(1, &ringBuffer);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, ringBuffer);
+	if (GLAD_GL_VERSION_4_4) {
+		regions = REGIONS;
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(GL_COPY_WRITE_BUFFER, regionSize * regions, nullptr, flags);
+		mapped = static_cast<std::byte*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, regionSize * regions, flags));
+	}
+	else {
+		regions = 1;
+		glBufferData(GL_COPY_WRITE_BUFFER, regionSize, nullptr, GL_DYNAMIC_DRAW);
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	// every region starts with the full initial data
+	for (Stream& stream : streams) {
+		stream.dirty.fill({ 0, positions.size() });
+	}
+	for (unsigned r = 0; r < regions; r++) {
+		writeRegion(r);
+	}
+	current = 0;
+	pointedRegion = -1;
+	changed = positionsChanged = false;
+	MGL_DEBUG("Dynamic mesh: {} vertices in {} region(s) of {} bytes{}", positions.size(), regions, regionSize,
+		mapped ? " [persistent]" : "");
+}
+
+template <typename T>
+void DynamicMesh::update(Stream& stream, std::vector<T>& shadow, std::span<const T> values, size_t first) {
+	if (!stream.enabled) {
+		throw std::invalid_argument("DynamicMesh: attribute was not created with the mesh");
+	}
+	if (first + values.size() > shadow.size()) {
+		throw std::out_of_range("DynamicMesh: vertex range out of range");
+	}
+	if (values.empty()) return;
+	std::copy(values.begin(), values.end(), shadow.begin() + first);
+	for (DirtyRange& dirty : stream.dirty) {
+		dirty.first = std::min(dirty.first, first);
+		dirty.last = std::max(dirty.last, first + values.size());
+	}
+	changed = true;
+}
+
+void DynamicMesh::updatePositions(std::span<const math::vec3> values, size_t first) {
+	update(streams[0], positions, values, first);
+	positionsChanged = true;
+}
+
+void DynamicMesh::updateNormals(std::span<const math::vec3> values, size_t first) {
+	update(streams[1], normals, values, first);
+}
+
+void DynamicMesh::updateTexcoords(std::span<const math::vec2> values, size_t first) {
+	update(streams[2], texcoords, values, first);
+}
+
+void DynamicMesh::updateColors(std::span<const math::vec4> values, size_t first) {
+	update(streams[3], colors, values, first);
+}
+
+size_t DynamicMesh::getVertexCount() const {
+	return positions.size();
+}
+
+bool DynamicMesh::isPersistent() const {
+	return mapped != nullptr;
+}
+
+const std::byte* DynamicMesh::shadowOf(const Stream& stream) const {
+	if (stream.id == POSITION) return reinterpret_cast<const std::byte*>(positions.data());
+	if (stream.id == NORMAL) return reinterpret_cast<const std::byte*>(normals.data());
+	if (stream.id == TEXCOORD) return reinterpret_cast<const std::byte*>(texcoords.data());
+	return reinterpret_cast<const std::byte*>(colors.data());
+}
+
+void DynamicMesh::waitFence(unsigned region) {
+	GLsync& fence = fences[region];
+	if (!fence) return;
+	GLenum status = glClientWaitSync(fence, 0, 0);
+	while (status == GL_TIMEOUT_EXPIRED) {
+		status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	}
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+void DynamicMesh::writeRegion(unsigned region) {
+	if (!mapped) glBindBuffer(GL_COPY_WRITE_BUFFER, ringBuffer);
+	for (Stream& stream : streams) {
+		DirtyRange& dirty = stream.dirty[region];
+		if (!stream.enabled || dirty.first >= dirty.last) continue;
+		const size_t offset = region * regionSize + stream.offset + dirty.first * stream.elementSize;
+		const size_t bytes = (dirty.last - dirty.first) * stream.elementSize;
+		const std::byte* src = shadowOf(stream) + dirty.first * stream.elementSize;
+		if (mapped) {
+			std::memcpy(mapped + offset, src, bytes);
+		}
+		else {
+			glBufferSubData(GL_COPY_WRITE_BUFFER, offset, bytes, src);
+		}
+		dirty = {};
+	}
+	if (!mapped) glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void DynamicMesh::commit() {
+	current = (current + 1) % regions;
+	waitFence(current);
+	writeRegion(current);
+	if (positionsChanged) {
+		MeshView data;
+		data.positions = positions;
+		data.indices = indices;
+		data.submeshes = submeshes;
+		updateBounds(data);
+	}
+	changed = positionsChanged = false;
+}
+
+void DynamicMesh::pointAttributes(unsigned region) {
+	glBindVertexArray(getVertexArray());
+	glBindBuffer(GL_ARRAY_BUFFER, ringBuffer);
+	for (const Stream& stream : streams) {
+		if (!stream.enabled) continue;
+		glEnableVertexAttribArray(stream.id);
+		glVertexAttribPointer(stream.id, stream.components, GL_FLOAT, GL_FALSE, 0,
+			reinterpret_cast<void*>(region * regionSize + stream.offset));
+	}
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	pointedRegion = static_cast<int>(region);
+}
+
+/*
+	Draws of one frame may share a region, so the fence is moved after
+	every draw and covers the last one
+*/
+void DynamicMesh::performDraw() {
+	if (!ringBuffer) return;
+	if (changed) commit();
+	if (pointedRegion != static_cast<int>(current)) pointAttributes(current);
+	Mesh::performDraw();
+	if (mapped) {
+		if (fences[current]) glDeleteSync(fences[current]);
+		fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+}
+
+}
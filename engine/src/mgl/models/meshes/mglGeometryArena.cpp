@@ -0,0 +1,227 @@
+#include <mgl/models/meshes/mglGeometryArena.hpp>
+#include <utils/Logger.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace mgl {
+
+namespace {
+
+	constexpr size_t INDEX_ALIGNMENT = 4;
+
+	// Arenas alive, shared by format - weak so the last mesh releases the GL objects
+	std::vector<std::weak_ptr<GeometryArena>>& arenas() {
+		static std::vector<std::weak_ptr<GeometryArena>> registry;
+		return registry;
+	}
+
+}
+
+GeometryArena::GeometryArena(const VertexFormat& format, size_t vertexCapacity, size_t indexCapacity)
+	: format(format), vertices(std::max<size_t>(vertexCapacity, 1)), indices(std::max<size_t>(indexCapacity, INDEX_ALIGNMENT)) {
+	if (format.stride == 0 || format.attributes.empty()) {
+		throw std::invalid_argument("GeometryArena: empty vertex format");
+	}
+	glGenVertexArrays(1, &vao);
+	reallocate(vertexBuffer, vertices.capacity() * format.stride, 0);
+	reallocate(indexBuffer, indices.capacity(), 0);
+	setupVao();
+}
+
+GeometryArena::~GeometryArena() {
+	glDeleteVertexArrays(1, &vao);
+	glDeleteBuffers(1, &vertexBuffer);
+	glDeleteBuffers(1, &indexBuffer);
+}
+
+std::shared_ptr<GeometryArena> GeometryArena::forFormat(const VertexFormat& format) {
+	auto& registry = arenas();
+	std::erase_if(registry, [](const std::weak_ptr<GeometryArena>& arena) { return arena.expired(); });
+	for (const auto& weak : registry) {
+		std::shared_ptr<GeometryArena> arena = weak.lock();
+		if (arena && arena->format == format) return arena;
+	}
+	auto arena = std::make_shared<GeometryArena>(format);
+	registry.push_back(arena);
+	return arena;
+}
+
+void GeometryArena::reallocate(GLuint& buffer, size_t bytes, size_t copied) {
+	GLuint fresh;
+	glGenBuffers(1, &fresh);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, fresh);
+	glBufferData(GL_COPY_WRITE_BUFFER, bytes, nullptr, GL_STATIC_DRAW);
+	if (buffer && copied > 0) {
+		glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, copied);
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+	if (buffer) glDeleteBuffers(1, &buffer);
+	buffer = fresh;
+}
+
+/*
+	Attribute pointers capture the buffer bound when they are set, so the
+	VAO is set up again whenever the buffers are replaced
+*/
+void GeometryArena::setupVao() {
+	glBindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	for (const VertexAttribute& attribute : format.attributes) {
+		glEnableVertexAttribArray(attribute.location);
+		glVertexAttribPointer(attribute.location, attribute.components, attribute.type, attribute.normalized,
+		                      static_cast<GLsizei>(format.stride), reinterpret_cast<void*>(attribute.offset));
+	}
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+GeometryArena::Handle GeometryArena::allocate(size_t vertexCount, size_t indexBytes) {
+	size_t firstVertex = vertices.allocate(vertexCount);
+	if (firstVertex == util::RangeAllocator::INVALID) {
+		const size_t capacity = std::max(vertices.capacity() * 2, vertices.capacity() + vertexCount);
+		reallocate(vertexBuffer, capacity * format.stride, vertices.capacity() * format.stride);
+		vertices.grow(capacity);
+		setupVao();
+		firstVertex = vertices.allocate(vertexCount);
+		MGL_DEBUG("Geometry arena grew to {} vertices", capacity);
+	}
+	size_t indexOffset = indices.allocate(indexBytes, INDEX_ALIGNMENT);
+	if (indexOffset == util::RangeAllocator::INVALID) {
+		const size_t capacity = std::max(indices.capacity() * 2, indices.capacity() + indexBytes + INDEX_ALIGNMENT);
+		reallocate(indexBuffer, capacity, indices.capacity());
+		indices.grow(capacity);
+		setupVao();
+		indexOffset = indices.allocate(indexBytes, INDEX_ALIGNMENT);
+		MGL_DEBUG("Geometry arena grew to {} index bytes", capacity);
+	}
+
+	Handle handle;
+	if (freeHandles.empty()) {
+		handle = static_cast<Handle>(ranges.size());
+		ranges.emplace_back();
+		live.push_back(true);
+	} else {
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+		live[handle] = true;
+	}
+	ranges[handle] = { firstVertex, vertexCount, indexOffset, indexBytes };
+	return handle;
+}
+
+void GeometryArena::release(Handle handle) {
+	if (handle >= ranges.size() || !live[handle]) {
+		throw std::invalid_argument("GeometryArena::release: invalid handle");
+	}
+	vertices.free(ranges[handle].firstVertex);
+	indices.free(ranges[handle].indexOffset);
+	live[handle] = false;
+	freeHandles.push_back(handle);
+}
+
+const GeometryArena::Range& GeometryArena::getRange(Handle handle) const {
+	if (handle >= ranges.size() || !live[handle]) {
+		throw std::invalid_argument("GeometryArena::getRange: invalid handle");
+	}
+	return ranges[handle];
+}
+
+std::byte* GeometryArena::map(GLuint buffer, size_t offset, size_t bytes) {
+	// a copy target, so that no VAO's element buffer binding is touched
+	glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+	if (bytes == 0) return nullptr;
+	return static_cast<std::byte*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, offset, bytes,
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT));
+}
+
+std::byte* GeometryArena::mapVertices(Handle handle) {
+	const Range& range = getRange(handle);
+	return map(vertexBuffer, range.firstVertex * format.stride, range.vertexCount * format.stride);
+}
+
+std::byte* GeometryArena::mapIndices(Handle handle) {
+	const Range& range = getRange(handle);
+	return map(indexBuffer, range.indexOffset, range.indexBytes);
+}
+
+void GeometryArena::unmap() {
+	GLint mapped = GL_FALSE;
+	glGetBufferParameteriv(GL_COPY_WRITE_BUFFER, GL_BUFFER_MAPPED, &mapped);
+	// GL_FALSE means the store got corrupted (e.g. video mode change)
+	if (mapped && glUnmapBuffer(GL_COPY_WRITE_BUFFER) == GL_FALSE) {
+		MGL_ERROR("Geometry arena contents were lost while mapped");
+		exit(EXIT_FAILURE);
+	}
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+}
+
+void GeometryArena::defragment() {
+	GLuint compactVertices = 0, compactIndices = 0;
+	util::RangeAllocator packedVertices(vertices.capacity());
+	util::RangeAllocator packedIndices(indices.capacity());
+	reallocate(compactVertices, vertices.capacity() * format.stride, 0);
+	reallocate(compactIndices, indices.capacity(), 0);
+
+	for (Handle handle = 0; handle < ranges.size(); handle++) {
+		if (!live[handle]) continue;
+		Range& range = ranges[handle];
+		const size_t firstVertex = packedVertices.allocate(range.vertexCount);
+		const size_t indexOffset = packedIndices.allocate(range.indexBytes, INDEX_ALIGNMENT);
+
+		glBindBuffer(GL_COPY_READ_BUFFER, vertexBuffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, compactVertices);
+		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, range.firstVertex * format.stride,
+		                    firstVertex * format.stride, range.vertexCount * format.stride);
+		if (range.indexBytes > 0) {
+			glBindBuffer(GL_COPY_READ_BUFFER, indexBuffer);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, compactIndices);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, range.indexOffset, indexOffset,
+			                    range.indexBytes);
+		}
+		range.firstVertex = firstVertex;
+		range.indexOffset = indexOffset;
+	}
+	glBindBuffer(GL_COPY_READ_BUFFER, 0);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	glDeleteBuffers(1, &vertexBuffer);
+	glDeleteBuffers(1, &indexBuffer);
+	vertexBuffer = compactVertices;
+	indexBuffer = compactIndices;
+	vertices = std::move(packedVertices);
+	indices = std::move(packedIndices);
+	setupVao();
+	generation++;
+	MGL_DEBUG("Defragmented geometry arena: {} vertices, {} index bytes", vertices.used(), indices.used());
+}
+
+u64 GeometryArena::getGeneration() const {
+	return generation;
+}
+
+GLuint GeometryArena::getVao() const {
+	return vao;
+}
+
+const GeometryArena::VertexFormat& GeometryArena::getFormat() const {
+	return format;
+}
+
+float GeometryArena::fragmentation() const {
+	return std::max(vertices.fragmentation(), indices.fragmentation());
+}
+
+size_t GeometryArena::getVertexCount() const {
+	return vertices.used();
+}
+
+size_t GeometryArena::getIndexBytes() const {
+	return indices.used();
+}
+
+}
@@ -0,0 +1,44 @@
+#include <mgl/models/meshes/mglLodSelector.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace mgl {
+
+void LodSelector::setPixelError(float pixels) {
+	if (!(pixels > 0.0f)) throw std::invalid_argument("LodSelector: pixel error must be positive");
+	_pixelError = pixels;
+}
+
+void LodSelector::setHysteresis(float fraction) {
+	if (!(fraction >= 0.0f && fraction < 1.0f))
+		throw std::invalid_argument("LodSelector: hysteresis must be in [0, 1)");
+	_hysteresis = fraction;
+}
+
+unsigned LodSelector::select(std::span<const float> lodErrors, float pixelsPerUnit) {
+	auto pixels = [&](unsigned level) {
+		return level == 0 ? 0.0f : lodErrors[level - 1] * pixelsPerUnit;
+	};
+	const unsigned levels = static_cast<unsigned>(lodErrors.size()) + 1;
+	_level = std::min(_level, levels - 1);
+
+	// refine while the current LOD is clearly too coarse, then coarsen while
+	// the next one is clearly fine - the dead band between both keeps the LOD
+	while (_level > 0 && pixels(_level) > _pixelError * (1.0f + _hysteresis)) {
+		_level--;
+	}
+	while (_level + 1 < levels && pixels(_level + 1) < _pixelError * (1.0f - _hysteresis)) {
+		_level++;
+	}
+	return _level;
+}
+
+float LodSelector::pixelsPerUnit(const math::mat4& projection, float viewportHeight, float distance) {
+	// clip w of a point 'distance' in front of the camera: the distance itself
+	// for perspective projections, 1 for orthographic ones
+	const float w = std::max(-projection(3, 2) * distance + projection(3, 3), 1e-6f);
+	return 0.5f * viewportHeight * projection(1, 1) / w;
+}
+
+}
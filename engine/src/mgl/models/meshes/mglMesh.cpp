@@ -1,7 +1,25 @@
 #include <mgl/models/meshes/mglMesh.hpp>
+#include <mgl/mglConventions.hpp>
+#include <mgl/models/meshes/mglMeshCache.hpp>
+#include <mgl/models/meshes/mglMeshOptimizer.hpp>
+#include <mgl/models/meshes/mglMeshSimplifier.hpp>
+#include <mgl/models/meshes/mglMeshlets.hpp>
+#include <mgl/models/meshes/mglObjLoader.hpp>
+#include <mgl/models/meshes/mglVertexQuantizer.hpp>
+#include <utils/AssimpIO.hpp>
 #include <utils/file.hpp>
 #include <utils/Logger.hpp>
+#include <utils/hash.hpp>
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cctype>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <utility>
 
 namespace mgl {
 
@@ -30,8 +48,41 @@ Mesh& Mesh::operator=(Mesh&& other) noexcept {
     _normalsLoaded = other._normalsLoaded;
     _texcoordsLoaded = other._texcoordsLoaded;
     _colorsLoaded = other._colorsLoaded;
+    _optimizations = other._optimizations;
+    _lodLevels = other._lodLevels;
+    _lodReduction = other._lodReduction;
+    _drawLod = other._drawLod;
+    _meshletVertices = other._meshletVertices;
+    _meshletTriangles = other._meshletTriangles;
+    _cacheEnabled = other._cacheEnabled;
+    _nativeObj = other._nativeObj;
+    _cacheKey = other._cacheKey;
+    _residency = other._residency;
+    _layout = std::move(other._layout);
+    _dequantization = other._dequantization;
+    _bounds = other._bounds;
+    _submeshBounds = std::move(other._submeshBounds);
+    _mapping = std::move(other._mapping);
+    _mappedView = other._mappedView;
+    other._mappedView = MeshView();
 
     _meshes     = std::move(other._meshes);
+    _lodMeshes  = std::move(other._lodMeshes);
+    _lodErrors  = std::move(other._lodErrors);
+    _meshlets   = std::move(other._meshlets);
+    _draws      = std::move(other._draws);
+    _meshletDraws = std::move(other._meshletDraws);
+    _indirectBuffer = std::exchange(other._indirectBuffer, 0);
+    _indirectGroups = std::move(other._indirectGroups);
+    _skinBuffer = std::exchange(other._skinBuffer, 0);
+    _arenaEnabled = other._arenaEnabled;
+    _arena = std::move(other._arena);
+    _arenaRange = std::exchange(other._arenaRange, GeometryArena::INVALID);
+    _arenaPlacement = other._arenaPlacement;
+    _arenaGeneration = other._arenaGeneration;
+    _visible[0] = std::move(other._visible[0]);
+    _visible[1] = std::move(other._visible[1]);
+    _culled = std::exchange(other._culled, false);
     _indices    = std::move(other._indices);
     _positions  = std::move(other._positions);
     _normals    = std::move(other._normals);
@@ -57,104 +108,942 @@ void Mesh::generateTexcoords() { AssimpFlags |= aiProcess_GenUVCoords; }
 
 void Mesh::flipUVs() { AssimpFlags |= aiProcess_FlipUVs; }
 
+void Mesh::optimizeVertexCache() { _optimizations |= MeshOptimizer::VERTEX_CACHE; }
+
+void Mesh::optimizeOverdraw() { _optimizations |= MeshOptimizer::OVERDRAW; }
+
+void Mesh::optimizeVertexFetch() { _optimizations |= MeshOptimizer::VERTEX_FETCH; }
+
+void Mesh::generateLods(unsigned levels, float reduction) {
+  if (!(reduction > 0.0f && reduction < 1.0f)) {
+    throw std::invalid_argument("generateLods: reduction must be in (0, 1)");
+  }
+  _lodLevels = levels;
+  _lodReduction = reduction;
+}
+
+unsigned Mesh::getLodCount() const { return static_cast<unsigned>(_lodErrors.size()) + 1; }
+
+std::span<const float> Mesh::getLodErrors() const { return _lodErrors; }
+
+void Mesh::setDrawLod(unsigned level) { _drawLod = level; }
+
+void Mesh::setInstances(GLuint instanceBuffer, GLsizei instanceCount) {
+  _instanceBuffer = instanceBuffer;
+  _instanceCount = instanceCount;
+}
+
+void Mesh::setSkin(std::span<const VertexSkin> skin) {
+  if (!VaoId) {
+    throw std::logic_error("setSkin: the mesh must be uploaded to its own buffers first");
+  }
+  glBindVertexArray(VaoId);
+  if (!_skinBuffer) glGenBuffers(1, &_skinBuffer);
+  glBindBuffer(GL_ARRAY_BUFFER, _skinBuffer);
+  glBufferData(GL_ARRAY_BUFFER, skin.size_bytes(), skin.data(), GL_STATIC_DRAW);
+  glEnableVertexAttribArray(BONE_INDICES);
+  glVertexAttribIPointer(BONE_INDICES, 4, GL_UNSIGNED_BYTE, sizeof(VertexSkin),
+                         reinterpret_cast<void *>(offsetof(VertexSkin, bones)));
+  glEnableVertexAttribArray(BONE_WEIGHTS);
+  glVertexAttribPointer(BONE_WEIGHTS, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(VertexSkin),
+                        reinterpret_cast<void *>(offsetof(VertexSkin, weights)));
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Mesh::buildMeshlets(unsigned maxVertices, unsigned maxTriangles) {
+  if (maxVertices < 3 || maxTriangles < 1) {
+    throw std::invalid_argument("buildMeshlets: a meshlet must fit at least one triangle");
+  }
+  _meshletVertices = maxVertices;
+  _meshletTriangles = maxTriangles;
+}
+
+std::span<const Meshlet> Mesh::getMeshlets() const { return _meshlets; }
+
+void Mesh::useCache(bool enabled) { _cacheEnabled = enabled; }
+
+void Mesh::useArena(bool enabled) { _arenaEnabled = enabled; }
+
+void Mesh::useNativeObj(bool enabled) { _nativeObj = enabled; }
+
+void Mesh::setVertexLayout(const VertexLayout& layout) {
+  bool hasPosition = false;
+  for (size_t i = 0; i < layout.order.size(); i++) {
+    const u8 attrib = layout.order[i];
+    if (attrib != POSITION && attrib != NORMAL && attrib != TEXCOORD && attrib != COLOR)
+      throw std::invalid_argument("setVertexLayout: unknown attribute in order");
+    if (std::find(layout.order.begin() + i + 1, layout.order.end(), attrib) != layout.order.end())
+      throw std::invalid_argument("setVertexLayout: duplicated attribute in order");
+    hasPosition |= attrib == POSITION;
+  }
+  if (layout.interleaved && !hasPosition)
+    throw std::invalid_argument("setVertexLayout: interleaved order must contain POSITION");
+  if (layout.stride < 0)
+    throw std::invalid_argument("setVertexLayout: stride must not be negative");
+  _layout = layout;
+}
+
+void Mesh::interleaveAttributes(std::vector<u8> order, GLsizei stride) {
+  VertexLayout layout = _layout;
+  layout.interleaved = true;
+  layout.order = std::move(order);
+  layout.stride = stride;
+  setVertexLayout(layout);
+}
+
+void Mesh::quantizeAttributes() {
+  _layout.quantized = true;
+}
+
+const math::mat4& Mesh::getDequantization() const { return _dequantization; }
+
+const Mesh::VertexLayout& Mesh::getVertexLayout() const { return _layout; }
+
 bool Mesh::hasNormals() { return _normalsLoaded; }
 
 bool Mesh::hasTexcoords() { return _texcoordsLoaded; }
 
+const Bounds& Mesh::getBounds() const { return _bounds; }
 
-////////////////////////////////////////////////////////////////////////////////
+std::span<const Bounds> Mesh::getSubmeshBounds() const { return _submeshBounds; }
+
+void Mesh::setResidency(Residency residency) {
+  _residency = residency;
+  if (VaoId) {
+    applyResidency();
+  }
+}
+
+Mesh::Residency Mesh::getResidency() const { return _residency; }
 
-void Mesh::processMesh(const aiMesh *mesh) {
-  MGL_DEBUG("Loading model");
-  _normalsLoaded = mesh->HasNormals();
-  _texcoordsLoaded = mesh->HasTextureCoords(0);
-  _colorsLoaded = mesh->HasVertexColors(0);
+namespace {
 
-  for (unsigned int i = 0; i < mesh->mNumVertices; i++) {
-    const aiVector3D &aiPosition = mesh->mVertices[i];
-    _positions.push_back(math::vec3(aiPosition.x, aiPosition.y, aiPosition.z));
-    if (_normalsLoaded) {
-      MGL_DEBUG("Model has normals");
-      const aiVector3D &aiNormal = mesh->mNormals[i];
-      _normals.push_back(math::vec3(aiNormal.x, aiNormal.y, aiNormal.z));
+  template <typename T>
+  void releaseVector(std::vector<T> &v) {
+    std::vector<T>().swap(v);
+  }
+
+  template <typename T>
+  size_t vectorBytes(const std::vector<T> &v) {
+    return v.capacity() * sizeof(T);
+  }
+
+  // Bounds of the vertices referenced by a submesh - submeshes may share
+  // vertices, so their vertex ranges are not reliable
+  Bounds submeshBounds(const MeshView &data, const Submesh &submesh) {
+    Bounds bounds;
+    const std::span<const ui32> indices = data.indices.subspan(submesh.baseIndex, submesh.n_indices);
+    const math::vec3 *positions = data.positions.data() + submesh.baseVertex;
+    for (ui32 index : indices) {
+      bounds.box.expand(positions[index]);
     }
-    if (_texcoordsLoaded) {
-      MGL_DEBUG("Model has texture coordinates");
-      const aiVector3D &aiTexcoord = mesh->mTextureCoords[0][i];
-      _texCoords.push_back(math::vec2(aiTexcoord.x, aiTexcoord.y));
+    if (bounds.box.empty()) {
+      return bounds;
     }
-    if (_colorsLoaded) {
-      MGL_DEBUG("Model has vertex colors");
-      const aiColor4D &aiColor = mesh->mColors[0][i];
-      _colors.push_back(
-          math::vec4(aiColor.r, aiColor.g, aiColor.b, aiColor.a));
+    bounds.sphere.center = bounds.box.center();
+    float radius2 = 0.0f;
+    for (ui32 index : indices) {
+      radius2 = std::max(radius2, (positions[index] - bounds.sphere.center).length2());
     }
+    bounds.sphere.radius = std::sqrt(radius2);
+    return bounds;
+  }
+
+} // namespace
+
+void Mesh::applyResidency() {
+  if (_residency == Residency::Full) {
+    return;
+  }
+  if (_residency == Residency::PositionsAndIndices && _mapping) {
+    _positions.assign(_mappedView.positions.begin(), _mappedView.positions.end());
+    _indices.assign(_mappedView.indices.begin(), _mappedView.indices.end());
+  } else if (_residency == Residency::Discard) {
+    releaseVector(_positions);
+    releaseVector(_indices);
+  }
+  releaseVector(_normals);
+  releaseVector(_texCoords);
+  releaseVector(_colors);
+  _mapping = file::MappedFile();
+  _mappedView = MeshView();
+}
+
+bool Mesh::reloadGeometry() {
+  if (_mapping || (_residency == Residency::Full && !_positions.empty())) {
+    return true;
+  }
+  if (_cacheKey == 0) {
+    MGL_WARN("Cannot reload mesh geometry: the mesh was not loaded through the mesh cache");
+    return false;
+  }
+  std::optional<MeshCache::Entry> cached = MeshCache::open(_cacheKey);
+  if (!cached) {
+    MGL_WARN("Cannot reload mesh geometry: mesh cache entry {} is missing",
+             MeshCache::entryPath(_cacheKey).string());
+    return false;
   }
-  for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-    const aiFace &face = mesh->mFaces[i];
-    _indices.push_back(face.mIndices[0]);
-    _indices.push_back(face.mIndices[1]);
-    _indices.push_back(face.mIndices[2]);
+  releaseVector(_positions);
+  releaseVector(_indices);
+  _mapping = std::move(cached->file);
+  _mappedView = cached->view;
+  return true;
+}
+
+void Mesh::releaseGeometry() { applyResidency(); }
+
+size_t Mesh::cpuBytes() const {
+  return vectorBytes(_positions) + vectorBytes(_indices) + vectorBytes(_normals) +
+         vectorBytes(_texCoords) + vectorBytes(_colors) + _mapping.size();
+}
+
+MeshView Mesh::view() const {
+  if (_mapping) {
+    return _mappedView;
   }
+  MeshView data;
+  data.positions = _positions;
+  data.indices = _indices;
+  if (_normalsLoaded) data.normals = _normals;
+  if (_texcoordsLoaded) data.texcoords = _texCoords;
+  if (_colorsLoaded) data.colors = _colors;
+  data.submeshes = _meshes;
+  data.lodSubmeshes = _lodMeshes;
+  data.lodErrors = _lodErrors;
+  data.meshlets = _meshlets;
+  return data;
 }
 
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+  static_assert(sizeof(aiVector3D) == sizeof(math::vec3) &&
+                sizeof(aiColor4D) == sizeof(math::vec4),
+                "Assimp vectors must match the engine vector layout");
+
+  // How an attribute is written into GPU memory
+  enum class Encoding { FLOAT, POSITION_UNORM16, NORMAL_SNORM10, TEXCOORD_HALF, COLOR_UNORM8 };
+
+  // GPU format of a vertex attribute
+  struct AttributeFormat {
+    GLint components;
+    GLenum type;
+    GLboolean normalized;
+    size_t size;
+    Encoding encoding;
+  };
+
+  AttributeFormat attributeFormat(u8 id, bool quantized) {
+    if (id == Mesh::POSITION)
+      return quantized ? AttributeFormat{ 3, GL_UNSIGNED_SHORT, GL_TRUE, VertexQuantizer::POSITION_SIZE, Encoding::POSITION_UNORM16 }
+                       : AttributeFormat{ 3, GL_FLOAT, GL_FALSE, sizeof(math::vec3), Encoding::FLOAT };
+    if (id == Mesh::NORMAL)
+      return quantized ? AttributeFormat{ 4, GL_INT_2_10_10_10_REV, GL_TRUE, VertexQuantizer::NORMAL_SIZE, Encoding::NORMAL_SNORM10 }
+                       : AttributeFormat{ 3, GL_FLOAT, GL_FALSE, sizeof(math::vec3), Encoding::FLOAT };
+    if (id == Mesh::TEXCOORD)
+      return quantized ? AttributeFormat{ 2, GL_HALF_FLOAT, GL_FALSE, VertexQuantizer::TEXCOORD_SIZE, Encoding::TEXCOORD_HALF }
+                       : AttributeFormat{ 2, GL_FLOAT, GL_FALSE, sizeof(math::vec2), Encoding::FLOAT };
+    return quantized ? AttributeFormat{ 4, GL_UNSIGNED_BYTE, GL_TRUE, VertexQuantizer::COLOR_SIZE, Encoding::COLOR_UNORM8 }
+                     : AttributeFormat{ 4, GL_FLOAT, GL_FALSE, sizeof(math::vec4), Encoding::FLOAT };
+  }
+
+  void setAttributePointer(u8 id, const AttributeFormat &format, size_t stride, size_t offset) {
+    glEnableVertexAttribArray(id);
+    glVertexAttribPointer(id, format.components, format.type, format.normalized,
+                          static_cast<GLsizei>(stride), reinterpret_cast<void *>(offset));
+  }
+
+  // Destination of one vertex attribute: address of vertex 0 and distance
+  // between consecutive vertices (the attribute size when stored in its own
+  // buffer, the vertex size when interleaved). A null dst skips the attribute.
+  struct AttributeTarget {
+    std::byte *dst = nullptr;
+    size_t stride = 0;
+    size_t size = 0;
+    Encoding encoding = Encoding::FLOAT;
+    const VertexQuantizer *quantizer = nullptr;
+  };
+
+  struct VertexTargets {
+    AttributeTarget position, normal, texcoord, color;
+  };
+
+  AttributeTarget packedTarget(void *data, size_t size) {
+    return { static_cast<std::byte *>(data), size, size };
+  }
+
+  AttributeTarget gpuTarget(std::byte *dst, size_t stride, const AttributeFormat &format,
+                            const VertexQuantizer *quantizer) {
+    return { dst, stride, format.size, format.encoding, quantizer };
+  }
+
+  template <typename Encode>
+  void encodeEach(std::byte *dst, size_t stride, const std::byte *src, size_t srcStride,
+                  size_t count, Encode encode) {
+    for (size_t i = 0; i < count; i++) {
+      encode(reinterpret_cast<const float *>(src + i * srcStride), dst + i * stride);
+    }
+  }
+
+  // Writes count float attributes from a strided source, encoding them as
+  // the target requires. Plain floats are copied with a single memcpy when
+  // both sides are tightly packed. A null src zero-fills instead.
+  void writeAttribute(const AttributeTarget &target, size_t first, const void *src,
+                      size_t srcStride, size_t count) {
+    if (!target.dst) return;
+    std::byte *dst = target.dst + first * target.stride;
+    const std::byte *in = static_cast<const std::byte *>(src);
+    const size_t size = target.size;
+
+    if (!in) {
+      for (size_t i = 0; i < count; i++)
+        std::memset(dst + i * target.stride, 0, size);
+      return;
+    }
+
+    const VertexQuantizer *q = target.quantizer; // only set for quantized targets
+    switch (target.encoding) {
+    case Encoding::FLOAT:
+      if (target.stride == size && srcStride == size) {
+        std::memcpy(dst, in, size * count);
+      } else {
+        for (size_t i = 0; i < count; i++)
+          std::memcpy(dst + i * target.stride, in + i * srcStride, size);
+      }
+      break;
+    case Encoding::POSITION_UNORM16:
+      encodeEach(dst, target.stride, in, srcStride, count, [q](const float *v, std::byte *out) {
+        u16 packed[4];
+        q->position(math::vec3(v[0], v[1], v[2]), packed);
+        std::memcpy(out, packed, sizeof(packed));
+      });
+      break;
+    case Encoding::NORMAL_SNORM10:
+      encodeEach(dst, target.stride, in, srcStride, count, [q](const float *v, std::byte *out) {
+        const ui32 packed = q->normal(math::vec3(v[0], v[1], v[2]));
+        std::memcpy(out, &packed, sizeof(packed));
+      });
+      break;
+    case Encoding::TEXCOORD_HALF:
+      encodeEach(dst, target.stride, in, srcStride, count, [](const float *v, std::byte *out) {
+        const u16 packed[2] = { VertexQuantizer::toHalf(v[0]), VertexQuantizer::toHalf(v[1]) };
+        std::memcpy(out, packed, sizeof(packed));
+      });
+      break;
+    case Encoding::COLOR_UNORM8:
+      encodeEach(dst, target.stride, in, srcStride, count, [](const float *v, std::byte *out) {
+        u8 packed[4];
+        VertexQuantizer::color(math::vec4(v[0], v[1], v[2], v[3]), packed);
+        std::memcpy(out, packed, sizeof(packed));
+      });
+      break;
+    }
+  }
+
+  template <typename Index>
+  void writeFaces(const aiMesh *mesh, Index *dst) {
+    for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
+      const aiFace &face = mesh->mFaces[i];
+      dst[0] = static_cast<Index>(face.mIndices[0]);
+      dst[1] = static_cast<Index>(face.mIndices[1]);
+      dst[2] = static_cast<Index>(face.mIndices[2]);
+      dst += 3;
+    }
+  }
+
+  // Writes count indices as 16 or 32-bit values
+  void writeIndices(std::byte *dst, GLenum type, const ui32 *src, size_t count) {
+    if (type == GL_UNSIGNED_INT) {
+      std::memcpy(dst, src, count * sizeof(ui32));
+      return;
+    }
+    u16 *out = reinterpret_cast<u16 *>(dst);
+    for (size_t i = 0; i < count; i++) {
+      out[i] = static_cast<u16>(src[i]);
+    }
+  }
+
+  // Writes a single aiMesh into its submesh range of the destination buffers.
+  // Its indices go to 'indices', as 16 or 32-bit values depending on indexType.
+  void writeMesh(const aiMesh *mesh, const Submesh &submesh, const VertexTargets &targets,
+                 std::byte *indices, GLenum indexType) {
+    const size_t n = mesh->mNumVertices;
+    writeAttribute(targets.position, submesh.baseVertex, mesh->mVertices, sizeof(aiVector3D), n);
+    writeAttribute(targets.normal, submesh.baseVertex, mesh->mNormals, sizeof(aiVector3D), n);
+    // Assimp keeps UVs as 3D vectors - only u, v are used
+    writeAttribute(targets.texcoord, submesh.baseVertex, mesh->mTextureCoords[0], sizeof(aiVector3D), n);
+    writeAttribute(targets.color, submesh.baseVertex, mesh->mColors[0], sizeof(aiColor4D), n);
+
+    if (indexType == GL_UNSIGNED_SHORT) {
+      writeFaces(mesh, reinterpret_cast<u16 *>(indices));
+    } else {
+      writeFaces(mesh, reinterpret_cast<ui32 *>(indices));
+    }
+  }
+
+  struct PackedAttribute {
+    u8 id;
+    AttributeFormat format;
+    size_t offset;
+  };
+
+  // Attributes of an interleaved vertex, in layout order, skipping the
+  // attributes the mesh does not have. Returns the packed vertex size.
+  size_t packAttributes(const Mesh::VertexLayout &layout, bool normals, bool texcoords,
+                        bool colors, std::vector<PackedAttribute> &attributes) {
+    size_t packedSize = 0;
+    for (u8 id : layout.order) {
+      if ((id == Mesh::NORMAL && !normals) || (id == Mesh::TEXCOORD && !texcoords) ||
+          (id == Mesh::COLOR && !colors)) {
+        continue; // attribute not loaded for this mesh
+      }
+      const AttributeFormat format = attributeFormat(id, layout.quantized);
+      attributes.push_back({ id, format, packedSize });
+      packedSize += format.size;
+    }
+    return packedSize;
+  }
+
+  // Writes every vertex of data into an interleaved destination
+  void packVertices(std::byte *vertices, size_t stride, const std::vector<PackedAttribute> &attributes,
+                    const MeshView &data, const VertexQuantizer *quantizer) {
+    for (const PackedAttribute &attr : attributes) {
+      const void *src;
+      size_t srcSize;
+      if (attr.id == Mesh::POSITION)      { src = data.positions.data(); srcSize = sizeof(math::vec3); }
+      else if (attr.id == Mesh::NORMAL)   { src = data.normals.data();   srcSize = sizeof(math::vec3); }
+      else if (attr.id == Mesh::TEXCOORD) { src = data.texcoords.data(); srcSize = sizeof(math::vec2); }
+      else                                { src = data.colors.data();    srcSize = sizeof(math::vec4); }
+      writeAttribute(gpuTarget(vertices + attr.offset, stride, attr.format, quantizer), 0,
+                     src, srcSize, data.positions.size());
+    }
+  }
+
+  // Allocates the currently bound buffer and maps it for a one-time fill.
+  // Empty buffers are not mapped (nullptr)
+  void *allocateMapped(GLenum target, size_t size) {
+    glBufferData(target, size, nullptr, GL_STATIC_DRAW);
+    if (size == 0) return nullptr;
+    return glMapBufferRange(target, 0, size,
+                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+  }
+
+  void unmapBuffer(GLenum target) {
+    // GL_FALSE means the store got corrupted (e.g. video mode change)
+    if (glUnmapBuffer(target) == GL_FALSE) {
+      MGL_ERROR("Vertex buffer contents were lost while mapped");
+      exit(EXIT_FAILURE);
+    }
+  }
+
+} // namespace
+
+// Fills the submesh table and attribute flags from an aiScene.
+// An attribute is loaded if any mesh has it; meshes without it get zeros.
 void Mesh::processScene(const aiScene *scene) {
   _meshes.resize(scene->mNumMeshes);
   unsigned int n_vertices = 0;
   unsigned int n_indices = 0;
+  _normalsLoaded = _texcoordsLoaded = _colorsLoaded = false;
 
   for (unsigned int i = 0; i < _meshes.size(); i++) {
-    _meshes[i].n_indices = scene->mMeshes[i]->mNumFaces * 3;
+    const aiMesh *mesh = scene->mMeshes[i];
+    _meshes[i].n_indices = mesh->mNumFaces * 3;
     _meshes[i].baseVertex = n_vertices;
     _meshes[i].baseIndex = n_indices;
 
-    n_vertices += scene->mMeshes[i]->mNumVertices;
+    n_vertices += mesh->mNumVertices;
     n_indices += _meshes[i].n_indices;
+    _normalsLoaded |= mesh->HasNormals();
+    _texcoordsLoaded |= mesh->HasTextureCoords(0);
+    _colorsLoaded |= mesh->HasVertexColors(0);
   }
 
-  _indices.reserve(n_indices);
-  _positions.reserve(n_vertices);
-  _normals.reserve(n_vertices);
-  _texCoords.reserve(n_vertices);
-  _colors.reserve(n_vertices);
+  MGL_DEBUG("Loaded {} mesh(es) [{} vertices, {} indices, {} triangles]",
+            _meshes.size(), n_vertices, n_indices, n_indices / 3);
+}
+
+void Mesh::processMeshes(const aiScene *scene) {
+  processScene(scene);
+  const size_t n_vertices = _meshes.empty() ? 0 :
+      _meshes.back().baseVertex + scene->mMeshes[_meshes.size() - 1]->mNumVertices;
+  const size_t n_indices = _meshes.empty() ? 0 :
+      _meshes.back().baseIndex + _meshes.back().n_indices;
+
+  // Sized once from the scene totals, then filled with bulk copies
+  _positions.resize(n_vertices);
+  _normals.resize(_normalsLoaded ? n_vertices : 0);
+  _texCoords.resize(_texcoordsLoaded ? n_vertices : 0);
+  _colors.resize(_colorsLoaded ? n_vertices : 0);
+  _indices.resize(n_indices);
+
+  VertexTargets targets;
+  targets.position = packedTarget(_positions.data(), sizeof(math::vec3));
+  if (_normalsLoaded) targets.normal = packedTarget(_normals.data(), sizeof(math::vec3));
+  if (_texcoordsLoaded) targets.texcoord = packedTarget(_texCoords.data(), sizeof(math::vec2));
+  if (_colorsLoaded) targets.color = packedTarget(_colors.data(), sizeof(math::vec4));
 
   for (unsigned int i = 0; i < _meshes.size(); i++) {
-    processMesh(scene->mMeshes[i]);
+    writeMesh(scene->mMeshes[i], _meshes[i], targets,
+              reinterpret_cast<std::byte *>(_indices.data() + _meshes[i].baseIndex), GL_UNSIGNED_INT);
   }
+}
 
+void Mesh::optimizeGeometry(const std::string &filename) {
+  float missesBefore = 0.0f, missesAfter = 0.0f;
+  size_t triangles = 0;
 
-  MGL_DEBUG("Loaded {} mesh(es) [{} vertices, {} indices, {} triangles]",
-            _meshes.size(), n_vertices, n_indices, n_indices / 3);
+  // Reordering the vertices of one submesh would scramble any other that
+  // shares them, so vertex fetch only runs on disjoint vertex ranges
+  std::vector<std::pair<size_t, size_t>> ranges;
+  for (const Submesh &submesh : _meshes) {
+    ranges.emplace_back(submesh.baseVertex, submesh.baseVertex + submeshVertexCount(submesh));
+  }
+  std::sort(ranges.begin(), ranges.end());
+  bool disjoint = true;
+  for (size_t r = 1; r < ranges.size(); r++) {
+    disjoint &= ranges[r].first >= ranges[r - 1].second;
+  }
+  if (!disjoint && (_optimizations & MeshOptimizer::VERTEX_FETCH)) {
+    MGL_WARN("Skipping vertex fetch optimization of [{}]: submeshes share vertices", filename);
+  }
+
+  for (const Submesh &submesh : _meshes) {
+    const size_t vertexCount = submeshVertexCount(submesh);
+    const std::span<ui32> indices(_indices.data() + submesh.baseIndex, submesh.n_indices);
+    const std::span<math::vec3> positions(_positions.data() + submesh.baseVertex, vertexCount);
+    const size_t submeshTriangles = indices.size() / 3;
+
+    missesBefore += MeshOptimizer::acmr(indices, vertexCount) * submeshTriangles;
+    if (_optimizations & MeshOptimizer::VERTEX_CACHE) {
+      MeshOptimizer::optimizeVertexCache(indices, vertexCount);
+    }
+    if (_optimizations & MeshOptimizer::OVERDRAW) {
+      MeshOptimizer::optimizeOverdraw(indices, positions);
+    }
+    if (disjoint && (_optimizations & MeshOptimizer::VERTEX_FETCH)) {
+      const std::vector<ui32> remap = MeshOptimizer::optimizeVertexFetch(indices, vertexCount);
+      MeshOptimizer::remapVertices(positions, std::span<const ui32>(remap));
+      if (_normalsLoaded)
+        MeshOptimizer::remapVertices(std::span(_normals).subspan(submesh.baseVertex, vertexCount),
+                                     std::span<const ui32>(remap));
+      if (_texcoordsLoaded)
+        MeshOptimizer::remapVertices(std::span(_texCoords).subspan(submesh.baseVertex, vertexCount),
+                                     std::span<const ui32>(remap));
+      if (_colorsLoaded)
+        MeshOptimizer::remapVertices(std::span(_colors).subspan(submesh.baseVertex, vertexCount),
+                                     std::span<const ui32>(remap));
+    }
+    missesAfter += MeshOptimizer::acmr(indices, vertexCount) * submeshTriangles;
+    triangles += submeshTriangles;
+  }
+
+  if (triangles > 0) {
+    MGL_INFO("Optimized [{}]: ACMR {:.3f} -> {:.3f}", filename,
+             missesBefore / triangles, missesAfter / triangles);
+  }
+}
+
+void Mesh::clusterGeometry(const std::string &name) {
+  _meshlets.clear();
+  for (size_t s = 0; s < _meshes.size(); s++) {
+    const Submesh &submesh = _meshes[s];
+    std::vector<Meshlet> meshlets = Meshlets::build(
+        std::span<ui32>(_indices.data() + submesh.baseIndex, submesh.n_indices),
+        std::span<const math::vec3>(_positions).subspan(submesh.baseVertex, submeshVertexCount(submesh)),
+        _meshletVertices, _meshletTriangles);
+    for (Meshlet &meshlet : meshlets) {
+      meshlet.baseIndex += submesh.baseIndex;
+      meshlet.submesh = static_cast<unsigned int>(s);
+    }
+    _meshlets.insert(_meshlets.end(), meshlets.begin(), meshlets.end());
+  }
+  MGL_INFO("Split [{}] into {} meshlet(s)", name, _meshlets.size());
+}
+
+size_t Mesh::submeshVertexCount(const Submesh &submesh) const {
+  const auto indices = std::span<const ui32>(_indices).subspan(submesh.baseIndex, submesh.n_indices);
+  return indices.empty() ? 0 : size_t(*std::max_element(indices.begin(), indices.end())) + 1;
+}
+
+void Mesh::buildLods(const std::string &name) {
+  _lodMeshes.clear();
+  _lodErrors.clear();
+
+  // Every LOD simplifies the previous one, so their errors add up
+  std::vector<Submesh> previous = _meshes;
+  size_t previousIndices = _indices.size();
+  float error = 0.0f;
+
+  for (unsigned level = 1; level <= _lodLevels; level++) {
+    const size_t levelBase = _indices.size();
+    std::vector<Submesh> lod(_meshes.size());
+    float levelError = 0.0f;
+
+    for (size_t s = 0; s < _meshes.size(); s++) {
+      const Submesh &submesh = _meshes[s];
+      const size_t vertexCount = submeshVertexCount(submesh);
+      auto vertices = [&]<typename T>(const std::vector<T> &attribute, bool loaded) {
+        return loaded ? std::span<const T>(attribute).subspan(submesh.baseVertex, vertexCount)
+                      : std::span<const T>();
+      };
+
+      const size_t target = static_cast<size_t>(previous[s].n_indices * _lodReduction) / 3 * 3;
+      float submeshError = 0.0f;
+      std::vector<ui32> indices = MeshSimplifier::simplify(
+          std::span<const ui32>(_indices.data() + previous[s].baseIndex, previous[s].n_indices),
+          vertices(_positions, true), vertices(_normals, _normalsLoaded),
+          vertices(_texCoords, _texcoordsLoaded), target, &submeshError);
+      if (_optimizations & MeshOptimizer::VERTEX_CACHE) {
+        MeshOptimizer::optimizeVertexCache(indices, vertexCount);
+      }
+
+      lod[s] = { static_cast<unsigned int>(indices.size()), static_cast<unsigned int>(_indices.size()),
+                 submesh.baseVertex };
+      _indices.insert(_indices.end(), indices.begin(), indices.end());
+      levelError = std::max(levelError, submeshError);
+    }
+
+    // Locked borders and seams eventually stop simplification - drop LODs
+    // that would barely save anything
+    const size_t levelIndices = _indices.size() - levelBase;
+    if (levelIndices * 10 > previousIndices * 9) {
+      _indices.resize(levelBase);
+      break;
+    }
+    error += levelError;
+    _lodMeshes.insert(_lodMeshes.end(), lod.begin(), lod.end());
+    _lodErrors.push_back(error);
+    previous = std::move(lod);
+    previousIndices = levelIndices;
+  }
+
+  if (!_lodErrors.empty()) {
+    MGL_INFO("Generated {} LOD(s) for [{}]: {} -> {} triangles", _lodErrors.size(), name,
+             _meshes.empty() ? 0 : (_meshes.back().baseIndex + _meshes.back().n_indices) / 3,
+             previousIndices / 3);
+  }
+}
+
+void Mesh::streamScene(const aiScene *scene) {
+  processScene(scene);
+  const size_t n_vertices = _meshes.empty() ? 0 :
+      _meshes.back().baseVertex + scene->mMeshes[_meshes.size() - 1]->mNumVertices;
+
+  destroyBufferObjects();
+  glGenVertexArrays(1, &VaoId);
+  glBindVertexArray(VaoId);
+  glGenBuffers(6, BufferIds);
+
+  // Bounds come first - quantization needs those of the whole scene up front
+  _submeshBounds.resize(_meshes.size());
+  for (unsigned int m = 0; m < _meshes.size(); m++) {
+    const aiMesh *mesh = scene->mMeshes[m];
+    _submeshBounds[m] = Bounds::fromPoints(
+        std::span(reinterpret_cast<const math::vec3 *>(mesh->mVertices), mesh->mNumVertices));
+  }
+  _bounds = Bounds::merge(_submeshBounds);
+
+  std::optional<VertexQuantizer> quantizer;
+  if (_layout.quantized) {
+    quantizer.emplace(_bounds.box.min, _bounds.box.max);
+    _dequantization = quantizer->dequantization();
+  } else {
+    _dequantization = math::mat4::identity();
+  }
+  const VertexQuantizer *q = quantizer ? &*quantizer : nullptr;
+
+  // Size every buffer from the scene totals and map it, so Assimp's arrays
+  // are written straight into GPU-visible memory with no CPU-side copy
+  VertexTargets targets;
+  std::vector<GLuint> mapped;
+  auto targetOf = [&targets](u8 id) -> AttributeTarget & {
+    return id == POSITION ? targets.position : id == NORMAL ? targets.normal
+         : id == TEXCOORD ? targets.texcoord : targets.color;
+  };
+  if (_layout.interleaved) {
+    std::vector<PackedAttribute> attributes;
+    const size_t packedSize = packAttributes(_layout, _normalsLoaded, _texcoordsLoaded,
+                                             _colorsLoaded, attributes);
+    const size_t stride = std::max(packedSize, static_cast<size_t>(_layout.stride));
+
+    glBindBuffer(GL_ARRAY_BUFFER, BufferIds[POSITION]);
+    std::byte *vertices = static_cast<std::byte *>(allocateMapped(GL_ARRAY_BUFFER, stride * n_vertices));
+    mapped.push_back(BufferIds[POSITION]);
+    if (stride != packedSize || _layout.quantized) std::memset(vertices, 0, stride * n_vertices);
+    for (const PackedAttribute &attr : attributes) {
+      targetOf(attr.id) = gpuTarget(vertices + attr.offset, stride, attr.format, q);
+      setAttributePointer(attr.id, attr.format, stride, attr.offset);
+    }
+  } else {
+    auto mapAttribute = [&](u8 id) {
+      const AttributeFormat format = attributeFormat(id, _layout.quantized);
+      glBindBuffer(GL_ARRAY_BUFFER, BufferIds[id]);
+      std::byte *data = static_cast<std::byte *>(allocateMapped(GL_ARRAY_BUFFER, format.size * n_vertices));
+      targetOf(id) = gpuTarget(data, format.size, format, q);
+      mapped.push_back(BufferIds[id]);
+      setAttributePointer(id, format, 0, 0);
+    };
+    mapAttribute(POSITION);
+    if (_normalsLoaded) mapAttribute(NORMAL);
+    if (_texcoordsLoaded) mapAttribute(TEXCOORD);
+    if (_colorsLoaded) mapAttribute(COLOR);
+  }
+
+  // Indices of a submesh never exceed its vertex count
+  std::vector<ui32> maxIndex(_meshes.size());
+  for (unsigned int i = 0; i < _meshes.size(); i++) {
+    maxIndex[i] = std::max(scene->mMeshes[i]->mNumVertices, 1u) - 1;
+  }
+  const size_t indexBytes = planDraws(_meshes, maxIndex);
+
+  glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, BufferIds[INDEX]);
+  std::byte *indices = static_cast<std::byte *>(allocateMapped(GL_ELEMENT_ARRAY_BUFFER, indexBytes));
+
+  for (unsigned int i = 0; i < _meshes.size(); i++) {
+    writeMesh(scene->mMeshes[i], _meshes[i], targets, indices + _draws[i].offset, _draws[i].type);
+  }
+
+  if (indices) unmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+  for (GLuint buffer : mapped) {
+    glBindBuffer(GL_ARRAY_BUFFER, buffer);
+    unmapBuffer(GL_ARRAY_BUFFER);
+  }
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  createIndirectBuffer();
 }
 
-void Mesh::createFromFile(const std::string &filename) {
+void Mesh::createFromFile(const std::string &filename, u64 cacheKey) {
+  if (!_cacheEnabled && !_arenaEnabled && _optimizations == 0 && _lodLevels == 0 && _meshletVertices == 0 &&
+      !usesNativeObj(filename)) {
+    // Nothing needs a CPU copy - stream Assimp's arrays into the GPU buffers
+    Assimp::Importer importer;
+    const aiScene *scene = importScene(filename, importer);
+    if (!scene) {
+      exit(EXIT_FAILURE);
+    }
+    streamScene(scene);
+    return;
+  }
   Assimp::Importer importer;
-  const aiScene *scene = importer.ReadFile(
-      file::resource_path(filename).string(), AssimpFlags);
-  if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||
-      !scene->mRootNode) {
-    MGL_ERROR("Error while loading: {}", importer.GetErrorString());
+  if (!load(filename, importer, cacheKey)) {
     exit(EXIT_FAILURE);
   }
+  upload();
+}
 
+const aiScene *Mesh::importScene(const std::string &filename, Assimp::Importer &importer) {
+  // resources are read through the VFS - the importer owns the handler
+  if (!dynamic_cast<util::AssimpIO *>(importer.GetIOHandler())) {
+    importer.SetIOHandler(new util::AssimpIO());
+  }
+  const aiScene *scene = importer.ReadFile(filename, AssimpFlags);
+  if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||
+      !scene->mRootNode) {
+    MGL_ERROR("Error while loading [{}]: {}", filename, importer.GetErrorString());
+    return nullptr;
+  }
   MGL_DEBUG("Processing [{}]", filename);
+  return scene;
+}
 
-  processScene(scene);
-  createBufferObjects();
+bool Mesh::usesNativeObj(const std::string &filename) const {
+  constexpr unsigned int supported = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_FlipUVs |
+                                     aiProcess_GenNormals | aiProcess_GenSmoothNormals;
+  std::string extension = std::filesystem::path(filename).extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(),
+                 [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return _nativeObj && extension == ".obj" && (AssimpFlags & ~supported) == 0;
+}
+
+/*
+  Faces are always welded on their (v, vt, vn) indices, whether or not
+  JoinIdenticalVertices is set. Normals are never generated: files without
+  them go through Assimp when the flags ask for them
+*/
+bool Mesh::importObj(const std::string &filename) {
+  if (!usesNativeObj(filename)) return false;
+  ObjLoader::Options options;
+  options.flipUVs = (AssimpFlags & aiProcess_FlipUVs) != 0;
+  std::optional<ObjLoader::Model> model = ObjLoader::load(filename, options);
+  if (!model) {
+    MGL_WARN("Falling back to Assimp for [{}]", filename);
+    return false;
+  }
+  MeshData &data = model->mesh;
+  if (data.normals.empty() && (AssimpFlags & (aiProcess_GenNormals | aiProcess_GenSmoothNormals))) {
+    return false;
+  }
+
+  _meshes = std::move(data.submeshes);
+  _positions = std::move(data.positions);
+  _normals = std::move(data.normals);
+  _texCoords = std::move(data.texcoords);
+  _colors = std::move(data.colors);
+  _indices = std::move(data.indices);
+  _normalsLoaded = !_normals.empty();
+  _texcoordsLoaded = !_texCoords.empty();
+  _colorsLoaded = !_colors.empty();
+  MGL_DEBUG("Parsed [{}] natively: {} mesh(es) [{} vertices, {} indices, {} triangles]", filename,
+            _meshes.size(), _positions.size(), _indices.size(), _indices.size() / 3);
+  return true;
+}
+
+bool Mesh::load(const std::string &filename) {
+  Assimp::Importer importer;
+  return load(filename, importer);
+}
+
+bool Mesh::load(const std::string &filename, Assimp::Importer &importer, u64 cacheKey) {
+  // Same file content & import flags -> keep the cache mapping for upload()
+  if (!_cacheEnabled) {
+    cacheKey = 0;
+  } else if (cacheKey == 0) {
+    cacheKey = this->cacheKey(filename);
+  }
+  if (cacheKey != 0) {
+    if (std::optional<MeshCache::Entry> cached = MeshCache::open(cacheKey)) {
+      MGL_DEBUG("Loading [{}] from mesh cache", filename);
+      _meshes.assign(cached->view.submeshes.begin(), cached->view.submeshes.end());
+      _lodMeshes.assign(cached->view.lodSubmeshes.begin(), cached->view.lodSubmeshes.end());
+      _lodErrors.assign(cached->view.lodErrors.begin(), cached->view.lodErrors.end());
+      _meshlets.assign(cached->view.meshlets.begin(), cached->view.meshlets.end());
+      _normalsLoaded = !cached->view.normals.empty();
+      _texcoordsLoaded = !cached->view.texcoords.empty();
+      _colorsLoaded = !cached->view.colors.empty();
+      _cacheKey = cacheKey;
+      _mapping = std::move(cached->file);
+      _mappedView = cached->view;
+      return true;
+    }
+  }
+
+  if (!importObj(filename)) {
+    const aiScene *scene = importScene(filename, importer);
+    if (!scene) {
+      return false;
+    }
+    processMeshes(scene);
+    importer.FreeScene();
+  }
+  if (_optimizations != 0) {
+    optimizeGeometry(filename);
+  }
+  if (_meshletVertices > 0) {
+    clusterGeometry(filename);
+  }
+  if (_lodLevels > 0) {
+    buildLods(filename);
+  }
+  if (cacheKey != 0) {
+    if (MeshCache::store(cacheKey, view())) {
+      _cacheKey = cacheKey;
+    } else {
+      MGL_WARN("Could not cache mesh [{}]", filename);
+    }
+  }
+  return true;
+}
+
+void Mesh::upload() {
+  createBufferObjects(view());
+  applyResidency();
+}
+
+u64 Mesh::processingOptions() const {
+  u64 options = util::hashCombine(_optimizations, _lodLevels);
+  options = util::hashCombine(options, std::bit_cast<ui32>(_lodReduction));
+  options = util::hashCombine(options, (u64(_meshletVertices) << 32) | _meshletTriangles);
+  return util::hashCombine(options, _nativeObj);
+}
+
+u64 Mesh::uploadOptions() const {
+  u64 options = util::hash64(_layout.order.data(), _layout.order.size());
+  options = util::hashCombine(options, (u64(_layout.stride) << 8) | (u64(_layout.interleaved) << 1) |
+                                           u64(_layout.quantized));
+  return util::hashCombine(options, (u64(_arenaEnabled) << 8) | static_cast<u64>(_residency));
+}
+
+u64 Mesh::cacheKey(const std::string &filename) const {
+  const file::Resource source = file::vfs().open(filename);
+  if (!source) return 0;
+  return MeshCache::makeKey(source.bytes(), AssimpFlags, processingOptions());
+}
+
+u64 Mesh::contentKey(const std::string &filename) const {
+  return contentKeyOf(cacheKey(filename));
+}
+
+u64 Mesh::contentKeyOf(u64 cacheKey) const {
+  return cacheKey != 0 ? util::hashCombine(cacheKey, uploadOptions()) : 0;
+}
+
+u64 Mesh::contentKey(const MeshData &data) const {
+  u64 key = util::HASH_SEED;
+  auto add = [&key](const auto &attribute) {
+    key = util::hashCombine(key, attribute.size());
+    key = util::hash64(attribute.data(), attribute.size() * sizeof(attribute[0]), key);
+  };
+  add(data.positions);
+  add(data.normals);
+  add(data.texcoords);
+  add(data.colors);
+  add(data.indices);
+  for (const Submesh &submesh : data.submeshes) {
+    key = util::hashCombine(key, (u64(submesh.baseVertex) << 32) | submesh.baseIndex);
+    key = util::hashCombine(key, submesh.n_indices);
+  }
+  // LODs and meshlets are built from the data too
+  key = util::hashCombine(key, processingOptions());
+  return util::hashCombine(key, uploadOptions());
+}
+
+size_t Mesh::gpuBytes() const {
+  auto bufferBytes = [](GLuint buffer) -> size_t {
+    if (!buffer) return 0;
+    GLint size = 0;
+    glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+    glGetBufferParameteriv(GL_COPY_READ_BUFFER, GL_BUFFER_SIZE, &size);
+    return static_cast<size_t>(size);
+  };
+  size_t bytes = 0;
+  for (GLuint buffer : BufferIds) bytes += bufferBytes(buffer);
+  bytes += bufferBytes(_skinBuffer) + bufferBytes(_indirectBuffer);
+  glBindBuffer(GL_COPY_READ_BUFFER, 0);
+  if (_arena) {
+    bytes += _arenaPlacement.vertexCount * _arena->getFormat().stride + _arenaPlacement.indexBytes;
+  }
+  return bytes;
 }
 
 
   void Mesh::createFromData(MeshData data) {
+      loadData(std::move(data));
+      upload();
+  }
+
+  void Mesh::loadData(MeshData data) {
       // --- Basic validation ---
       const ui32 positionCount = static_cast<ui32>(data.positions.size());
       if (positionCount == 0) throw std::invalid_argument("createFromData: positions is empty");
 
       const ui32 indicesCount = static_cast<ui32>(data.indices.size());
-      if (indicesCount > 0) {
+      if (data.submeshes.empty()) {
           for (unsigned int idx : data.indices)
               if (idx >= positionCount)
                   throw std::out_of_range("createFromData: index out of range");
       }
+      for (const Submesh& submesh : data.submeshes) {
+          if (static_cast<size_t>(submesh.baseIndex) + submesh.n_indices > indicesCount)
+              throw std::out_of_range("createFromData: submesh indices out of range");
+          for (ui32 i = 0; i < submesh.n_indices; i++)
+              if (static_cast<size_t>(submesh.baseVertex) + data.indices[submesh.baseIndex + i] >= positionCount)
+                  throw std::out_of_range("createFromData: index out of range");
+      }
 
       const ui32 normalsCount = static_cast<ui32>(data.normals.size());
       const ui32 texcoordsCount = static_cast<ui32>(data.texcoords.size());
@@ -199,69 +1088,218 @@ void Mesh::createFromFile(const std::string &filename) {
           _colorsLoaded = false;
       }
 
-      // --- Single-submesh layout ---
-      _meshes.resize(1);
-      _meshes[0].n_indices   = static_cast<unsigned int>(_indices.size());
-      _meshes[0].baseIndex  = 0;
-      _meshes[0].baseVertex = 0;
+      // --- Submesh layout (single submesh unless provided) ---
+      if (!data.submeshes.empty()) {
+          _meshes = std::move(data.submeshes);
+      } else {
+          _meshes.resize(1);
+          _meshes[0].n_indices   = static_cast<unsigned int>(_indices.size());
+          _meshes[0].baseIndex  = 0;
+          _meshes[0].baseVertex = 0;
+      }
 
-      // --- GPU upload ---
-      createBufferObjects();
+      _lodMeshes.clear();
+      _lodErrors.clear();
+      _meshlets.clear();
+      if (_meshletVertices > 0) {
+          clusterGeometry("mesh data");
+      }
+      if (_lodLevels > 0) {
+          buildLods("mesh data");
+      }
   }
 
 
-void Mesh::createBufferObjects() {
+void Mesh::createBufferObjects(const MeshView &data) {
   // Ensure previous buffers are cleared before creating new ones
   destroyBufferObjects();
 
-  glGenVertexArrays(1, &VaoId);
-  glBindVertexArray(VaoId);
-  {
-    glGenBuffers(6, BufferIds);
+  updateBounds(data);
 
-    // Position is always needed
-    glBindBuffer(GL_ARRAY_BUFFER, BufferIds[POSITION]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_positions[0]) * _positions.size(),
-                 &_positions[0], GL_STATIC_DRAW);
-    glEnableVertexAttribArray(POSITION);
-    glVertexAttribPointer(POSITION, 3, GL_FLOAT, GL_FALSE, 0, 0);
+  std::optional<VertexQuantizer> quantizer;
+  if (_layout.quantized) {
+    quantizer = VertexQuantizer::fromPositions(data.positions);
+    _dequantization = quantizer->dequantization();
+  } else {
+    _dequantization = math::mat4::identity();
+  }
+  const VertexQuantizer *q = quantizer ? &*quantizer : nullptr;
 
+  // Indexing is always used as well, as narrow as each submesh allows.
+  // LOD ranges follow the full-detail ones in the same index buffer
+  std::vector<Submesh> ranges(data.submeshes.begin(), data.submeshes.end());
+  ranges.insert(ranges.end(), data.lodSubmeshes.begin(), data.lodSubmeshes.end());
+  std::vector<ui32> maxIndex(ranges.size(), 0);
+  for (size_t s = 0; s < ranges.size(); s++) {
+    const Submesh &submesh = ranges[s];
+    const auto first = data.indices.begin() + submesh.baseIndex;
+    if (submesh.n_indices > 0)
+      maxIndex[s] = *std::max_element(first, first + submesh.n_indices);
+  }
+  const size_t indexBytes = planDraws(ranges, maxIndex);
+  auto writeRanges = [&](std::byte *indices) {
+    for (size_t s = 0; s < ranges.size(); s++) {
+      const Submesh &submesh = ranges[s];
+      writeIndices(indices + _draws[s].offset, _draws[s].type,
+                   data.indices.data() + submesh.baseIndex, submesh.n_indices);
+    }
+  };
 
+  if (_arenaEnabled) {
+    createArenaRange(data, q, indexBytes);
+    std::byte *indices = _arena->mapIndices(_arenaRange);
+    if (indices) writeRanges(indices);
+    _arena->unmap();
+    // from here on, draws address the shared buffers
+    for (DrawRange &draw : _draws) {
+      draw.offset += _arenaPlacement.indexOffset;
+      draw.baseVertex += static_cast<GLint>(_arenaPlacement.firstVertex);
+    }
+  } else {
+    glGenVertexArrays(1, &VaoId);
+    glBindVertexArray(VaoId);
+    {
+      glGenBuffers(6, BufferIds);
+      createVertexBuffers(data, q);
 
-    // Optional attributes
-    if (_normalsLoaded) {
-      glBindBuffer(GL_ARRAY_BUFFER, BufferIds[NORMAL]);
-      glBufferData(GL_ARRAY_BUFFER, sizeof(_normals[0]) * _normals.size(),
-                   &_normals[0], GL_STATIC_DRAW);
-      glEnableVertexAttribArray(NORMAL);
-      glVertexAttribPointer(NORMAL, 3, GL_FLOAT, GL_FALSE, 0, 0);
+      glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, BufferIds[INDEX]);
+      std::byte *indices = static_cast<std::byte *>(allocateMapped(GL_ELEMENT_ARRAY_BUFFER, indexBytes));
+      if (indices) {
+        writeRanges(indices);
+        unmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+      }
     }
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+  }
+
+  // Meshlets are sub-ranges of their submesh's draw
+  _meshletDraws.clear();
+  for (const Meshlet &meshlet : data.meshlets) {
+    const DrawRange &draw = _draws[meshlet.submesh];
+    const size_t indexSize = draw.type == GL_UNSIGNED_SHORT ? sizeof(u16) : sizeof(ui32);
+    const size_t first = meshlet.baseIndex - data.submeshes[meshlet.submesh].baseIndex;
+    _meshletDraws.push_back({ draw.type, draw.offset + first * indexSize,
+                              static_cast<GLsizei>(meshlet.n_indices), draw.baseVertex });
+  }
+  _culled = false;
+  createIndirectBuffer();
+}
+
+void Mesh::updateBounds(const MeshView &data) {
+  _submeshBounds.resize(data.submeshes.size());
+  for (size_t s = 0; s < data.submeshes.size(); s++) {
+    _submeshBounds[s] = submeshBounds(data, data.submeshes[s]);
+  }
+  _bounds = Bounds::merge(_submeshBounds);
+}
+
+GLuint Mesh::getVertexArray() const { return _arena ? _arena->getVao() : VaoId; }
 
-    if (_texcoordsLoaded) {
-      glBindBuffer(GL_ARRAY_BUFFER, BufferIds[TEXCOORD]);
-      glBufferData(GL_ARRAY_BUFFER, sizeof(_texCoords[0]) * _texCoords.size(),
-                   &_texCoords[0], GL_STATIC_DRAW);
-      glEnableVertexAttribArray(TEXCOORD);
-      glVertexAttribPointer(TEXCOORD, 2, GL_FLOAT, GL_FALSE, 0, 0);
+/*
+  The arena of the mesh's format holds interleaved vertices in layout order
+*/
+void Mesh::createArenaRange(const MeshView &data, const VertexQuantizer *quantizer, size_t indexBytes) {
+  std::vector<PackedAttribute> attributes;
+  const size_t packedSize = packAttributes(_layout, !data.normals.empty(), !data.texcoords.empty(),
+                                           !data.colors.empty(), attributes);
+  GeometryArena::VertexFormat format;
+  format.stride = std::max(packedSize, static_cast<size_t>(_layout.stride));
+  for (const PackedAttribute &attr : attributes) {
+    format.attributes.push_back({ attr.id, attr.format.components, attr.format.type,
+                                  attr.format.normalized, attr.offset });
+  }
+
+  _arena = GeometryArena::forFormat(format);
+  _arenaRange = _arena->allocate(data.positions.size(), indexBytes);
+  _arenaPlacement = _arena->getRange(_arenaRange);
+  _arenaGeneration = _arena->getGeneration();
+
+  std::byte *vertices = _arena->mapVertices(_arenaRange);
+  if (vertices) {
+    if (format.stride != packedSize || quantizer) std::memset(vertices, 0, format.stride * data.positions.size());
+    packVertices(vertices, format.stride, attributes, data, quantizer);
+  }
+  _arena->unmap();
+}
+
+/*
+  Follows the mesh's range after the arena moved it (see GeometryArena::defragment)
+*/
+void Mesh::syncArena() {
+  if (!_arena || _arena->getGeneration() == _arenaGeneration) return;
+  const GeometryArena::Range &range = _arena->getRange(_arenaRange);
+  const GLint vertexShift = static_cast<GLint>(range.firstVertex) - static_cast<GLint>(_arenaPlacement.firstVertex);
+  for (std::vector<DrawRange> *draws : { &_draws, &_meshletDraws }) {
+    for (DrawRange &draw : *draws) {
+      draw.offset = draw.offset - _arenaPlacement.indexOffset + range.indexOffset;
+      draw.baseVertex += vertexShift;
     }
+  }
+  _arenaPlacement = range;
+  _arenaGeneration = _arena->getGeneration();
+  _culled = false;
+  createIndirectBuffer();
+}
 
-    if (_colorsLoaded) {
-      glBindBuffer(GL_ARRAY_BUFFER, BufferIds[COLOR]);
-      glBufferData(GL_ARRAY_BUFFER, sizeof(_colors[0]) * _colors.size(),
-                   &_colors[0], GL_STATIC_DRAW);
-      glEnableVertexAttribArray(COLOR);
-      glVertexAttribPointer(COLOR, 4, GL_FLOAT, GL_FALSE, 0, 0);
+void Mesh::createVertexBuffers(const MeshView &data, const VertexQuantizer *quantizer) {
+  if (_layout.interleaved) {
+    createInterleavedBuffer(data, quantizer);
+  } else {
+    createSeparateBuffers(data, quantizer);
+  }
+}
+
+void Mesh::createSeparateBuffers(const MeshView &data, const VertexQuantizer *quantizer) {
+  const size_t vertexCount = data.positions.size();
+  auto uploadAttribute = [&](u8 id, const void *src, size_t srcSize) {
+    const AttributeFormat format = attributeFormat(id, quantizer != nullptr);
+    glBindBuffer(GL_ARRAY_BUFFER, BufferIds[id]);
+    if (format.encoding == Encoding::FLOAT) {
+      glBufferData(GL_ARRAY_BUFFER, srcSize * vertexCount, src, GL_STATIC_DRAW);
+    } else {
+      std::byte *dst = static_cast<std::byte *>(allocateMapped(GL_ARRAY_BUFFER, format.size * vertexCount));
+      writeAttribute(gpuTarget(dst, format.size, format, quantizer), 0, src, srcSize, vertexCount);
+      unmapBuffer(GL_ARRAY_BUFFER);
     }
+    setAttributePointer(id, format, 0, 0);
+  };
 
+  // Position is always needed
+  uploadAttribute(POSITION, data.positions.data(), sizeof(math::vec3));
 
+  // Optional attributes
+  if (!data.normals.empty()) {
+    uploadAttribute(NORMAL, data.normals.data(), sizeof(math::vec3));
+  }
+  if (!data.texcoords.empty()) {
+    uploadAttribute(TEXCOORD, data.texcoords.data(), sizeof(math::vec2));
+  }
+  if (!data.colors.empty()) {
+    uploadAttribute(COLOR, data.colors.data(), sizeof(math::vec4));
+  }
+}
 
-    // Indexing is always used as well
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, BufferIds[INDEX]);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _indices.size(),
-                 &_indices[0], GL_STATIC_DRAW);
+void Mesh::createInterleavedBuffer(const MeshView &data, const VertexQuantizer *quantizer) {
+  std::vector<PackedAttribute> attributes;
+  const size_t packedSize = packAttributes(_layout, !data.normals.empty(), !data.texcoords.empty(),
+                                           !data.colors.empty(), attributes);
+  const size_t stride = std::max(packedSize, static_cast<size_t>(_layout.stride));
+  const size_t vertexCount = data.positions.size();
+
+  // A single buffer for all attributes - the remaining VBO ids stay unused.
+  // Vertices are packed straight into the mapped buffer, padding stays zeroed
+  glBindBuffer(GL_ARRAY_BUFFER, BufferIds[POSITION]);
+  std::byte *vertices = static_cast<std::byte *>(
+      allocateMapped(GL_ARRAY_BUFFER, stride * vertexCount));
+  if (stride != packedSize || quantizer) std::memset(vertices, 0, stride * vertexCount);
+  packVertices(vertices, stride, attributes, data, quantizer);
+  for (const PackedAttribute &attr : attributes) {
+    setAttributePointer(attr.id, attr.format, stride, attr.offset);
   }
-  glBindVertexArray(0);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  unmapBuffer(GL_ARRAY_BUFFER);
+
+  MGL_DEBUG("Interleaved {} attribute(s) [stride {} bytes]", attributes.size(), stride);
 }
 
 void Mesh::destroyBufferObjects() {
@@ -275,23 +1313,195 @@ void Mesh::destroyBufferObjects() {
     VaoId = 0;
   }
 
-  // Clean up any buffers that were created
-  glDeleteBuffers(6, BufferIds);
-  for (auto& id : BufferIds) {
-    id = 0;
+  // Clean up any buffers that were created. A mesh that was only load()ed
+  // has none, and may be destroyed without an OpenGL context (mgl-assetc)
+  if (std::any_of(std::begin(BufferIds), std::end(BufferIds), [](GLuint id) { return id != 0; })) {
+    glDeleteBuffers(6, BufferIds);
+    for (auto& id : BufferIds) {
+      id = 0;
+    }
+  }
+  if (_skinBuffer) {
+    glDeleteBuffers(1, &_skinBuffer);
+    _skinBuffer = 0;
+  }
+  if (_arena) {
+    _arena->release(_arenaRange);
+    _arena.reset();
+    _arenaRange = GeometryArena::INVALID;
+  }
+  if (_indirectBuffer) {
+    glDeleteBuffers(1, &_indirectBuffer);
+    _indirectBuffer = 0;
+  }
+  _indirectGroups.clear();
+}
+
+/*
+  Commands are ordered by LOD, then index type, so every (LOD, type) pair
+  is one contiguous run of the buffer
+*/
+void Mesh::createIndirectBuffer() {
+  if (_indirectBuffer) {
+    glDeleteBuffers(1, &_indirectBuffer);
+    _indirectBuffer = 0;
+  }
+  _indirectGroups.clear();
+  if (!GLAD_GL_VERSION_4_3 || _meshes.empty() || _draws.empty()) return;
+
+  const size_t levels = _draws.size() / _meshes.size();
+  const GLenum types[2] = { GL_UNSIGNED_SHORT, GL_UNSIGNED_INT };
+  std::vector<DrawElementsIndirectCommand> commands;
+  commands.reserve(_draws.size());
+  _indirectGroups.assign(levels * 2, { 0, 0 });
+  for (size_t level = 0; level < levels; level++) {
+    for (int t = 0; t < 2; t++) {
+      IndirectGroup &group = _indirectGroups[level * 2 + t];
+      group.offset = commands.size() * sizeof(DrawElementsIndirectCommand);
+      for (size_t i = level * _meshes.size(); i < (level + 1) * _meshes.size(); i++) {
+        const DrawRange &draw = _draws[i];
+        if (draw.type != types[t] || draw.count == 0) continue;
+        const size_t indexSize = draw.type == GL_UNSIGNED_SHORT ? sizeof(u16) : sizeof(ui32);
+        commands.push_back({ static_cast<GLuint>(draw.count), 1, static_cast<GLuint>(draw.offset / indexSize),
+                             draw.baseVertex, 0 });
+        group.count++;
+      }
+    }
+  }
+
+  glGenBuffers(1, &_indirectBuffer);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _indirectBuffer);
+  glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawElementsIndirectCommand),
+               commands.data(), GL_STATIC_DRAW);
+  glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+size_t Mesh::planDraws(std::span<const Submesh> submeshes, const std::vector<ui32> &maxIndex) {
+  _draws.clear();
+  size_t offset = 0;
+  size_t narrow = 0;
+  for (size_t s = 0; s < submeshes.size(); s++) {
+    const bool fits16 = maxIndex[s] <= 0xFFFF;
+    const GLenum type = fits16 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+    offset = (offset + 3) & ~size_t(3); // keep every range 4-byte aligned
+    _draws.push_back({ type, offset, static_cast<GLsizei>(submeshes[s].n_indices),
+                       static_cast<GLint>(submeshes[s].baseVertex) });
+    offset += submeshes[s].n_indices * (fits16 ? sizeof(u16) : sizeof(ui32));
+    narrow += fits16;
   }
+  MGL_DEBUG("Index buffer: {} of {} submesh(es) with 16-bit indices [{} bytes]",
+            narrow, submeshes.size(), offset);
+  return offset;
+}
+
+size_t Mesh::cullMeshlets(const math::mat4 &modelViewProjection, const math::vec3 &cameraPosition,
+                          GLenum cullFace) {
+  syncArena();
+  for (MultiDraw &visible : _visible) {
+    visible.counts.clear();
+    visible.offsets.clear();
+    visible.baseVertices.clear();
+  }
+  const std::array<math::vec4, 6> planes = Meshlets::frustumPlanes(modelViewProjection);
+  size_t count = 0;
+  for (size_t m = 0; m < _meshletDraws.size(); m++) {
+    if (!Meshlets::isVisible(_meshlets[m], planes, cameraPosition, cullFace)) {
+      continue;
+    }
+    const DrawRange &draw = _meshletDraws[m];
+    const size_t indexSize = draw.type == GL_UNSIGNED_SHORT ? sizeof(u16) : sizeof(ui32);
+    MultiDraw &visible = _visible[draw.type == GL_UNSIGNED_SHORT ? 0 : 1];
+
+    // consecutive visible meshlets of a submesh are merged into one range
+    if (!visible.counts.empty() && visible.baseVertices.back() == draw.baseVertex &&
+        reinterpret_cast<size_t>(visible.offsets.back()) + visible.counts.back() * indexSize == draw.offset) {
+      visible.counts.back() += draw.count;
+    } else {
+      visible.counts.push_back(draw.count);
+      visible.offsets.push_back(reinterpret_cast<const void *>(draw.offset));
+      visible.baseVertices.push_back(draw.baseVertex);
+    }
+    count++;
+  }
+  _culled = true;
+  return count;
 }
 
 void Mesh::performDraw() {
-  glBindVertexArray(VaoId);
-  for (Submesh &mesh : _meshes) {
-    glDrawElementsBaseVertex(
-        GL_TRIANGLES, mesh.n_indices, GL_UNSIGNED_INT,
-        reinterpret_cast<void *>((sizeof(unsigned int) * mesh.baseIndex)),
-        mesh.baseVertex);
+  syncArena();
+  glBindVertexArray(getVertexArray());
+  const size_t level = std::min<size_t>(_drawLod, _lodErrors.size());
+  if (_instanceCount > 0) {
+    drawInstances(level);
+    _culled = false;
+    glBindVertexArray(0);
+    return;
+  }
+  if (_culled && level == 0) {
+    const GLenum types[2] = { GL_UNSIGNED_SHORT, GL_UNSIGNED_INT };
+    for (int t = 0; t < 2; t++) {
+      const MultiDraw &visible = _visible[t];
+      if (visible.counts.empty()) continue;
+      glMultiDrawElementsBaseVertex(GL_TRIANGLES, visible.counts.data(), types[t], visible.offsets.data(),
+                                    static_cast<GLsizei>(visible.counts.size()), visible.baseVertices.data());
+    }
+    _culled = false;
+    glBindVertexArray(0);
+    return;
+  }
+  _culled = false;
+  if (_indirectBuffer && level * 2 < _indirectGroups.size()) {
+    // one call per index type, whatever the number of submeshes
+    const GLenum types[2] = { GL_UNSIGNED_SHORT, GL_UNSIGNED_INT };
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _indirectBuffer);
+    for (int t = 0; t < 2; t++) {
+      const IndirectGroup &group = _indirectGroups[level * 2 + t];
+      if (group.count == 0) continue;
+      glMultiDrawElementsIndirect(GL_TRIANGLES, types[t], reinterpret_cast<void *>(group.offset), group.count, 0);
+    }
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    glBindVertexArray(0);
+    return;
+  }
+  // GL 3.3 - one draw per submesh
+  const size_t first = std::min(level * _meshes.size(), _draws.size());
+  const size_t last = std::min(first + _meshes.size(), _draws.size());
+  for (size_t i = first; i < last; i++) {
+    const DrawRange &draw = _draws[i];
+    glDrawElementsBaseVertex(GL_TRIANGLES, draw.count, draw.type,
+                             reinterpret_cast<void *>(draw.offset), draw.baseVertex);
   }
   glBindVertexArray(0);
 }
 
+/*
+  The instance buffer is attached to the VAO only for this draw: several
+  instanced objects may share the mesh, each with its own buffer
+*/
+void Mesh::drawInstances(size_t level) {
+  glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+  for (GLuint column = 0; column < 4; column++) {
+    const GLuint location = MODEL_MATRIX_ATTRIBUTE_INDEX + column;
+    glEnableVertexAttribArray(location);
+    glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(math::mat4),
+                          reinterpret_cast<void *>(column * sizeof(math::vec4)));
+    glVertexAttribDivisor(location, 1);
+  }
+
+  const size_t first = std::min(level * _meshes.size(), _draws.size());
+  const size_t last = std::min(first + _meshes.size(), _draws.size());
+  for (size_t i = first; i < last; i++) {
+    const DrawRange &draw = _draws[i];
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, draw.count, draw.type, reinterpret_cast<void *>(draw.offset),
+                                      _instanceCount, draw.baseVertex);
+  }
+
+  for (GLuint column = 0; column < 4; column++) {
+    glDisableVertexAttribArray(MODEL_MATRIX_ATTRIBUTE_INDEX + column);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  _instanceCount = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 }  // namespace mgl
@@ -0,0 +1,224 @@
+#include <mgl/models/meshes/mglMeshCache.hpp>
+#include <utils/Logger.hpp>
+#include <utils/hash.hpp>
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace mgl {
+
+namespace {
+
+	enum Section : ui32 {
+		SUBMESHES, POSITIONS, NORMALS, TEXCOORDS, COLORS, INDICES,
+		LOD_SUBMESHES, LOD_ERRORS, MESHLETS,
+		SECTION_COUNT
+	};
+
+	struct SectionInfo {
+		u64 offset;
+		u64 size;
+	};
+
+	struct Header {
+		char magic[4];
+		ui32 version;
+		u64 key;
+		ui32 vertexCount;
+		ui32 indexCount;
+		ui32 submeshCount;
+		ui32 lodCount;
+		ui32 meshletCount;
+		ui32 reserved;
+		SectionInfo sections[SECTION_COUNT];
+	};
+
+	constexpr char MAGIC[4] = { 'M', 'G', 'L', 'M' };
+	constexpr u64 ALIGNMENT = 16;
+
+	u64 alignUp(u64 value) {
+		return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	}
+
+	std::filesystem::path& directory() {
+		static std::filesystem::path dir = file::exe_dir() / "cache" / "meshes";
+		return dir;
+	}
+
+	template <typename T>
+	std::span<const T> sectionSpan(const file::MappedFile& file, const SectionInfo& section) {
+		return { reinterpret_cast<const T*>(file.data() + section.offset),
+		         static_cast<size_t>(section.size / sizeof(T)) };
+	}
+
+	// every range inside the indices, every index inside the vertices
+	bool validSubmeshes(std::span<const Submesh> submeshes, const MeshView& view) {
+		for (const Submesh& submesh : submeshes) {
+			if (u64(submesh.baseIndex) + submesh.n_indices > view.indices.size()) return false;
+			for (ui32 i = 0; i < submesh.n_indices; i++) {
+				if (u64(submesh.baseVertex) + view.indices[submesh.baseIndex + i] >= view.positions.size()) return false;
+			}
+		}
+		return true;
+	}
+
+	// meshlets split the full-detail submeshes, so they lie inside one
+	bool validMeshlets(const MeshView& view) {
+		for (const Meshlet& meshlet : view.meshlets) {
+			if (meshlet.submesh >= view.submeshes.size()) return false;
+			const Submesh& submesh = view.submeshes[meshlet.submesh];
+			if (meshlet.baseIndex < submesh.baseIndex ||
+				u64(meshlet.baseIndex) + meshlet.n_indices > u64(submesh.baseIndex) + submesh.n_indices) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+} // namespace
+
+void MeshCache::setDirectory(const std::filesystem::path& dir) {
+	directory() = dir;
+}
+
+std::filesystem::path MeshCache::getDirectory() {
+	return directory();
+}
+
+std::filesystem::path MeshCache::entryPath(u64 key) {
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.mglmesh", static_cast<unsigned long long>(key));
+	return directory() / name;
+}
+
+u64 MeshCache::makeKey(std::span<const std::byte> source, ui32 flags, u64 options) {
+	u64 key = util::hash64(source.data(), source.size());
+	key = util::hashCombine(key, flags);
+	key = util::hashCombine(key, options);
+	return util::hashCombine(key, VERSION);
+}
+
+std::optional<MeshCache::Entry> MeshCache::open(u64 key) {
+	file::MappedFile file(entryPath(key));
+	if (!file || file.size() < sizeof(Header)) return std::nullopt;
+
+	Header header;
+	std::memcpy(&header, file.data(), sizeof(Header));
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+		header.version != VERSION || header.key != key) {
+		MGL_WARN("Ignoring stale or invalid mesh cache entry {}", entryPath(key).string());
+		return std::nullopt;
+	}
+
+	// every section must be aligned, inside the file, and match the header counts
+	const std::array<u64, SECTION_COUNT> expected = {
+		u64(header.submeshCount) * sizeof(Submesh),
+		u64(header.vertexCount) * sizeof(math::vec3),
+		u64(header.vertexCount) * sizeof(math::vec3),
+		u64(header.vertexCount) * sizeof(math::vec2),
+		u64(header.vertexCount) * sizeof(math::vec4),
+		u64(header.indexCount) * sizeof(ui32),
+		u64(header.lodCount) * header.submeshCount * sizeof(Submesh),
+		u64(header.lodCount) * sizeof(float),
+		u64(header.meshletCount) * sizeof(Meshlet),
+	};
+	for (ui32 s = 0; s < SECTION_COUNT; s++) {
+		const SectionInfo& section = header.sections[s];
+		const bool optional = s == NORMALS || s == TEXCOORDS || s == COLORS;
+		if ((section.size != expected[s] && !(optional && section.size == 0)) ||
+			section.offset % ALIGNMENT != 0 ||
+			section.offset > file.size() || section.size > file.size() - section.offset) {
+			MGL_WARN("Ignoring corrupted mesh cache entry {}", entryPath(key).string());
+			return std::nullopt;
+		}
+	}
+
+	Entry entry{ std::move(file), {} };
+	entry.view.submeshes = sectionSpan<Submesh>(entry.file, header.sections[SUBMESHES]);
+	entry.view.positions = sectionSpan<math::vec3>(entry.file, header.sections[POSITIONS]);
+	entry.view.normals   = sectionSpan<math::vec3>(entry.file, header.sections[NORMALS]);
+	entry.view.texcoords = sectionSpan<math::vec2>(entry.file, header.sections[TEXCOORDS]);
+	entry.view.colors    = sectionSpan<math::vec4>(entry.file, header.sections[COLORS]);
+	entry.view.indices   = sectionSpan<ui32>(entry.file, header.sections[INDICES]);
+	entry.view.lodSubmeshes = sectionSpan<Submesh>(entry.file, header.sections[LOD_SUBMESHES]);
+	entry.view.lodErrors    = sectionSpan<float>(entry.file, header.sections[LOD_ERRORS]);
+	entry.view.meshlets     = sectionSpan<Meshlet>(entry.file, header.sections[MESHLETS]);
+
+	// ranges are trusted from here on by the upload, like createFromData's
+	if (!validSubmeshes(entry.view.submeshes, entry.view) ||
+		!validSubmeshes(entry.view.lodSubmeshes, entry.view) || !validMeshlets(entry.view)) {
+		MGL_WARN("Ignoring corrupted mesh cache entry {}", entryPath(key).string());
+		return std::nullopt;
+	}
+	return entry;
+}
+
+bool MeshCache::store(u64 key, const MeshView& data) {
+	Header header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.key = key;
+	header.vertexCount = static_cast<ui32>(data.positions.size());
+	header.indexCount = static_cast<ui32>(data.indices.size());
+	header.submeshCount = static_cast<ui32>(data.submeshes.size());
+	header.lodCount = static_cast<ui32>(data.lodErrors.size());
+	header.meshletCount = static_cast<ui32>(data.meshlets.size());
+
+	const std::array<std::span<const std::byte>, SECTION_COUNT> payloads = {
+		std::as_bytes(data.submeshes),
+		std::as_bytes(data.positions),
+		std::as_bytes(data.normals),
+		std::as_bytes(data.texcoords),
+		std::as_bytes(data.colors),
+		std::as_bytes(data.indices),
+		std::as_bytes(data.lodSubmeshes),
+		std::as_bytes(data.lodErrors),
+		std::as_bytes(data.meshlets),
+	};
+	u64 offset = alignUp(sizeof(Header));
+	for (ui32 s = 0; s < SECTION_COUNT; s++) {
+		header.sections[s] = { offset, payloads[s].size() };
+		offset = alignUp(offset + payloads[s].size());
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(directory(), error);
+
+	// write to a private temporary file, then publish it atomically so
+	// concurrent readers never observe a partially written entry
+	const std::filesystem::path path = entryPath(key);
+	std::filesystem::path tmp = path;
+	tmp += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+	{
+		std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			MGL_WARN("Could not write mesh cache entry {}", path.string());
+			return false;
+		}
+		const char padding[ALIGNMENT] = {};
+		out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		u64 written = sizeof(Header);
+		for (ui32 s = 0; s < SECTION_COUNT; s++) {
+			out.write(padding, header.sections[s].offset - written);
+			out.write(reinterpret_cast<const char*>(payloads[s].data()), payloads[s].size());
+			written = header.sections[s].offset + payloads[s].size();
+		}
+		if (!out) {
+			MGL_WARN("Could not write mesh cache entry {}", path.string());
+			std::filesystem::remove(tmp, error);
+			return false;
+		}
+	}
+	std::filesystem::rename(tmp, path, error);
+	if (error) {
+		std::filesystem::remove(tmp, error);
+		return false;
+	}
+	return true;
+}
+
+}
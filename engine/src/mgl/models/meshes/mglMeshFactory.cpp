@@ -0,0 +1,298 @@
+#include <mgl/models/meshes/mglMeshFactory.hpp>
+#include <utils/hash.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace mgl {
+
+namespace {
+
+	enum class Shape : u64 { CUBE, UV_SPHERE, ICO_SPHERE, PLANE, CYLINDER, TORUS, FULLSCREEN_TRIANGLE };
+
+	struct Cache {
+		std::mutex mutex;
+		std::unordered_map<u64, std::unique_ptr<const MeshData>> primitives;
+	};
+
+	Cache& cache() {
+		static Cache primitives;
+		return primitives;
+	}
+
+	u64 bits(f32 value) {
+		return std::bit_cast<ui32>(value);
+	}
+
+	u64 keyOf(Shape shape, std::initializer_list<u64> parameters) {
+		u64 key = util::hashCombine(util::HASH_SEED, static_cast<u64>(shape));
+		for (u64 parameter : parameters) key = util::hashCombine(key, parameter);
+		return key;
+	}
+
+	/// The primitive cached under key, built on first use. Parameters must be valid
+	template <typename Build>
+	const MeshData& cached(u64 key, Build build) {
+		Cache& primitives = cache();
+		std::lock_guard lock(primitives.mutex);
+		std::unique_ptr<const MeshData>& primitive = primitives.primitives[key];
+		if (!primitive) primitive = std::make_unique<const MeshData>(build());
+		return *primitive;
+	}
+
+	void requirePositive(f32 value, const char* message) {
+		if (!(value > 0.0f) || !std::isfinite(value)) throw std::invalid_argument(message);
+	}
+
+	void addVertex(MeshData& data, const math::vec3& position, const math::vec3& normal, const math::vec2& texcoord) {
+		data.positions.push_back(position);
+		data.normals.push_back(normal);
+		data.texcoords.push_back(texcoord);
+	}
+
+	/*
+		Triangulates rows x columns quads of a grid of (rows + 1) x (columns + 1)
+		vertices starting at 'base', row-major. Rows must advance so that
+		(next row, next column) turns counter-clockwise around the front face.
+		Triangles collapsed on a pole are skipped.
+	*/
+	void addGrid(MeshData& data, ui32 base, ui32 columns, ui32 rows) {
+		auto addTriangle = [&data](ui32 a, ui32 b, ui32 c) {
+			const std::vector<math::vec3>& p = data.positions;
+			if (p[a] == p[b] || p[b] == p[c] || p[c] == p[a]) return;
+			data.indices.insert(data.indices.end(), { a, b, c });
+		};
+		for (ui32 row = 0; row < rows; row++) {
+			for (ui32 column = 0; column < columns; column++) {
+				const ui32 a = base + row * (columns + 1) + column;
+				const ui32 b = a + columns + 1;
+				addTriangle(a, b, a + 1);
+				addTriangle(a + 1, b, b + 1);
+			}
+		}
+	}
+
+	MeshData buildCube(f32 size) {
+		// normal, then tangent axes u and v with cross(u, v) == normal
+		static const math::vec3 FACES[6][3] = {
+			{ math::vec3(1, 0, 0), math::vec3(0, 0, -1), math::vec3(0, 1, 0) },
+			{ math::vec3(-1, 0, 0), math::vec3(0, 0, 1), math::vec3(0, 1, 0) },
+			{ math::vec3(0, 1, 0), math::vec3(1, 0, 0), math::vec3(0, 0, -1) },
+			{ math::vec3(0, -1, 0), math::vec3(1, 0, 0), math::vec3(0, 0, 1) },
+			{ math::vec3(0, 0, 1), math::vec3(1, 0, 0), math::vec3(0, 1, 0) },
+			{ math::vec3(0, 0, -1), math::vec3(-1, 0, 0), math::vec3(0, 1, 0) },
+		};
+		const f32 half = size * 0.5f;
+		MeshData data;
+		for (const auto& [normal, u, v] : FACES) {
+			const ui32 base = static_cast<ui32>(data.positions.size());
+			addVertex(data, (normal - u - v) * half, normal, math::vec2(0, 0));
+			addVertex(data, (normal + u - v) * half, normal, math::vec2(1, 0));
+			addVertex(data, (normal + u + v) * half, normal, math::vec2(1, 1));
+			addVertex(data, (normal - u + v) * half, normal, math::vec2(0, 1));
+			data.indices.insert(data.indices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+		}
+		return data;
+	}
+
+	MeshData buildUvSphere(f32 radius, ui32 segments, ui32 rings) {
+		MeshData data;
+		// rings from the north pole down, duplicated seam column for the texture
+		for (ui32 ring = 0; ring <= rings; ring++) {
+			const f32 latitude = math::PI * ring / rings;
+			// exact poles, so the triangles collapsed on them are found
+			const f32 ringRadius = ring == 0 || ring == rings ? 0.0f : std::sin(latitude);
+			const f32 height = ring == 0 ? 1.0f : ring == rings ? -1.0f : std::cos(latitude);
+			for (ui32 segment = 0; segment <= segments; segment++) {
+				const f32 longitude = math::TWO_PI * (segment % segments) / segments;
+				const math::vec3 normal(ringRadius * std::sin(longitude), height, ringRadius * std::cos(longitude));
+				addVertex(data, normal * radius, normal,
+				          math::vec2(f32(segment) / segments, 1.0f - f32(ring) / rings));
+			}
+		}
+		addGrid(data, 0, segments, rings);
+		return data;
+	}
+
+	MeshData buildIcoSphere(f32 radius, ui32 subdivisions) {
+		const f32 t = (1.0f + std::sqrt(5.0f)) * 0.5f;
+		std::vector<math::vec3> positions = {
+			math::vec3(-1, t, 0), math::vec3(1, t, 0), math::vec3(-1, -t, 0), math::vec3(1, -t, 0),
+			math::vec3(0, -1, t), math::vec3(0, 1, t), math::vec3(0, -1, -t), math::vec3(0, 1, -t),
+			math::vec3(t, 0, -1), math::vec3(t, 0, 1), math::vec3(-t, 0, -1), math::vec3(-t, 0, 1),
+		};
+		std::vector<ui32> indices = {
+			0, 11, 5,  0, 5, 1,  0, 1, 7,  0, 7, 10,  0, 10, 11,
+			1, 5, 9,  5, 11, 4,  11, 10, 2,  10, 7, 6,  7, 1, 8,
+			3, 9, 4,  3, 4, 2,  3, 2, 6,  3, 6, 8,  3, 8, 9,
+			4, 9, 5,  2, 4, 11,  6, 2, 10,  8, 6, 7,  9, 8, 1,
+		};
+		for (math::vec3& position : positions) position = position.normalized();
+
+		// every triangle splits in 4 - edge midpoints are shared by their two triangles
+		for (ui32 level = 0; level < subdivisions; level++) {
+			std::unordered_map<u64, ui32> midpoints;
+			auto midpoint = [&positions, &midpoints](ui32 a, ui32 b) {
+				const u64 edge = a < b ? (u64(a) << 32) | b : (u64(b) << 32) | a;
+				const auto [found, inserted] = midpoints.emplace(edge, static_cast<ui32>(positions.size()));
+				if (inserted) positions.push_back(((positions[a] + positions[b]) * 0.5f).normalized());
+				return found->second;
+			};
+			std::vector<ui32> split;
+			split.reserve(indices.size() * 4);
+			for (size_t i = 0; i < indices.size(); i += 3) {
+				const ui32 a = indices[i], b = indices[i + 1], c = indices[i + 2];
+				const ui32 ab = midpoint(a, b), bc = midpoint(b, c), ca = midpoint(c, a);
+				split.insert(split.end(), { a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca });
+			}
+			indices = std::move(split);
+		}
+
+		MeshData data;
+		data.indices = std::move(indices);
+		for (const math::vec3& normal : positions) {
+			const f32 u = 0.5f + std::atan2(normal[0], normal[2]) / math::TWO_PI;
+			const f32 v = 0.5f + std::asin(std::clamp(normal[1], -1.0f, 1.0f)) / math::PI;
+			addVertex(data, normal * radius, normal, math::vec2(u, v));
+		}
+		return data;
+	}
+
+	MeshData buildPlane(f32 width, f32 depth, ui32 xSegments, ui32 zSegments) {
+		MeshData data;
+		const math::vec3 up(0, 1, 0);
+		for (ui32 row = 0; row <= zSegments; row++) {
+			const f32 v = f32(row) / zSegments;
+			for (ui32 column = 0; column <= xSegments; column++) {
+				const f32 u = f32(column) / xSegments;
+				addVertex(data, math::vec3((u - 0.5f) * width, 0.0f, (v - 0.5f) * depth), up, math::vec2(u, 1.0f - v));
+			}
+		}
+		addGrid(data, 0, xSegments, zSegments);
+		return data;
+	}
+
+	MeshData buildCylinder(f32 radius, f32 height, ui32 segments, bool capped) {
+		MeshData data;
+		const f32 half = height * 0.5f;
+		for (ui32 row = 0; row <= 1; row++) {
+			for (ui32 segment = 0; segment <= segments; segment++) {
+				const f32 angle = math::TWO_PI * (segment % segments) / segments;
+				const math::vec3 normal(std::sin(angle), 0.0f, std::cos(angle));
+				addVertex(data, math::vec3(normal[0] * radius, row == 0 ? half : -half, normal[2] * radius),
+				          normal, math::vec2(f32(segment) / segments, row == 0 ? 1.0f : 0.0f));
+			}
+		}
+		addGrid(data, 0, segments, 1);
+		if (!capped) return data;
+
+		// fans around the center of each cap, which has its own flat normals
+		for (const f32 side : { 1.0f, -1.0f }) {
+			const ui32 center = static_cast<ui32>(data.positions.size());
+			const math::vec3 normal(0.0f, side, 0.0f);
+			addVertex(data, math::vec3(0.0f, side * half, 0.0f), normal, math::vec2(0.5f, 0.5f));
+			for (ui32 segment = 0; segment < segments; segment++) {
+				const f32 angle = math::TWO_PI * segment / segments;
+				const f32 x = std::sin(angle), z = std::cos(angle);
+				addVertex(data, math::vec3(x * radius, side * half, z * radius), normal,
+				          math::vec2(0.5f + 0.5f * x, 0.5f - 0.5f * side * z));
+			}
+			for (ui32 segment = 0; segment < segments; segment++) {
+				const ui32 current = center + 1 + segment;
+				const ui32 next = center + 1 + (segment + 1) % segments;
+				if (side > 0.0f) data.indices.insert(data.indices.end(), { center, current, next });
+				else data.indices.insert(data.indices.end(), { center, next, current });
+			}
+		}
+		return data;
+	}
+
+	MeshData buildTorus(f32 radius, f32 tubeRadius, ui32 segments, ui32 tubeSegments) {
+		MeshData data;
+		for (ui32 segment = 0; segment <= segments; segment++) {
+			const f32 angle = math::TWO_PI * (segment % segments) / segments;
+			const math::vec3 outward(std::sin(angle), 0.0f, std::cos(angle));
+			for (ui32 tube = 0; tube <= tubeSegments; tube++) {
+				const f32 tubeAngle = math::TWO_PI * (tube % tubeSegments) / tubeSegments;
+				const math::vec3 normal = outward * std::cos(tubeAngle) + math::vec3(0, 1, 0) * std::sin(tubeAngle);
+				addVertex(data, outward * radius + normal * tubeRadius, normal,
+				          math::vec2(f32(segment) / segments, f32(tube) / tubeSegments));
+			}
+		}
+		addGrid(data, 0, tubeSegments, segments);
+		return data;
+	}
+
+	MeshData buildFullscreenTriangle() {
+		MeshData data;
+		const math::vec3 normal(0, 0, 1);
+		addVertex(data, math::vec3(-1, -1, 0), normal, math::vec2(0, 0));
+		addVertex(data, math::vec3(3, -1, 0), normal, math::vec2(2, 0));
+		addVertex(data, math::vec3(-1, 3, 0), normal, math::vec2(0, 2));
+		data.indices = { 0, 1, 2 };
+		return data;
+	}
+
+} // namespace
+
+const MeshData& MeshFactory::cube(f32 size) {
+	requirePositive(size, "cube: size must be positive");
+	return cached(keyOf(Shape::CUBE, { bits(size) }), [=] { return buildCube(size); });
+}
+
+const MeshData& MeshFactory::uvSphere(f32 radius, ui32 segments, ui32 rings) {
+	requirePositive(radius, "uvSphere: radius must be positive");
+	if (segments < 3 || rings < 2) throw std::invalid_argument("uvSphere: needs at least 3 segments and 2 rings");
+	return cached(keyOf(Shape::UV_SPHERE, { bits(radius), segments, rings }),
+	              [=] { return buildUvSphere(radius, segments, rings); });
+}
+
+const MeshData& MeshFactory::icoSphere(f32 radius, ui32 subdivisions) {
+	requirePositive(radius, "icoSphere: radius must be positive");
+	// 20 * 4^8 = 1.3M triangles
+	if (subdivisions > 8) throw std::invalid_argument("icoSphere: at most 8 subdivisions");
+	return cached(keyOf(Shape::ICO_SPHERE, { bits(radius), subdivisions }),
+	              [=] { return buildIcoSphere(radius, subdivisions); });
+}
+
+const MeshData& MeshFactory::plane(f32 width, f32 depth, ui32 xSegments, ui32 zSegments) {
+	requirePositive(width, "plane: width must be positive");
+	requirePositive(depth, "plane: depth must be positive");
+	if (xSegments == 0 || zSegments == 0) throw std::invalid_argument("plane: needs at least 1 segment per axis");
+	return cached(keyOf(Shape::PLANE, { bits(width), bits(depth), xSegments, zSegments }),
+	              [=] { return buildPlane(width, depth, xSegments, zSegments); });
+}
+
+const MeshData& MeshFactory::cylinder(f32 radius, f32 height, ui32 segments, bool capped) {
+	requirePositive(radius, "cylinder: radius must be positive");
+	requirePositive(height, "cylinder: height must be positive");
+	if (segments < 3) throw std::invalid_argument("cylinder: needs at least 3 segments");
+	return cached(keyOf(Shape::CYLINDER, { bits(radius), bits(height), segments, capped }),
+	              [=] { return buildCylinder(radius, height, segments, capped); });
+}
+
+const MeshData& MeshFactory::torus(f32 radius, f32 tubeRadius, ui32 segments, ui32 tubeSegments) {
+	requirePositive(radius, "torus: radius must be positive");
+	requirePositive(tubeRadius, "torus: tube radius must be positive");
+	if (segments < 3 || tubeSegments < 3) throw std::invalid_argument("torus: needs at least 3 segments around each circle");
+	return cached(keyOf(Shape::TORUS, { bits(radius), bits(tubeRadius), segments, tubeSegments }),
+	              [=] { return buildTorus(radius, tubeRadius, segments, tubeSegments); });
+}
+
+const MeshData& MeshFactory::fullscreenTriangle() {
+	return cached(keyOf(Shape::FULLSCREEN_TRIANGLE, {}), buildFullscreenTriangle);
+}
+
+size_t MeshFactory::cachedCount() {
+	Cache& primitives = cache();
+	std::lock_guard lock(primitives.mutex);
+	return primitives.primitives.size();
+}
+
+}
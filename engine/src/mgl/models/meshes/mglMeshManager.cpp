@@ -1,23 +1,164 @@
 #include <mgl/models/meshes/mglMeshManager.hpp>
+#include <utils/ThreadPool.hpp>
+
+#include <chrono>
+#include <unordered_set>
 
 namespace mgl {
 
 MeshManager::MeshManager() {}
 MeshManager::~MeshManager() {}
 
-void MeshManager::import(const std::string& name, const std::string& filePath) {
+std::shared_ptr<Mesh> MeshManager::newMesh() {
 	std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
-
 	if (itemCallback) {
 		itemCallback(*mesh);
 	}
+	return mesh;
+}
+
+std::shared_ptr<Mesh> MeshManager::findContent(u64 key) {
+	if (key == 0) return nullptr;
+	const auto found = byContent.find(key);
+	return found != byContent.end() ? found->second.lock() : nullptr;
+}
 
-	mesh->createFromFile(filePath);
+void MeshManager::addAlias(const std::string& name, const std::shared_ptr<Mesh>& mesh) {
+	MGL_DEBUG("Mesh [{}] shares the geometry of an identical mesh", name);
+	add(name, mesh);
+}
+
+void MeshManager::addUnique(const std::string& name, u64 key, const std::shared_ptr<Mesh>& mesh) {
+	if (key != 0) {
+		byContent[key] = mesh;
+	}
 	add(name, mesh);
 }
 
+/*
+	The content key is computed by a mesh configured like the one that would
+	be created, so two names only share a mesh if they would build the same one.
+	It extends the cache key, which is handed on so the file is hashed once
+*/
+void MeshManager::import(const std::string& name, const std::string& filePath) {
+	std::shared_ptr<Mesh> mesh = newMesh();
+	const u64 cacheKey = mesh->cacheKey(filePath);
+	const u64 key = mesh->contentKeyOf(cacheKey);
+	if (std::shared_ptr<Mesh> existing = findContent(key)) {
+		addAlias(name, existing);
+		return;
+	}
+
+	mesh->createFromFile(filePath, cacheKey);
+	addUnique(name, key, mesh);
+}
+
+void MeshManager::create(const std::string& name, MeshData data) {
+	std::shared_ptr<Mesh> mesh = newMesh();
+	const u64 key = mesh->contentKey(data);
+	if (std::shared_ptr<Mesh> existing = findContent(key)) {
+		addAlias(name, existing);
+		return;
+	}
+
+	mesh->createFromData(std::move(data));
+	addUnique(name, key, mesh);
+}
+
+void MeshManager::importBatch(const std::vector<MeshImport>& imports) {
+	const auto start = std::chrono::steady_clock::now();
+
+	// configuration callbacks run on the calling thread, before any parsing
+	std::vector<std::shared_ptr<Mesh>> meshes(imports.size());
+	for (std::shared_ptr<Mesh>& mesh : meshes) {
+		mesh = newMesh();
+	}
+
+	// CPU work in parallel - hash every file, then parse only the first
+	// import of each content. Assimp importers are not thread-safe, so each
+	// worker reuses its own
+	util::ThreadPool& pool = util::ThreadPool::shared();
+	std::vector<u64> cacheKeys(imports.size()), keys(imports.size());
+	pool.parallelFor(imports.size(), [&](size_t i, size_t) {
+		cacheKeys[i] = meshes[i]->cacheKey(imports[i].filePath);
+		keys[i] = meshes[i]->contentKeyOf(cacheKeys[i]);
+	});
+
+	// each import is built, or shares a managed mesh or an earlier import of the batch
+	std::vector<std::shared_ptr<Mesh>> shared(imports.size());
+	std::vector<size_t> unique;
+	std::unordered_map<u64, size_t> firstInBatch;
+	for (size_t i = 0; i < imports.size(); i++) {
+		if ((shared[i] = findContent(keys[i]))) continue;
+		if (keys[i] != 0) {
+			const auto [first, inserted] = firstInBatch.emplace(keys[i], i);
+			if (!inserted) {
+				shared[i] = meshes[first->second];
+				continue;
+			}
+		}
+		unique.push_back(i);
+	}
+
+	std::vector<Assimp::Importer> importers(pool.size());
+	std::vector<char> loaded(unique.size(), false);
+	pool.parallelFor(unique.size(), [&](size_t u, size_t worker) {
+		const size_t i = unique[u];
+		loaded[u] = meshes[i]->load(imports[i].filePath, importers[worker], cacheKeys[i]);
+	});
+
+	for (size_t u = 0; u < unique.size(); u++) {
+		if (!loaded[u]) {
+			MGL_ERROR("Batch import failed for [{}]", imports[unique[u]].filePath);
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	// GPU uploads serially on the GL thread
+	for (size_t i : unique) {
+		meshes[i]->upload();
+		addUnique(imports[i].name, keys[i], meshes[i]);
+	}
+	for (size_t i = 0; i < imports.size(); i++) {
+		if (shared[i]) addAlias(imports[i].name, shared[i]);
+	}
+
+	const auto elapsed = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - start).count();
+	MGL_INFO("Imported {} mesh(es), {} unique, in {:.1f} ms [{:.1f} MB of CPU geometry held, {:.1f} MB saved]",
+		imports.size(), unique.size(), elapsed, cpuGeometryBytes() / (1024.0 * 1024.0),
+		bytesSaved() / (1024.0 * 1024.0));
+}
+
+size_t MeshManager::cpuGeometryBytes() {
+	size_t bytes = 0;
+	std::unordered_set<const Mesh*> counted;
+	forEach([&bytes, &counted](Mesh& mesh) {
+		if (counted.insert(&mesh).second) bytes += mesh.cpuBytes();
+	});
+	return bytes;
+}
+
+size_t MeshManager::uniqueMeshCount() {
+	std::unordered_set<const Mesh*> meshes;
+	forEach([&meshes](Mesh& mesh) {
+		meshes.insert(&mesh);
+	});
+	return meshes.size();
+}
+
+// every name of a mesh past the first would have held its own copy
+size_t MeshManager::bytesSaved() {
+	size_t bytes = 0;
+	std::unordered_set<const Mesh*> counted;
+	forEach([&bytes, &counted](Mesh& mesh) {
+		if (!counted.insert(&mesh).second) bytes += mesh.gpuBytes() + mesh.cpuBytes();
+	});
+	return bytes;
+}
+
 void MeshManager::meshConfigCallback(SetManagedItemCallback callback) {
 	setManagedItemCallback(callback);
 }
 
-}
\ No newline at end of file
+}
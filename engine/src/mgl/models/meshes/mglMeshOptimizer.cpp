@@ -0,0 +1,290 @@
+#include <mgl/models/meshes/mglMeshOptimizer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace mgl {
+
+namespace {
+
+	// FIFO post-transform cache simulation. A vertex is cached if it was
+	// inserted fewer than 'size' insertions ago, so flushing is O(1).
+	class FifoCache {
+	public:
+		FifoCache(size_t vertexCount, unsigned size)
+			: stamps(vertexCount, 0), size(size), time(size + 1) {}
+
+		/// Returns 1 on a cache miss, 0 on a hit
+		unsigned access(ui32 vertex) {
+			if (time - stamps[vertex] > size) {
+				stamps[vertex] = time++;
+				return 1;
+			}
+			return 0;
+		}
+
+		unsigned accessTriangle(const ui32* triangle) {
+			return access(triangle[0]) + access(triangle[1]) + access(triangle[2]);
+		}
+
+		void flush() { time += size + 1; }
+
+	private:
+		std::vector<ui32> stamps;
+		ui32 size;
+		ui32 time;
+	};
+
+	// Forsyth's scoring, with the constants from the original article
+	constexpr unsigned FORSYTH_CACHE_SIZE = 32;
+	constexpr unsigned VALENCE_TABLE_SIZE = 32;
+
+	struct ScoreTables {
+		float cache[FORSYTH_CACHE_SIZE];
+		float valence[VALENCE_TABLE_SIZE];
+
+		ScoreTables() {
+			for (unsigned i = 0; i < FORSYTH_CACHE_SIZE; i++) {
+				// vertices of the last triangle get a fixed score, so the
+				// algorithm does not favour reusing the same edge
+				cache[i] = i < 3 ? 0.75f
+					: std::pow(1.0f - float(i - 3) / (FORSYTH_CACHE_SIZE - 3), 1.5f);
+			}
+			valence[0] = 0.0f;
+			for (unsigned i = 1; i < VALENCE_TABLE_SIZE; i++) {
+				valence[i] = 2.0f / std::sqrt(float(i));
+			}
+		}
+
+		// Vertices with few triangles left are boosted so they get finished
+		// (and leave the cache) early
+		float score(int cachePosition, ui32 remaining) const {
+			if (remaining == 0) return -1.0f;
+			const float cached = cachePosition >= 0 ? cache[cachePosition] : 0.0f;
+			return cached + (remaining < VALENCE_TABLE_SIZE ? valence[remaining]
+			                                                : 2.0f / std::sqrt(float(remaining)));
+		}
+	};
+
+}
+
+float MeshOptimizer::acmr(std::span<const ui32> indices, size_t vertexCount, unsigned cacheSize) {
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) return 0.0f;
+
+	FifoCache cache(vertexCount, cacheSize);
+	size_t misses = 0;
+	for (size_t t = 0; t < triangleCount; t++) {
+		misses += cache.accessTriangle(&indices[t * 3]);
+	}
+	return float(misses) / float(triangleCount);
+}
+
+void MeshOptimizer::optimizeVertexCache(std::span<ui32> indices, size_t vertexCount) {
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) return;
+	static const ScoreTables tables;
+
+	// Triangles adjacent to each vertex - the first 'remaining[v]' entries of
+	// a vertex are the triangles not emitted yet
+	std::vector<ui32> remaining(vertexCount, 0);
+	for (ui32 index : indices) remaining[index]++;
+
+	std::vector<ui32> offsets(vertexCount + 1, 0);
+	for (size_t v = 0; v < vertexCount; v++) offsets[v + 1] = offsets[v] + remaining[v];
+
+	std::vector<ui32> adjacency(indices.size());
+	{
+		std::vector<ui32> cursor(offsets.begin(), offsets.end() - 1);
+		for (size_t t = 0; t < triangleCount; t++) {
+			for (size_t k = 0; k < 3; k++) {
+				adjacency[cursor[indices[t * 3 + k]]++] = static_cast<ui32>(t);
+			}
+		}
+	}
+
+	std::vector<int> cachePosition(vertexCount, -1);
+	std::vector<float> vertexScore(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++) {
+		vertexScore[v] = tables.score(-1, remaining[v]);
+	}
+
+	std::vector<float> triangleScore(triangleCount);
+	for (size_t t = 0; t < triangleCount; t++) {
+		triangleScore[t] = vertexScore[indices[t * 3]] + vertexScore[indices[t * 3 + 1]] +
+		                   vertexScore[indices[t * 3 + 2]];
+	}
+	std::vector<char> emitted(triangleCount, false);
+
+	std::vector<ui32> output;
+	output.reserve(indices.size());
+
+	ui32 cache[FORSYTH_CACHE_SIZE + 3];
+	ui32 nextCache[FORSYTH_CACHE_SIZE + 3];
+	size_t cacheCount = 0;
+
+	long best = static_cast<long>(std::max_element(triangleScore.begin(), triangleScore.end()) -
+	                              triangleScore.begin());
+	size_t scan = 0;
+
+	while (output.size() < indices.size()) {
+		if (best < 0) {
+			// no cached vertex has triangles left - restart from the next unused one
+			while (emitted[scan]) scan++;
+			best = static_cast<long>(scan);
+		}
+
+		const ui32 triangle[3] = { indices[best * 3], indices[best * 3 + 1], indices[best * 3 + 2] };
+		output.insert(output.end(), triangle, triangle + 3);
+		emitted[best] = true;
+
+		// move the triangle past the live adjacency of its vertices
+		for (ui32 v : triangle) {
+			ui32* adjacent = &adjacency[offsets[v]];
+			for (ui32 i = 0; i < remaining[v]; i++) {
+				if (adjacent[i] == static_cast<ui32>(best)) {
+					std::swap(adjacent[i], adjacent[remaining[v] - 1]);
+					remaining[v]--;
+					break;
+				}
+			}
+		}
+
+		// LRU update: triangle vertices go to the front
+		size_t nextCount = 0;
+		for (ui32 v : triangle) nextCache[nextCount++] = v;
+		for (size_t i = 0; i < cacheCount; i++) {
+			const ui32 v = cache[i];
+			if (v != triangle[0] && v != triangle[1] && v != triangle[2]) {
+				nextCache[nextCount++] = v;
+			}
+		}
+
+		// rescore every vertex whose cache position or valence changed,
+		// including the ones just pushed out of the cache
+		for (size_t i = 0; i < nextCount; i++) {
+			const ui32 v = nextCache[i];
+			cachePosition[v] = i < FORSYTH_CACHE_SIZE ? static_cast<int>(i) : -1;
+			const float score = tables.score(cachePosition[v], remaining[v]);
+			const float delta = score - vertexScore[v];
+			vertexScore[v] = score;
+			for (ui32 a = 0; a < remaining[v]; a++) {
+				triangleScore[adjacency[offsets[v] + a]] += delta;
+			}
+		}
+
+		cacheCount = std::min<size_t>(nextCount, FORSYTH_CACHE_SIZE);
+		std::copy(nextCache, nextCache + cacheCount, cache);
+
+		// next triangle: the best one touching the cache
+		best = -1;
+		float bestScore = -1.0f;
+		for (size_t i = 0; i < cacheCount; i++) {
+			const ui32 v = cache[i];
+			for (ui32 a = 0; a < remaining[v]; a++) {
+				const ui32 t = adjacency[offsets[v] + a];
+				if (triangleScore[t] > bestScore) {
+					bestScore = triangleScore[t];
+					best = t;
+				}
+			}
+		}
+	}
+
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void MeshOptimizer::optimizeOverdraw(std::span<ui32> indices, std::span<const math::vec3> positions,
+                                     float threshold) {
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0) return;
+
+	// Hard boundaries: triangles missing all their vertices restart the
+	// cache, so the order may change there without losing any hits
+	FifoCache cache(positions.size(), CACHE_SIZE);
+	std::vector<unsigned> misses(triangleCount);
+	std::vector<size_t> hard;
+	for (size_t t = 0; t < triangleCount; t++) {
+		misses[t] = cache.accessTriangle(&indices[t * 3]);
+		if (t == 0 || misses[t] == 3) hard.push_back(t);
+	}
+	hard.push_back(triangleCount);
+
+	// Soft boundaries: split a hard cluster again as soon as the part seen so
+	// far, drawn on a cold cache, stays within the allowed ACMR
+	std::vector<size_t> clusters;
+	for (size_t h = 0; h + 1 < hard.size(); h++) {
+		const size_t start = hard[h], end = hard[h + 1];
+		const unsigned clusterMisses = std::accumulate(misses.begin() + start, misses.begin() + end, 0u);
+		const float budget = threshold * float(clusterMisses) / float(end - start);
+
+		clusters.push_back(start);
+		cache.flush();
+		size_t first = start;
+		unsigned runMisses = 0;
+		for (size_t t = start; t + 1 < end; t++) {
+			runMisses += cache.accessTriangle(&indices[t * 3]);
+			if (float(runMisses) / float(t + 1 - first) <= budget) {
+				clusters.push_back(t + 1);
+				first = t + 1;
+				runMisses = 0;
+				cache.flush();
+			}
+		}
+	}
+	clusters.push_back(triangleCount);
+
+	// Clusters that face away from the mesh center are likely to be in
+	// front of the rest - draw them first
+	math::vec3 center(0.0f);
+	for (const math::vec3& p : positions) center += p;
+	center /= float(std::max<size_t>(positions.size(), 1));
+
+	const size_t clusterCount = clusters.size() - 1;
+	std::vector<float> sortKey(clusterCount);
+	for (size_t c = 0; c < clusterCount; c++) {
+		math::vec3 centroid(0.0f), normal(0.0f);
+		float area = 0.0f;
+		for (size_t t = clusters[c]; t < clusters[c + 1]; t++) {
+			const math::vec3& a = positions[indices[t * 3]];
+			const math::vec3& b = positions[indices[t * 3 + 1]];
+			const math::vec3& d = positions[indices[t * 3 + 2]];
+			const math::vec3 n = cross(b - a, d - a);
+			const float triangleArea = n.length();
+			centroid += (a + b + d) * (triangleArea / 3.0f);
+			normal += n;
+			area += triangleArea;
+		}
+		if (area > 0.0f) centroid /= area;
+		sortKey[c] = dot(centroid - center, normal.normalized());
+	}
+
+	std::vector<size_t> order(clusterCount);
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(),
+		[&sortKey](size_t a, size_t b) { return sortKey[a] > sortKey[b]; });
+
+	std::vector<ui32> output;
+	output.reserve(indices.size());
+	for (size_t c : order) {
+		output.insert(output.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+	}
+	std::copy(output.begin(), output.end(), indices.begin());
+}
+
+std::vector<ui32> MeshOptimizer::optimizeVertexFetch(std::span<ui32> indices, size_t vertexCount) {
+	constexpr ui32 UNUSED = ~0u;
+	std::vector<ui32> remap(vertexCount, UNUSED);
+	ui32 next = 0;
+	for (ui32& index : indices) {
+		if (remap[index] == UNUSED) remap[index] = next++;
+		index = remap[index];
+	}
+	for (ui32& target : remap) {
+		if (target == UNUSED) target = next++;
+	}
+	return remap;
+}
+
+}
@@ -0,0 +1,263 @@
+#include <mgl/models/meshes/mglMeshSimplifier.hpp>
+#include <utils/hash.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mgl {
+
+namespace {
+
+	// Penalty weights of attribute changes, relative to squared distances in
+	// the unit-sized mesh
+	constexpr float NORMAL_WEIGHT = 0.01f;
+	constexpr float TEXCOORD_WEIGHT = 0.01f;
+
+	// Sum of squared distances to a set of planes, weighted by triangle area
+	struct Quadric {
+		float a2 = 0, ab = 0, ac = 0, ad = 0;
+		float b2 = 0, bc = 0, bd = 0;
+		float c2 = 0, cd = 0;
+		float d2 = 0;
+		float weight = 0;
+
+		void addPlane(const math::vec3& n, float d, float w) {
+			a2 += w * n[0] * n[0]; ab += w * n[0] * n[1]; ac += w * n[0] * n[2]; ad += w * n[0] * d;
+			b2 += w * n[1] * n[1]; bc += w * n[1] * n[2]; bd += w * n[1] * d;
+			c2 += w * n[2] * n[2]; cd += w * n[2] * d;
+			d2 += w * d * d;
+			weight += w;
+		}
+
+		Quadric& operator+=(const Quadric& q) {
+			a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+			b2 += q.b2; bc += q.bc; bd += q.bd;
+			c2 += q.c2; cd += q.cd;
+			d2 += q.d2;
+			weight += q.weight;
+			return *this;
+		}
+
+		/// Mean squared distance of p to the planes
+		float error(const math::vec3& p) const {
+			const float x = p[0], y = p[1], z = p[2];
+			const float e = a2 * x * x + b2 * y * y + c2 * z * z + d2 +
+			                2.0f * (ab * x * y + ac * x * z + bc * y * z + ad * x + bd * y + cd * z);
+			return weight > 0.0f ? std::max(e, 0.0f) / weight : 0.0f;
+		}
+	};
+
+	struct Collapse {
+		ui32 from;
+		ui32 to;
+		float priority;
+		float error;
+	};
+
+	struct PositionKey {
+		std::array<ui32, 3> bits;
+		bool operator==(const PositionKey& other) const { return bits == other.bits; }
+	};
+
+	struct PositionKeyHash {
+		size_t operator()(const PositionKey& key) const {
+			return static_cast<size_t>(util::hash64(key.bits.data(), sizeof(key.bits)));
+		}
+	};
+
+	u64 edgeKey(ui32 a, ui32 b) {
+		return (u64(a) << 32) | b;
+	}
+
+	math::vec3 triangleNormal(const math::vec3& a, const math::vec3& b, const math::vec3& c) {
+		return cross(b - a, c - a);
+	}
+
+}
+
+std::vector<ui32> MeshSimplifier::simplify(std::span<const ui32> indices,
+                                           std::span<const math::vec3> positions,
+                                           std::span<const math::vec3> normals,
+                                           std::span<const math::vec2> texcoords,
+                                           size_t targetIndexCount, float* error) {
+	std::vector<ui32> result(indices.begin(), indices.end());
+	if (error) *error = 0.0f;
+	const size_t vertexCount = positions.size();
+	if (result.size() <= targetIndexCount || vertexCount == 0) return result;
+
+	// Work in a unit-sized copy so errors and penalties are scale independent
+	math::vec3 min(std::numeric_limits<float>::max());
+	math::vec3 max(std::numeric_limits<float>::lowest());
+	for (const math::vec3& p : positions) {
+		for (int i = 0; i < 3; i++) {
+			min[i] = std::min(min[i], p[i]);
+			max[i] = std::max(max[i], p[i]);
+		}
+	}
+	const float scale = std::max({ max[0] - min[0], max[1] - min[1], max[2] - min[2], 1e-12f });
+	std::vector<math::vec3> pos(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++) {
+		pos[v] = (positions[v] - min) / scale;
+	}
+
+	// Vertices sharing a position are attribute seams - lock them
+	std::vector<ui32> positionClass(vertexCount);
+	std::vector<char> locked(vertexCount, false);
+	{
+		std::unordered_map<PositionKey, ui32, PositionKeyHash> firstAt;
+		std::vector<ui32> classSize(vertexCount, 0);
+		for (size_t v = 0; v < vertexCount; v++) {
+			PositionKey key;
+			std::memcpy(key.bits.data(), positions[v].data(), sizeof(key.bits));
+			positionClass[v] = firstAt.emplace(key, static_cast<ui32>(v)).first->second;
+			classSize[positionClass[v]]++;
+		}
+		for (size_t v = 0; v < vertexCount; v++) {
+			locked[v] = classSize[positionClass[v]] > 1;
+		}
+	}
+
+	// Edges used in only one direction are open borders - lock their vertices
+	{
+		std::unordered_set<u64> edges;
+		edges.reserve(result.size());
+		for (size_t i = 0; i < result.size(); i += 3) {
+			for (int k = 0; k < 3; k++) {
+				edges.insert(edgeKey(positionClass[result[i + k]], positionClass[result[i + (k + 1) % 3]]));
+			}
+		}
+		for (size_t i = 0; i < result.size(); i += 3) {
+			for (int k = 0; k < 3; k++) {
+				const ui32 a = result[i + k], b = result[i + (k + 1) % 3];
+				if (!edges.count(edgeKey(positionClass[b], positionClass[a]))) {
+					locked[a] = locked[b] = true;
+				}
+			}
+		}
+	}
+
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t i = 0; i < result.size(); i += 3) {
+		const ui32 a = result[i], b = result[i + 1], c = result[i + 2];
+		math::vec3 n = triangleNormal(pos[a], pos[b], pos[c]);
+		const float area = n.length();
+		if (area <= 0.0f) continue;
+		n /= area;
+		const float d = -dot(n, pos[a]);
+		quadrics[a].addPlane(n, d, area);
+		quadrics[b].addPlane(n, d, area);
+		quadrics[c].addPlane(n, d, area);
+	}
+
+	auto attributePenalty = [&](ui32 from, ui32 to) {
+		float penalty = 0.0f;
+		if (!normals.empty()) {
+			const math::vec3 diff = normals[from] - normals[to];
+			penalty += NORMAL_WEIGHT * dot(diff, diff);
+		}
+		if (!texcoords.empty()) {
+			const math::vec2 diff = texcoords[from] - texcoords[to];
+			penalty += TEXCOORD_WEIGHT * dot(diff, diff);
+		}
+		return penalty;
+	};
+
+	std::vector<ui32> remap(vertexCount);
+	std::vector<char> touched(vertexCount);
+	std::vector<ui32> adjacencyOffsets(vertexCount + 1);
+	std::vector<ui32> adjacency;
+	std::vector<Collapse> collapses;
+	float maxError = 0.0f;
+
+	while (result.size() > targetIndexCount) {
+		// every unlocked edge endpoint may collapse onto the other one
+		collapses.clear();
+		for (size_t i = 0; i < result.size(); i += 3) {
+			for (int k = 0; k < 3; k++) {
+				const ui32 a = result[i + k], b = result[i + (k + 1) % 3];
+				for (const auto& [from, to] : { std::pair{ a, b }, std::pair{ b, a } }) {
+					if (locked[from]) continue;
+					Quadric q = quadrics[from];
+					q += quadrics[to];
+					const float e = q.error(pos[to]);
+					collapses.push_back({ from, to, e + attributePenalty(from, to), e });
+				}
+			}
+		}
+		if (collapses.empty()) break;
+		std::sort(collapses.begin(), collapses.end(),
+			[](const Collapse& x, const Collapse& y) { return x.priority < y.priority; });
+
+		// triangles around every vertex
+		std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+		for (ui32 index : result) adjacencyOffsets[index + 1]++;
+		for (size_t v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+		adjacency.resize(result.size());
+		{
+			std::vector<ui32> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < result.size(); i++) {
+				adjacency[cursor[result[i]]++] = static_cast<ui32>(i / 3);
+			}
+		}
+
+		// apply the cheapest independent collapses: the neighbourhood of a
+		// collapsed vertex is left alone for the rest of the pass, so every
+		// flip test sees up to date triangles
+		for (size_t v = 0; v < vertexCount; v++) remap[v] = static_cast<ui32>(v);
+		std::fill(touched.begin(), touched.end(), false);
+		const size_t trianglesToRemove = (result.size() - targetIndexCount + 2) / 3;
+		size_t removed = 0;
+
+		for (const Collapse& c : collapses) {
+			if (touched[c.from] || touched[c.to]) continue;
+
+			bool flips = false;
+			size_t degenerate = 0;
+			for (ui32 a = adjacencyOffsets[c.from]; a < adjacencyOffsets[c.from + 1] && !flips; a++) {
+				const ui32* t = &result[adjacency[a] * 3];
+				if (t[0] == c.to || t[1] == c.to || t[2] == c.to) {
+					degenerate++;
+					continue;
+				}
+				math::vec3 moved[3];
+				for (int k = 0; k < 3; k++) moved[k] = pos[t[k] == c.from ? c.to : t[k]];
+				const math::vec3 before = triangleNormal(pos[t[0]], pos[t[1]], pos[t[2]]);
+				const math::vec3 after = triangleNormal(moved[0], moved[1], moved[2]);
+				flips = dot(before, after) <= 0.0f;
+			}
+			if (flips) continue;
+
+			remap[c.from] = c.to;
+			quadrics[c.to] += quadrics[c.from];
+			maxError = std::max(maxError, c.error);
+			for (ui32 a = adjacencyOffsets[c.from]; a < adjacencyOffsets[c.from + 1]; a++) {
+				const ui32* t = &result[adjacency[a] * 3];
+				touched[t[0]] = touched[t[1]] = touched[t[2]] = true;
+			}
+			removed += degenerate;
+			if (removed >= trianglesToRemove) break;
+		}
+		if (removed == 0) break;
+
+		// remap and drop the triangles that collapsed
+		size_t write = 0;
+		for (size_t i = 0; i < result.size(); i += 3) {
+			const ui32 a = remap[result[i]], b = remap[result[i + 1]], c = remap[result[i + 2]];
+			if (a == b || b == c || a == c) continue;
+			result[write++] = a;
+			result[write++] = b;
+			result[write++] = c;
+		}
+		result.resize(write);
+	}
+
+	if (error) *error = std::sqrt(maxError) * scale;
+	return result;
+}
+
+}
@@ -0,0 +1,189 @@
+#include <mgl/models/meshes/mglMeshlets.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace mgl {
+
+namespace {
+
+	// Smallest sphere around the cluster's AABB, grown to contain every vertex
+	void computeSphere(Meshlet& meshlet, std::span<const ui32> indices,
+	                   std::span<const math::vec3> positions) {
+		math::vec3 min(std::numeric_limits<float>::max());
+		math::vec3 max(std::numeric_limits<float>::lowest());
+		for (ui32 index : indices) {
+			for (int i = 0; i < 3; i++) {
+				min[i] = std::min(min[i], positions[index][i]);
+				max[i] = std::max(max[i], positions[index][i]);
+			}
+		}
+		meshlet.center = (min + max) * 0.5f;
+		float radius2 = 0.0f;
+		for (ui32 index : indices) {
+			radius2 = std::max(radius2, (positions[index] - meshlet.center).length2());
+		}
+		meshlet.radius = std::sqrt(radius2);
+	}
+
+	// Cone around the average triangle normal containing every triangle
+	// normal. coneCutoff is the sine of the angle between the cone and the
+	// tangent plane - 1 when the cluster is too curved to ever be back-facing
+	void computeCone(Meshlet& meshlet, std::span<const ui32> indices,
+	                 std::span<const math::vec3> positions) {
+		std::vector<math::vec3> normals;
+		normals.reserve(indices.size() / 3);
+		math::vec3 axis;
+		for (size_t i = 0; i < indices.size(); i += 3) {
+			const math::vec3& a = positions[indices[i]];
+			math::vec3 n = cross(positions[indices[i + 1]] - a, positions[indices[i + 2]] - a);
+			const float length = n.length();
+			if (length <= 0.0f) continue;
+			n /= length;
+			normals.push_back(n);
+			axis += n;
+		}
+		meshlet.coneCutoff = 1.0f;
+		const float axisLength = axis.length();
+		if (normals.empty() || axisLength <= 0.0f) {
+			meshlet.coneAxis = math::vec3(0.0f, 0.0f, 1.0f);
+			return;
+		}
+		axis /= axisLength;
+		meshlet.coneAxis = axis;
+
+		float minDot = 1.0f;
+		for (const math::vec3& n : normals) {
+			minDot = std::min(minDot, dot(n, axis));
+		}
+		// normals spread over more than ~84 degrees from the axis: never cull
+		if (minDot > 0.1f) {
+			meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+		}
+	}
+
+}
+
+std::vector<Meshlet> Meshlets::build(std::span<ui32> indices, std::span<const math::vec3> positions,
+                                     size_t maxVertices, size_t maxTriangles) {
+	std::vector<Meshlet> meshlets;
+	const size_t triangleCount = indices.size() / 3;
+	const size_t vertexCount = positions.size();
+	if (triangleCount == 0) return meshlets;
+	maxVertices = std::max<size_t>(maxVertices, 3);
+	maxTriangles = std::max<size_t>(maxTriangles, 1);
+
+	// triangles around every vertex
+	std::vector<ui32> adjacencyOffsets(vertexCount + 1, 0);
+	for (ui32 index : indices) adjacencyOffsets[index + 1]++;
+	for (size_t v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+	std::vector<ui32> adjacency(indices.size());
+	{
+		std::vector<ui32> cursor(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+		for (size_t i = 0; i < indices.size(); i++) {
+			adjacency[cursor[indices[i]]++] = static_cast<ui32>(i / 3);
+		}
+	}
+
+	std::vector<ui32> reordered;
+	reordered.reserve(indices.size());
+	std::vector<char> emitted(triangleCount, false);
+	// vertex -> index of the meshlet it was last added to, + 1
+	std::vector<ui32> inMeshlet(vertexCount, 0);
+	std::vector<ui32> candidates;
+	size_t nextSeed = 0;
+
+	while (reordered.size() < indices.size()) {
+		const ui32 meshletId = static_cast<ui32>(meshlets.size()) + 1;
+		const size_t base = reordered.size();
+		size_t vertices = 0, triangles = 0;
+		candidates.clear();
+
+		auto newVertices = [&](ui32 t) {
+			return (inMeshlet[indices[t * 3]] != meshletId) + (inMeshlet[indices[t * 3 + 1]] != meshletId) +
+			       (inMeshlet[indices[t * 3 + 2]] != meshletId);
+		};
+		auto emit = [&](ui32 t) {
+			emitted[t] = true;
+			for (int k = 0; k < 3; k++) {
+				const ui32 v = indices[t * 3 + k];
+				reordered.push_back(v);
+				if (inMeshlet[v] == meshletId) continue;
+				inMeshlet[v] = meshletId;
+				vertices++;
+				for (ui32 a = adjacencyOffsets[v]; a < adjacencyOffsets[v + 1]; a++) {
+					if (!emitted[adjacency[a]]) candidates.push_back(adjacency[a]);
+				}
+			}
+			triangles++;
+		};
+
+		while (nextSeed < triangleCount && emitted[nextSeed]) nextSeed++;
+		emit(static_cast<ui32>(nextSeed));
+
+		while (triangles < maxTriangles) {
+			// neighbour adding the fewest vertices that still fits, dropping
+			// candidates emitted in the meantime
+			size_t best = candidates.size();
+			int bestCost = 4;
+			size_t kept = 0;
+			for (size_t c = 0; c < candidates.size(); c++) {
+				const ui32 t = candidates[c];
+				if (emitted[t]) continue;
+				const int cost = newVertices(t);
+				if (cost < bestCost && vertices + cost <= maxVertices) {
+					best = kept;
+					bestCost = cost;
+				}
+				candidates[kept++] = t;
+			}
+			candidates.resize(kept);
+			if (best >= kept) break;
+			emit(candidates[best]);
+		}
+
+		Meshlet meshlet;
+		meshlet.baseIndex = static_cast<unsigned int>(base);
+		meshlet.n_indices = static_cast<unsigned int>(reordered.size() - base);
+		const std::span<const ui32> clusterIndices(reordered.data() + base, meshlet.n_indices);
+		computeSphere(meshlet, clusterIndices, positions);
+		computeCone(meshlet, clusterIndices, positions);
+		meshlets.push_back(meshlet);
+	}
+
+	std::copy(reordered.begin(), reordered.end(), indices.begin());
+	return meshlets;
+}
+
+std::array<math::vec4, 6> Meshlets::frustumPlanes(const math::mat4& m) {
+	// Gribb & Hartmann: each plane is the last row +/- one of the others
+	std::array<math::vec4, 6> planes;
+	for (int p = 0; p < 6; p++) {
+		const int row = p / 2;
+		const float sign = p % 2 == 0 ? 1.0f : -1.0f;
+		math::vec4 plane;
+		for (int c = 0; c < 4; c++) plane[c] = m(3, c) + sign * m(row, c);
+		const float length = math::vec3(plane[0], plane[1], plane[2]).length();
+		planes[p] = length > 0.0f ? plane / length : plane;
+	}
+	return planes;
+}
+
+bool Meshlets::isVisible(const Meshlet& meshlet, const std::array<math::vec4, 6>& planes,
+                         const math::vec3& cameraPosition, GLenum cullFace) {
+	for (const math::vec4& plane : planes) {
+		const float distance = plane[0] * meshlet.center[0] + plane[1] * meshlet.center[1] +
+		                       plane[2] * meshlet.center[2] + plane[3];
+		if (distance < -meshlet.radius) return false;
+	}
+	if (cullFace != GL_BACK && cullFace != GL_FRONT) return true;
+
+	// every triangle faces away when the camera lies inside the cone behind
+	// the cluster (in front of it, for front face culling)
+	const math::vec3 view = meshlet.center - cameraPosition;
+	const float facing = cullFace == GL_BACK ? 1.0f : -1.0f;
+	return facing * dot(view, meshlet.coneAxis) < meshlet.coneCutoff * view.length() + meshlet.radius;
+}
+
+}
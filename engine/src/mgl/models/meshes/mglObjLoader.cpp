@@ -0,0 +1,447 @@
+#include <mgl/models/meshes/mglObjLoader.hpp>
+#include <utils/Logger.hpp>
+#include <utils/ThreadPool.hpp>
+#include <utils/file.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstring>
+
+namespace mgl {
+
+namespace {
+
+	constexpr ui32 NONE = ~0u;
+
+	/// Object, group or material change before the face 'triangle' of a chunk
+	struct Event {
+		enum Kind { SECTION, MATERIAL } kind;
+		size_t triangle;
+		std::string material;
+	};
+
+	struct Chunk {
+		std::string_view text;
+
+		// pass 1: number of v / vt / vn lines, then their first index in the whole file
+		size_t positionCount = 0, texcoordCount = 0, normalCount = 0;
+		size_t positionBase = 0, texcoordBase = 0, normalBase = 0;
+
+		// pass 2: triangulated faces, 3 (v, vt, vn) corners per triangle
+		std::vector<ui32> corners;
+		std::vector<Event> events;
+		std::vector<std::pair<size_t, math::vec4>> colors;
+		std::vector<std::string> libraries;
+		const char* error = nullptr;
+	};
+
+	// Line-by-line cursor over a chunk
+	struct Line {
+		const char* p;
+		const char* end;
+
+		void skipSpaces() {
+			while (p < end && (*p == ' ' || *p == '\t')) p++;
+		}
+		bool atEnd() {
+			skipSpaces();
+			return p >= end;
+		}
+		std::string_view word() {
+			skipSpaces();
+			const char* start = p;
+			while (p < end && *p != ' ' && *p != '\t') p++;
+			return { start, static_cast<size_t>(p - start) };
+		}
+		std::string_view rest() {
+			skipSpaces();
+			const char* last = end;
+			while (last > p && (last[-1] == ' ' || last[-1] == '\t')) last--;
+			return { p, static_cast<size_t>(last - p) };
+		}
+		bool number(float& value) {
+			skipSpaces();
+			if (p < end && *p == '+') p++;
+			const auto [next, error] = std::from_chars(p, end, value);
+			if (error != std::errc()) return false;
+			p = next;
+			return true;
+		}
+	};
+
+	/// Calls fn(line) for every line of text, without its end of line and comment
+	template <typename F>
+	void forEachLine(std::string_view text, F&& fn) {
+		const char* p = text.data();
+		const char* const end = p + text.size();
+		while (p < end) {
+			const char* eol = static_cast<const char*>(std::memchr(p, '\n', end - p));
+			if (!eol) eol = end;
+			const char* last = eol;
+			if (const char* comment = static_cast<const char*>(std::memchr(p, '#', eol - p))) last = comment;
+			while (last > p && (last[-1] == '\r' || last[-1] == ' ' || last[-1] == '\t')) last--;
+			Line line{ p, last };
+			line.skipSpaces();
+			if (line.p < line.end && !fn(line)) return;
+			p = eol + 1;
+		}
+	}
+
+	bool isKeyword(const Line& line, const char* keyword, size_t length) {
+		return static_cast<size_t>(line.end - line.p) > length && std::memcmp(line.p, keyword, length) == 0 &&
+			(line.p[length] == ' ' || line.p[length] == '\t');
+	}
+
+	void countLines(Chunk& chunk) {
+		forEachLine(chunk.text, [&chunk](Line& line) {
+			if (line.p[0] == 'v') {
+				if (isKeyword(line, "v", 1)) chunk.positionCount++;
+				else if (isKeyword(line, "vt", 2)) chunk.texcoordCount++;
+				else if (isKeyword(line, "vn", 2)) chunk.normalCount++;
+			}
+			return true;
+		});
+	}
+
+	// OBJ index (1-based, or negative from the current end) to a 0-based one
+	bool resolveIndex(Line& line, size_t count, ui32& index) {
+		bool negative = false;
+		if (line.p < line.end && *line.p == '-') {
+			negative = true;
+			line.p++;
+		}
+		u64 value = 0;
+		const char* start = line.p;
+		while (line.p < line.end && *line.p >= '0' && *line.p <= '9') {
+			value = value * 10 + static_cast<u64>(*line.p - '0');
+			line.p++;
+		}
+		if (line.p == start || value == 0 || value > NONE) return false;
+		if (negative) {
+			if (value > count) return false;
+			index = static_cast<ui32>(count - value);
+		}
+		else {
+			index = static_cast<ui32>(value - 1);
+		}
+		return true;
+	}
+
+	void parseChunk(Chunk& chunk, std::vector<math::vec3>& positions, std::vector<math::vec2>& texcoords,
+	                std::vector<math::vec3>& normals, bool flipUVs) {
+		size_t position = chunk.positionBase, texcoord = chunk.texcoordBase, normal = chunk.normalBase;
+		std::vector<ui32> polygon;
+
+		forEachLine(chunk.text, [&](Line& line) {
+			const char* start = line.p;
+			const std::string_view keyword = line.word();
+			bool ok = true;
+			if (keyword == "v") {
+				math::vec3& p = positions[position];
+				ok = line.number(p[0]) && line.number(p[1]) && line.number(p[2]);
+				// optional w, or r g b vertex color
+				float extra[3];
+				int count = 0;
+				while (ok && count < 3 && !line.atEnd()) ok = line.number(extra[count++]);
+				if (ok && count == 3) {
+					chunk.colors.emplace_back(position, math::vec4(extra[0], extra[1], extra[2], 1.0f));
+				}
+				position++;
+			}
+			else if (keyword == "vt") {
+				math::vec2& t = texcoords[texcoord++];
+				ok = line.number(t[0]);
+				if (ok && !line.atEnd()) ok = line.number(t[1]);
+				else t[1] = 0.0f;
+				if (flipUVs) t[1] = 1.0f - t[1];
+			}
+			else if (keyword == "vn") {
+				math::vec3& n = normals[normal++];
+				ok = line.number(n[0]) && line.number(n[1]) && line.number(n[2]);
+			}
+			else if (keyword == "f") {
+				polygon.clear();
+				while (ok && !line.atEnd()) {
+					ui32 corner[3] = { NONE, NONE, NONE };
+					ok = resolveIndex(line, position, corner[0]);
+					if (ok && line.p < line.end && *line.p == '/') {
+						line.p++;
+						if (line.p < line.end && *line.p != '/') ok = resolveIndex(line, texcoord, corner[1]);
+						if (ok && line.p < line.end && *line.p == '/') {
+							line.p++;
+							ok = resolveIndex(line, normal, corner[2]);
+						}
+					}
+					polygon.insert(polygon.end(), corner, corner + 3);
+				}
+				const size_t count = polygon.size() / 3;
+				for (size_t c = 1; ok && c + 1 < count; c++) {
+					chunk.corners.insert(chunk.corners.end(), polygon.begin(), polygon.begin() + 3);
+					chunk.corners.insert(chunk.corners.end(), polygon.begin() + c * 3, polygon.begin() + c * 3 + 6);
+				}
+			}
+			else if (keyword == "o" || keyword == "g") {
+				chunk.events.push_back({ Event::SECTION, chunk.corners.size() / 9, {} });
+			}
+			else if (keyword == "usemtl") {
+				chunk.events.push_back({ Event::MATERIAL, chunk.corners.size() / 9, std::string(line.rest()) });
+			}
+			else if (keyword == "mtllib") {
+				chunk.libraries.emplace_back(line.rest());
+			}
+			// s, l, p and unknown statements are ignored
+			if (!ok) chunk.error = start;
+			return ok;
+		});
+	}
+
+	// Open addressing table from (v, vt, vn) corners to welded vertices
+	class CornerTable {
+	public:
+		explicit CornerTable(size_t corners)
+			: slots(std::bit_ceil(std::max<size_t>(corners * 2, 16))) {}
+
+		/// Vertex of the corner, or 'next' after inserting it
+		ui32 find(const ui32* corner, ui32 next) {
+			const size_t mask = slots.size() - 1;
+			u64 h = corner[0] * 0x9e3779b97f4a7c15ull;
+			h ^= (corner[1] + 0x632be59bd9b4e019ull) * 0xc2b2ae3d27d4eb4full;
+			h ^= (corner[2] + 0x165667b19e3779f9ull) * 0x94d049bb133111ebull;
+			for (size_t i = static_cast<size_t>(h ^ (h >> 29)) & mask;; i = (i + 1) & mask) {
+				Slot& slot = slots[i];
+				if (slot.vertex == NONE) {
+					std::memcpy(slot.corner, corner, sizeof(slot.corner));
+					slot.vertex = next;
+					return next;
+				}
+				if (std::memcmp(slot.corner, corner, sizeof(slot.corner)) == 0) return slot.vertex;
+			}
+		}
+
+	private:
+		struct Slot {
+			ui32 corner[3];
+			ui32 vertex = NONE;
+		};
+		std::vector<Slot> slots;
+	};
+
+	size_t lineNumber(std::string_view text, const char* at) {
+		return static_cast<size_t>(std::count(text.data(), at, '\n')) + 1;
+	}
+
+}
+
+std::vector<ObjLoader::Material> ObjLoader::parseMaterials(std::string_view text) {
+	std::vector<Material> materials;
+	forEachLine(text, [&materials](Line& line) {
+		const std::string_view keyword = line.word();
+		if (keyword == "newmtl") {
+			materials.push_back({});
+			materials.back().name = line.rest();
+			return true;
+		}
+		if (materials.empty()) return true;
+		Material& material = materials.back();
+		auto color = [&line](math::vec3& c) {
+			for (int i = 0; i < 3 && line.number(c[i]); i++) {}
+		};
+		if (keyword == "Ka") color(material.ambient);
+		else if (keyword == "Kd") color(material.diffuse);
+		else if (keyword == "Ks") color(material.specular);
+		else if (keyword == "Ns") line.number(material.shininess);
+		else if (keyword == "d") line.number(material.opacity);
+		else if (keyword == "Tr" && line.number(material.opacity)) material.opacity = 1.0f - material.opacity;
+		else if (keyword == "map_Kd") material.diffuseMap = line.rest();
+		return true;
+	});
+	return materials;
+}
+
+std::optional<ObjLoader::Model> ObjLoader::load(const std::filesystem::path& path) {
+	return load(path, Options());
+}
+
+std::optional<ObjLoader::Model> ObjLoader::parse(std::string_view text) {
+	return parse(text, Options());
+}
+
+std::optional<ObjLoader::Model> ObjLoader::load(const std::filesystem::path& path, const Options& options) {
+	const file::Resource source = file::vfs().open(path.string());
+	if (!source) {
+		MGL_ERROR("Could not read [{}]", path.string());
+		return std::nullopt;
+	}
+	const std::filesystem::path directory = path.has_parent_path() ? path.parent_path() : ".";
+	std::optional<Model> model = parse(source.text(), options, directory);
+	if (!model) {
+		MGL_ERROR("Error while parsing [{}]", path.string());
+	}
+	return model;
+}
+
+/*
+	Chunks end on line boundaries, so every statement is parsed by exactly
+	one worker. Merging walks the chunks in file order, starting a submesh
+	at every object, group or material change that follows some faces
+*/
+std::optional<ObjLoader::Model> ObjLoader::parse(std::string_view text, const Options& options,
+                                                 const std::filesystem::path& directory) {
+	util::ThreadPool& pool = util::ThreadPool::shared();
+	const size_t chunkCount = std::clamp<size_t>(text.size() / std::max<size_t>(options.chunkSize, 1),
+	                                             1, pool.size() * 4);
+	std::vector<Chunk> chunks(chunkCount);
+	size_t begin = 0;
+	for (size_t c = 0; c < chunkCount; c++) {
+		size_t end = c + 1 == chunkCount ? text.size() : std::max(begin, text.size() * (c + 1) / chunkCount);
+		while (end < text.size() && text[end - 1] != '\n') end++;
+		chunks[c].text = text.substr(begin, end - begin);
+		begin = end;
+	}
+
+	pool.parallelFor(chunkCount, [&chunks](size_t c, size_t) { countLines(chunks[c]); });
+	size_t positionCount = 0, texcoordCount = 0, normalCount = 0;
+	for (Chunk& chunk : chunks) {
+		chunk.positionBase = positionCount;
+		chunk.texcoordBase = texcoordCount;
+		chunk.normalBase = normalCount;
+		positionCount += chunk.positionCount;
+		texcoordCount += chunk.texcoordCount;
+		normalCount += chunk.normalCount;
+	}
+
+	std::vector<math::vec3> positions(positionCount), normals(normalCount);
+	std::vector<math::vec2> texcoords(texcoordCount);
+	pool.parallelFor(chunkCount, [&](size_t c, size_t) {
+		parseChunk(chunks[c], positions, texcoords, normals, options.flipUVs);
+	});
+	for (const Chunk& chunk : chunks) {
+		if (chunk.error) {
+			MGL_ERROR("Malformed OBJ statement at line {}",
+				lineNumber(text, chunk.text.data()) + lineNumber(chunk.text, chunk.error) - 1);
+			return std::nullopt;
+		}
+	}
+
+	Model model;
+	for (const Chunk& chunk : chunks) {
+		for (const std::string& library : chunk.libraries) {
+			if (directory.empty()) continue;
+			const file::Resource mtl = file::vfs().open((directory / library).string());
+			if (!mtl) {
+				MGL_WARN("Material library [{}] not found", (directory / library).string());
+				continue;
+			}
+			std::vector<Material> materials = parseMaterials(mtl.text());
+			std::move(materials.begin(), materials.end(), std::back_inserter(model.materials));
+		}
+	}
+	auto findMaterial = [&model](const std::string& name) {
+		for (size_t m = 0; m < model.materials.size(); m++) {
+			if (model.materials[m].name == name) return static_cast<i32>(m);
+		}
+		return -1;
+	};
+
+	// sections of faces: a new one starts at every object, group or
+	// material change that follows some faces
+	std::vector<size_t> triangleBase(chunkCount + 1, 0);
+	for (size_t c = 0; c < chunkCount; c++) {
+		triangleBase[c + 1] = triangleBase[c] + chunks[c].corners.size() / 9;
+	}
+	struct Section {
+		size_t begin = 0, end = 0; // triangles
+		i32 material = -1;
+		std::vector<ui32> corners = {}; // (v, vt, vn) of every welded vertex
+		std::vector<ui32> indices = {};
+		bool invalid = false;
+	};
+	std::vector<Section> sections;
+	size_t sectionBegin = 0;
+	i32 material = -1;
+	for (size_t c = 0; c < chunkCount; c++) {
+		for (const Event& event : chunks[c].events) {
+			const size_t triangle = triangleBase[c] + event.triangle;
+			if (triangle > sectionBegin) {
+				sections.push_back({ sectionBegin, triangle, material });
+				sectionBegin = triangle;
+			}
+			if (event.kind == Event::MATERIAL) material = findMaterial(event.material);
+		}
+	}
+	if (triangleBase[chunkCount] > sectionBegin) {
+		sections.push_back({ sectionBegin, triangleBase[chunkCount], material });
+	}
+
+	// weld the corners of every section into its own vertex range
+	pool.parallelFor(sections.size(), [&](size_t s, size_t) {
+		Section& section = sections[s];
+		CornerTable table((section.end - section.begin) * 3);
+		section.indices.reserve((section.end - section.begin) * 3);
+		size_t c = 0;
+		for (size_t t = section.begin; t < section.end; t++) {
+			while (triangleBase[c + 1] <= t) c++;
+			const ui32* triangle = &chunks[c].corners[(t - triangleBase[c]) * 9];
+			for (int k = 0; k < 3; k++) {
+				const ui32* corner = triangle + k * 3;
+				if (corner[0] >= positionCount || (corner[1] != NONE && corner[1] >= texcoordCount) ||
+					(corner[2] != NONE && corner[2] >= normalCount)) {
+					section.invalid = true;
+					return;
+				}
+				const ui32 next = static_cast<ui32>(section.corners.size() / 3);
+				const ui32 vertex = table.find(corner, next);
+				if (vertex == next) section.corners.insert(section.corners.end(), corner, corner + 3);
+				section.indices.push_back(vertex);
+			}
+		}
+	});
+
+	MeshData& mesh = model.mesh;
+	size_t vertexCount = 0;
+	bool hasTexcoords = false, hasNormals = false;
+	for (const Section& section : sections) {
+		if (section.invalid) {
+			MGL_ERROR("OBJ face index out of range");
+			return std::nullopt;
+		}
+		Submesh submesh;
+		submesh.baseVertex = static_cast<unsigned int>(vertexCount);
+		submesh.baseIndex = static_cast<unsigned int>(mesh.indices.size());
+		submesh.n_indices = static_cast<unsigned int>(section.indices.size());
+		mesh.submeshes.push_back(submesh);
+		model.submeshMaterials.push_back(section.material);
+		mesh.indices.insert(mesh.indices.end(), section.indices.begin(), section.indices.end());
+		vertexCount += section.corners.size() / 3;
+		for (size_t i = 0; i < section.corners.size(); i += 3) {
+			hasTexcoords |= section.corners[i + 1] != NONE;
+			hasNormals |= section.corners[i + 2] != NONE;
+		}
+	}
+
+	std::vector<math::vec4> colors;
+	for (const Chunk& chunk : chunks) {
+		if (chunk.colors.empty()) continue;
+		if (colors.empty()) colors.assign(positionCount, math::vec4(1.0f));
+		for (const auto& [position, color] : chunk.colors) colors[position] = color;
+	}
+
+	mesh.positions.resize(vertexCount);
+	if (hasTexcoords) mesh.texcoords.resize(vertexCount);
+	if (hasNormals) mesh.normals.resize(vertexCount);
+	if (!colors.empty()) mesh.colors.resize(vertexCount);
+	pool.parallelFor(sections.size(), [&](size_t s, size_t) {
+		const std::vector<ui32>& corners = sections[s].corners;
+		for (size_t i = 0, v = mesh.submeshes[s].baseVertex; i < corners.size(); i += 3, v++) {
+			const ui32* corner = &corners[i];
+			mesh.positions[v] = positions[corner[0]];
+			if (hasTexcoords) mesh.texcoords[v] = corner[1] != NONE ? texcoords[corner[1]] : math::vec2(0.0f);
+			if (hasNormals) mesh.normals[v] = corner[2] != NONE ? normals[corner[2]] : math::vec3(0.0f);
+			if (!colors.empty()) mesh.colors[v] = colors[corner[0]];
+		}
+	});
+	return model;
+}
+
+}
@@ -0,0 +1,110 @@
+#include <mgl/models/meshes/mglVertexQuantizer.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace mgl {
+
+VertexQuantizer::VertexQuantizer(const math::vec3& min, const math::vec3& max) : _origin(min) {
+	// flat axes still need a non-zero extent for the matrix to be invertible
+	const math::vec3 size = max - min;
+	const float largest = std::max({ size[0], size[1], size[2] });
+	const float minExtent = std::max(largest * 1e-4f, 1e-6f);
+	for (int i = 0; i < 3; i++) {
+		_extent[i] = std::max(size[i], minExtent);
+	}
+	_dequantization = math::scale(math::translate(math::mat4::identity(), _origin), _extent);
+}
+
+VertexQuantizer VertexQuantizer::fromPositions(std::span<const math::vec3> positions) {
+	if (positions.empty()) {
+		return VertexQuantizer(math::vec3(), math::vec3());
+	}
+	math::vec3 min(std::numeric_limits<float>::max());
+	math::vec3 max(std::numeric_limits<float>::lowest());
+	for (const math::vec3& p : positions) {
+		for (int i = 0; i < 3; i++) {
+			min[i] = std::min(min[i], p[i]);
+			max[i] = std::max(max[i], p[i]);
+		}
+	}
+	return VertexQuantizer(min, max);
+}
+
+void VertexQuantizer::position(const math::vec3& p, u16 out[4]) const {
+	for (int i = 0; i < 3; i++) {
+		const float t = std::clamp((p[i] - _origin[i]) / _extent[i], 0.0f, 1.0f);
+		out[i] = static_cast<u16>(std::lround(t * 65535.0f));
+	}
+	out[3] = 0;
+}
+
+ui32 VertexQuantizer::normal(const math::vec3& n) const {
+	// transformed by the inverse transpose of the dequantization scale, the
+	// stored direction becomes n again
+	math::vec3 scaled(n[0] * _extent[0], n[1] * _extent[1], n[2] * _extent[2]);
+	scaled = scaled.normalized();
+
+	ui32 packed = 0;
+	for (int i = 0; i < 3; i++) {
+		const long value = std::lround(std::clamp(scaled[i], -1.0f, 1.0f) * 511.0f);
+		packed |= (static_cast<ui32>(value) & 0x3ffu) << (10 * i);
+	}
+	return packed;
+}
+
+u16 VertexQuantizer::toHalf(float value) {
+	ui32 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	const ui32 sign = (bits >> 16) & 0x8000u;
+	const ui32 magnitude = bits & 0x7fffffffu;
+
+	if (magnitude >= 0x7f800000u) {                    // inf / nan
+		return static_cast<u16>(sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u));
+	}
+	if (magnitude >= 0x477ff000u) {                    // rounds past 65504
+		return static_cast<u16>(sign | 0x7c00u);
+	}
+	if (magnitude < 0x38800000u) {                     // half subnormal or zero
+		if (magnitude < 0x33000000u) return static_cast<u16>(sign);
+		const ui32 shift = 126 - (magnitude >> 23);
+		const ui32 mantissa = (magnitude & 0x7fffffu) | 0x800000u;
+		ui32 half = mantissa >> shift;
+		const ui32 rest = mantissa & ((1u << shift) - 1);
+		const ui32 halfway = 1u << (shift - 1);
+		if (rest > halfway || (rest == halfway && (half & 1u))) half++;
+		return static_cast<u16>(sign | half);
+	}
+
+	// rebias the exponent and round to nearest even
+	ui32 half = (magnitude - 0x38000000u) >> 13;
+	const ui32 rest = magnitude & 0x1fffu;
+	if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) half++;
+	return static_cast<u16>(sign | half);
+}
+
+float VertexQuantizer::fromHalf(u16 value) {
+	const ui32 sign = static_cast<ui32>(value & 0x8000u) << 16;
+	const ui32 exponent = (value >> 10) & 0x1fu;
+	const ui32 mantissa = value & 0x3ffu;
+
+	if (exponent == 0) {
+		const float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+		return sign ? -magnitude : magnitude;
+	}
+	const ui32 bits = exponent == 31 ? sign | 0x7f800000u | (mantissa << 13)
+	                                 : sign | ((exponent + 112) << 23) | (mantissa << 13);
+	float result;
+	std::memcpy(&result, &bits, sizeof(result));
+	return result;
+}
+
+void VertexQuantizer::color(const math::vec4& c, u8 out[4]) {
+	for (int i = 0; i < 4; i++) {
+		out[i] = static_cast<u8>(std::lround(std::clamp(c[i], 0.0f, 1.0f) * 255.0f));
+	}
+}
+
+}
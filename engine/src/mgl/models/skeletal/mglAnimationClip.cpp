@@ -0,0 +1,131 @@
+#include <mgl/models/skeletal/mglAnimationClip.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mgl {
+
+namespace {
+
+	// Keys around 'time' and the blend factor between them
+	template <typename Key>
+	std::pair<size_t, float> locate(const std::vector<Key>& keys, float time) {
+		const auto next = std::upper_bound(keys.begin(), keys.end(), time,
+			[](float t, const Key& key) { return t < key.time; });
+		if (next == keys.begin()) return { 0, 0.0f };
+		if (next == keys.end()) return { keys.size() - 1, 0.0f };
+		const size_t k = static_cast<size_t>(next - keys.begin()) - 1;
+		const float span = keys[k + 1].time - keys[k].time;
+		return { k, span > 0.0f ? (time - keys[k].time) / span : 0.0f };
+	}
+
+	math::vec3 sampleVector(const std::vector<AnimationClip::VectorKey>& keys, float time, const math::vec3& fallback) {
+		if (keys.empty()) return fallback;
+		const auto [k, t] = locate(keys, time);
+		if (t == 0.0f) return keys[k].value;
+		return keys[k].value + (keys[k + 1].value - keys[k].value) * t;
+	}
+
+	float sampleWeight(const std::vector<AnimationClip::WeightKey>& keys, float time) {
+		const auto [k, t] = locate(keys, time);
+		if (t == 0.0f) return keys[k].value;
+		return keys[k].value + (keys[k + 1].value - keys[k].value) * t;
+	}
+
+	math::quat sampleRotation(const std::vector<AnimationClip::RotationKey>& keys, float time) {
+		if (keys.empty()) return math::quat::identity();
+		const auto [k, t] = locate(keys, time);
+		if (t == 0.0f) return keys[k].value;
+		return slerp(keys[k].value, keys[k + 1].value, t).normalized();
+	}
+
+}
+
+/*
+	Channels without keys of a kind keep the bind pose translation and
+	scale, and the identity rotation, as imported files do
+*/
+void AnimationClip::sample(float time, std::span<math::mat4> local) const {
+	for (const Channel& channel : channels) {
+		if (channel.bone < 0 || static_cast<size_t>(channel.bone) >= local.size()) continue;
+		math::mat4& transform = local[channel.bone];
+
+		math::vec3 bindTranslation(transform(0, 3), transform(1, 3), transform(2, 3));
+		math::vec3 bindScale;
+		for (int c = 0; c < 3; c++) {
+			bindScale[c] = math::vec3(transform(0, c), transform(1, c), transform(2, c)).length();
+		}
+		const math::vec3 translation = sampleVector(channel.translations, time, bindTranslation);
+		const math::vec3 scale = sampleVector(channel.scales, time, bindScale);
+		const math::quat rotation = sampleRotation(channel.rotations, time);
+
+		// T * R * S
+		transform = rotation.toMat4();
+		for (int r = 0; r < 3; r++) {
+			for (int c = 0; c < 3; c++) transform(r, c) *= scale[c];
+			transform(r, 3) = translation[r];
+		}
+	}
+}
+
+void AnimationClip::sampleWeights(float time, std::span<float> weights) const {
+	for (const MorphChannel& channel : morphChannels) {
+		if (channel.target < 0 || static_cast<size_t>(channel.target) >= weights.size() ||
+			channel.weights.empty()) continue;
+		weights[channel.target] = sampleWeight(channel.weights, time);
+	}
+}
+
+Animator::Animator(const Skeleton& skeleton)
+	: skeleton(&skeleton), local(skeleton.size()), global(skeleton.size()), palette(skeleton.size()) {
+	skeleton.bindPose(local);
+	skeleton.computePalette(local, global, palette);
+}
+
+void Animator::play(const AnimationClip* clip, bool loop) {
+	this->clip = clip;
+	this->loop = loop;
+	time = 0.0f;
+}
+
+void Animator::setSpeed(float speed) {
+	this->speed = speed;
+}
+
+float Animator::getTime() const {
+	return time;
+}
+
+void Animator::update(float seconds) {
+	skeleton->bindPose(local);
+	if (clip) {
+		time += seconds * speed;
+		if (clip->duration > 0.0f) {
+			time = loop ? std::fmod(time, clip->duration) : std::min(time, clip->duration);
+			if (time < 0.0f) time += clip->duration;
+		}
+		clip->sample(time, local);
+	}
+	skeleton->computePalette(local, global, palette);
+
+	if (!weights.empty()) {
+		std::copy(restWeights.begin(), restWeights.end(), weights.begin());
+		if (clip) clip->sampleWeights(time, weights);
+	}
+}
+
+std::span<const math::mat4> Animator::getPalette() const {
+	return palette;
+}
+
+void Animator::setMorphWeights(std::span<const float> rest) {
+	restWeights.assign(rest.begin(), rest.end());
+	weights = restWeights;
+	if (clip) clip->sampleWeights(time, weights);
+}
+
+std::span<const float> Animator::getMorphWeights() const {
+	return weights;
+}
+
+}
@@ -0,0 +1,77 @@
+#include <mgl/models/skeletal/mglBonePalette.hpp>
+#include <mgl/mglConventions.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace mgl {
+
+BonePalette::BonePalette() {
+	glGenBuffers(1, &buffer);
+	glGenTextures(1, &texture);
+}
+
+BonePalette::~BonePalette() {
+	glDeleteTextures(1, &texture);
+	glDeleteBuffers(1, &buffer);
+}
+
+ui32 BonePalette::allocate(size_t boneCount) {
+	const size_t offset = matrices.size();
+	matrices.resize(offset + boneCount, math::mat4::identity());
+	return static_cast<ui32>(offset);
+}
+
+void BonePalette::clear() {
+	matrices.clear();
+}
+
+size_t BonePalette::size() const {
+	return matrices.size();
+}
+
+void BonePalette::write(ui32 offset, std::span<const math::mat4> palette) {
+	if (offset + palette.size() > matrices.size()) {
+		throw std::out_of_range("BonePalette::write: palette past the reserved bones");
+	}
+	std::copy(palette.begin(), palette.end(), matrices.begin() + offset);
+}
+
+/*
+	The store is orphaned every frame, so the driver never waits for draws
+	of the previous frame still reading it
+*/
+void BonePalette::upload() {
+	if (matrices.empty()) return;
+	const size_t bytes = matrices.size() * sizeof(math::mat4);
+	glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+	if (matrices.size() > capacity) {
+		capacity = matrices.size();
+		glBufferData(GL_TEXTURE_BUFFER, bytes, matrices.data(), GL_STREAM_DRAW);
+		glBindTexture(GL_TEXTURE_BUFFER, texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+	}
+	else {
+		glBufferData(GL_TEXTURE_BUFFER, capacity * sizeof(math::mat4), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_TEXTURE_BUFFER, 0, bytes, matrices.data());
+	}
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void BonePalette::bind(GLuint unit) const {
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_BUFFER, texture);
+}
+
+void BonePalette::setUniforms(ShaderProgram& shaders, GLuint unit, ui32 offset) const {
+	bind(unit);
+	if (shaders.isUniform(BONE_PALETTE)) {
+		shaders.setUniform(BONE_PALETTE, static_cast<i32>(unit));
+	}
+	if (shaders.isUniform(BONE_OFFSET)) {
+		shaders.setUniform(BONE_OFFSET, static_cast<i32>(offset));
+	}
+}
+
+}
@@ -0,0 +1,95 @@
+#include <mgl/models/skeletal/mglMorphTargetBuffer.hpp>
+#include <mgl/mglConventions.hpp>
+
+#include <stdexcept>
+#include <vector>
+
+namespace mgl {
+
+namespace {
+
+	enum Texture { RANGES, DELTAS };
+
+	void upload(GLuint buffer, GLuint texture, GLenum format, const void* data, size_t bytes) {
+		glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+		glBufferData(GL_TEXTURE_BUFFER, bytes, data, GL_STATIC_DRAW);
+		glBindTexture(GL_TEXTURE_BUFFER, texture);
+		glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+		glBindTexture(GL_TEXTURE_BUFFER, 0);
+		glBindBuffer(GL_TEXTURE_BUFFER, 0);
+	}
+
+}
+
+MorphTargetBuffer::MorphTargetBuffer() {
+	glGenBuffers(2, buffers);
+	glGenTextures(2, textures);
+}
+
+MorphTargetBuffer::~MorphTargetBuffer() {
+	glDeleteTextures(2, textures);
+	glDeleteBuffers(2, buffers);
+}
+
+/*
+	Counting sort of the deltas by vertex: count them, turn the counts into
+	first indices, then scatter every target's deltas into place
+*/
+void MorphTargetBuffer::create(const MorphTargets& targets) {
+	const size_t vertexCount = targets.getVertexCount();
+	std::vector<ui32> ranges(vertexCount * 2, 0);
+	for (size_t t = 0; t < targets.size(); t++) {
+		for (ui32 vertex : targets.getVertices(t)) ranges[vertex * 2 + 1]++;
+	}
+	ui32 first = 0;
+	for (size_t v = 0; v < vertexCount; v++) {
+		ranges[v * 2] = first;
+		first += ranges[v * 2 + 1];
+	}
+
+	std::vector<float> deltas(size_t(first) * 8, 0.0f);
+	std::vector<ui32> cursor(vertexCount);
+	for (size_t v = 0; v < vertexCount; v++) cursor[v] = ranges[v * 2];
+	for (size_t t = 0; t < targets.size(); t++) {
+		const std::span<const ui32> vertices = targets.getVertices(t);
+		const std::span<const float> positions = targets.getPositionDeltas(t);
+		const std::span<const float> normals = targets.getNormalDeltas(t);
+		for (size_t i = 0; i < vertices.size(); i++) {
+			float* delta = &deltas[size_t(cursor[vertices[i]]++) * 8];
+			for (int c = 0; c < 3; c++) {
+				delta[c] = positions[i * 4 + c];
+				if (!normals.empty()) delta[4 + c] = normals[i * 4 + c];
+			}
+			delta[3] = static_cast<float>(t);
+		}
+	}
+
+	upload(buffers[RANGES], textures[RANGES], GL_RG32UI, ranges.data(), ranges.size() * sizeof(ui32));
+	upload(buffers[DELTAS], textures[DELTAS], GL_RGBA32F, deltas.data(), deltas.size() * sizeof(float));
+	targetCount = targets.size();
+}
+
+size_t MorphTargetBuffer::size() const {
+	return targetCount;
+}
+
+void MorphTargetBuffer::setUniforms(ShaderProgram& shaders, GLuint unit, std::span<const float> weights) const {
+	if (weights.size() != targetCount) {
+		throw std::invalid_argument("MorphTargetBuffer::setUniforms: one weight per target is needed");
+	}
+	for (GLuint t = 0; t < 2; t++) {
+		glActiveTexture(GL_TEXTURE0 + unit + t);
+		glBindTexture(GL_TEXTURE_BUFFER, textures[t]);
+	}
+	if (shaders.isUniform(MORPH_RANGES)) {
+		shaders.setUniform(MORPH_RANGES, static_cast<i32>(unit));
+	}
+	if (shaders.isUniform(MORPH_DELTAS)) {
+		shaders.setUniform(MORPH_DELTAS, static_cast<i32>(unit + 1));
+	}
+	if (shaders.isUniform(MORPH_WEIGHTS) && !weights.empty()) {
+		shaders.setUniform(MORPH_WEIGHTS, weights);
+	}
+}
+
+}
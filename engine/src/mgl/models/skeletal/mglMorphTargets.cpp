@@ -0,0 +1,182 @@
+#include <mgl/models/skeletal/mglMorphTargets.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MGL_MORPH_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace mgl {
+
+namespace {
+
+	constexpr size_t STRIDE = 4;
+
+	void pack(const math::vec3& v, std::vector<float>& out) {
+		out.insert(out.end(), { v[0], v[1], v[2], 0.0f });
+	}
+
+	// accumulator[vertex] += weight * delta, 4 floats per vertex
+	void accumulate(float* accumulator, std::span<const ui32> vertices, const float* deltas, float weight) {
+#ifdef MGL_MORPH_SSE
+		const __m128 w = _mm_set1_ps(weight);
+		for (size_t i = 0; i < vertices.size(); i++) {
+			float* a = accumulator + size_t(vertices[i]) * STRIDE;
+			_mm_storeu_ps(a, _mm_add_ps(_mm_loadu_ps(a), _mm_mul_ps(w, _mm_loadu_ps(deltas + i * STRIDE))));
+		}
+#else
+		for (size_t i = 0; i < vertices.size(); i++) {
+			float* a = accumulator + size_t(vertices[i]) * STRIDE;
+			const float* d = deltas + i * STRIDE;
+			a[0] += weight * d[0];
+			a[1] += weight * d[1];
+			a[2] += weight * d[2];
+		}
+#endif
+	}
+
+}
+
+MorphTarget MorphTarget::fromDense(std::string name,
+                                   std::span<const math::vec3> basePositions,
+                                   std::span<const math::vec3> targetPositions,
+                                   std::span<const math::vec3> baseNormals,
+                                   std::span<const math::vec3> targetNormals,
+                                   float epsilon) {
+	if (targetPositions.size() != basePositions.size() || baseNormals.size() != targetNormals.size() ||
+		(!baseNormals.empty() && baseNormals.size() != basePositions.size())) {
+		throw std::invalid_argument("MorphTarget::fromDense: attribute sizes do not match");
+	}
+	MorphTarget target;
+	target.name = std::move(name);
+	const float epsilon2 = epsilon * epsilon;
+	for (size_t v = 0; v < basePositions.size(); v++) {
+		const math::vec3 position = targetPositions[v] - basePositions[v];
+		const math::vec3 normal = baseNormals.empty() ? math::vec3(0.0f) : targetNormals[v] - baseNormals[v];
+		if (dot(position, position) <= epsilon2 && dot(normal, normal) <= epsilon2) continue;
+		target.vertices.push_back(static_cast<ui32>(v));
+		target.positions.push_back(position);
+		if (!baseNormals.empty()) target.normals.push_back(normal);
+	}
+	return target;
+}
+
+MorphTargets::MorphTargets(size_t vertexCount)
+	: vertexCount(vertexCount) {}
+
+i32 MorphTargets::addTarget(const MorphTarget& target) {
+	if (targets.size() >= MAX_TARGETS) {
+		throw std::length_error("MorphTargets::addTarget: more than 64 targets");
+	}
+	if (target.positions.size() != target.vertices.size() ||
+		(!target.normals.empty() && target.normals.size() != target.vertices.size())) {
+		throw std::invalid_argument("MorphTargets::addTarget: one delta per vertex is needed");
+	}
+	for (ui32 vertex : target.vertices) {
+		if (vertex >= vertexCount) throw std::out_of_range("MorphTargets::addTarget: vertex out of range");
+	}
+
+	// the first target with normals adds zero normal deltas to the previous ones
+	if (!target.normals.empty() && normalDeltas.empty()) {
+		normalDeltas.assign(positionDeltas.size(), 0.0f);
+	}
+	targets.push_back({ target.name, vertices.size(), target.vertices.size() });
+	vertices.insert(vertices.end(), target.vertices.begin(), target.vertices.end());
+	for (size_t i = 0; i < target.vertices.size(); i++) {
+		pack(target.positions[i], positionDeltas);
+		if (!normalDeltas.empty()) pack(target.normals.empty() ? math::vec3(0.0f) : target.normals[i], normalDeltas);
+	}
+	return static_cast<i32>(targets.size() - 1);
+}
+
+i32 MorphTargets::find(const std::string& name) const {
+	for (size_t t = 0; t < targets.size(); t++) {
+		if (targets[t].name == name) return static_cast<i32>(t);
+	}
+	return -1;
+}
+
+const std::string& MorphTargets::getName(size_t target) const {
+	return targets.at(target).name;
+}
+
+size_t MorphTargets::size() const {
+	return targets.size();
+}
+
+size_t MorphTargets::getVertexCount() const {
+	return vertexCount;
+}
+
+bool MorphTargets::hasNormals() const {
+	return !normalDeltas.empty();
+}
+
+std::span<const ui32> MorphTargets::getVertices(size_t target) const {
+	const Target& t = targets.at(target);
+	return std::span<const ui32>(vertices).subspan(t.first, t.count);
+}
+
+std::span<const float> MorphTargets::getPositionDeltas(size_t target) const {
+	const Target& t = targets.at(target);
+	return std::span<const float>(positionDeltas).subspan(t.first * STRIDE, t.count * STRIDE);
+}
+
+std::span<const float> MorphTargets::getNormalDeltas(size_t target) const {
+	const Target& t = targets.at(target);
+	if (normalDeltas.empty()) return {};
+	return std::span<const float>(normalDeltas).subspan(t.first * STRIDE, t.count * STRIDE);
+}
+
+size_t MorphTargets::getMemoryUsage() const {
+	return vertices.size() * sizeof(ui32) + (positionDeltas.size() + normalDeltas.size()) * sizeof(float);
+}
+
+/*
+	Deltas are summed into a dense 4-float accumulator per vertex (so every
+	delta is one unaligned SIMD load/add/store), then added to the base mesh
+	in a single pass over the vertices
+*/
+void MorphTargets::apply(std::span<const float> weights,
+                         std::span<const math::vec3> basePositions, std::span<const math::vec3> baseNormals,
+                         std::span<math::vec3> outPositions, std::span<math::vec3> outNormals) const {
+	if (weights.size() != targets.size() || basePositions.size() != vertexCount ||
+		outPositions.size() != vertexCount || baseNormals.size() != outNormals.size() ||
+		(!baseNormals.empty() && baseNormals.size() != vertexCount)) {
+		throw std::invalid_argument("MorphTargets::apply: attribute sizes do not match");
+	}
+
+	thread_local std::vector<float> positionSum, normalSum;
+	const bool normals = !baseNormals.empty() && hasNormals();
+	positionSum.assign(vertexCount * STRIDE, 0.0f);
+	if (normals) normalSum.assign(vertexCount * STRIDE, 0.0f);
+
+	for (size_t t = 0; t < targets.size(); t++) {
+		if (weights[t] == 0.0f) continue;
+		const Target& target = targets[t];
+		const std::span<const ui32> changed = std::span<const ui32>(vertices).subspan(target.first, target.count);
+		accumulate(positionSum.data(), changed, positionDeltas.data() + target.first * STRIDE, weights[t]);
+		if (normals) accumulate(normalSum.data(), changed, normalDeltas.data() + target.first * STRIDE, weights[t]);
+	}
+
+	for (size_t v = 0; v < vertexCount; v++) {
+		const float* p = &positionSum[v * STRIDE];
+		outPositions[v] = basePositions[v] + math::vec3(p[0], p[1], p[2]);
+	}
+	if (baseNormals.empty()) return;
+	for (size_t v = 0; v < vertexCount; v++) {
+		math::vec3 normal = baseNormals[v];
+		if (normals) {
+			const float* n = &normalSum[v * STRIDE];
+			normal += math::vec3(n[0], n[1], n[2]);
+			const float length = normal.length();
+			if (length > 0.0f) normal /= length;
+		}
+		outNormals[v] = normal;
+	}
+}
+
+}
@@ -0,0 +1,106 @@
+#include <mgl/models/skeletal/mglSkeleton.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace mgl {
+
+i32 Skeleton::addBone(const Bone& bone) {
+	if (bones.size() >= MAX_BONES) {
+		throw std::length_error("Skeleton::addBone: more than 256 bones");
+	}
+	if (bone.parent >= static_cast<i32>(bones.size())) {
+		throw std::invalid_argument("Skeleton::addBone: parent must be added before its children");
+	}
+	bones.push_back(bone);
+	return static_cast<i32>(bones.size() - 1);
+}
+
+i32 Skeleton::find(const std::string& name) const {
+	for (size_t b = 0; b < bones.size(); b++) {
+		if (bones[b].name == name) return static_cast<i32>(b);
+	}
+	return -1;
+}
+
+const Bone& Skeleton::getBone(size_t index) const {
+	return bones.at(index);
+}
+
+size_t Skeleton::size() const {
+	return bones.size();
+}
+
+void Skeleton::setRootTransform(const math::mat4& transform) {
+	root = transform;
+}
+
+void Skeleton::bindPose(std::span<math::mat4> local) const {
+	for (size_t b = 0; b < bones.size() && b < local.size(); b++) {
+		local[b] = bones[b].bindLocal;
+	}
+}
+
+void Skeleton::computePalette(std::span<const math::mat4> local, std::span<math::mat4> global,
+                              std::span<math::mat4> palette) const {
+	if (local.size() < bones.size() || global.size() < bones.size() || palette.size() < bones.size()) {
+		throw std::invalid_argument("Skeleton::computePalette: one transform per bone is needed");
+	}
+	for (size_t b = 0; b < bones.size(); b++) {
+		const i32 parent = bones[b].parent;
+		global[b] = parent < 0 ? local[b] : global[parent] * local[b];
+		palette[b] = root * global[b] * bones[b].inverseBind;
+	}
+}
+
+SkinBuilder::SkinBuilder(size_t vertexCount) : vertices(vertexCount) {}
+
+void SkinBuilder::addInfluence(size_t vertex, ui32 bone, float weight) {
+	if (vertex >= vertices.size()) {
+		throw std::out_of_range("SkinBuilder::addInfluence: vertex out of range");
+	}
+	if (bone >= Skeleton::MAX_BONES) {
+		throw std::out_of_range("SkinBuilder::addInfluence: bone out of range");
+	}
+	if (!(weight > 0.0f)) return;
+
+	// replace the weakest influence, if weaker than this one
+	Influences& influences = vertices[vertex];
+	int weakest = 0;
+	for (int i = 1; i < 4; i++) {
+		if (influences.weights[i] < influences.weights[weakest]) weakest = i;
+	}
+	if (influences.weights[weakest] < weight) {
+		influences.bones[weakest] = bone;
+		influences.weights[weakest] = weight;
+	}
+}
+
+std::vector<VertexSkin> SkinBuilder::build() const {
+	std::vector<VertexSkin> skin(vertices.size());
+	for (size_t v = 0; v < vertices.size(); v++) {
+		Influences sorted = vertices[v];
+		int order[4] = { 0, 1, 2, 3 };
+		std::sort(order, order + 4, [&](int a, int b) { return sorted.weights[a] > sorted.weights[b]; });
+
+		float total = 0.0f;
+		for (float w : sorted.weights) total += w;
+		if (total <= 0.0f) {
+			skin[v].weights[0] = 255; // unskinned vertices follow bone 0
+			continue;
+		}
+		// round, then give the rounding error to the strongest bone so weights add up to 255
+		int sum = 0;
+		for (int i = 0; i < 4; i++) {
+			skin[v].bones[i] = static_cast<u8>(sorted.bones[order[i]]);
+			const int weight = static_cast<int>(std::lround(sorted.weights[order[i]] / total * 255.0f));
+			skin[v].weights[i] = static_cast<u8>(weight);
+			sum += weight;
+		}
+		skin[v].weights[0] = static_cast<u8>(skin[v].weights[0] + 255 - sum);
+	}
+	return skin;
+}
+
+}
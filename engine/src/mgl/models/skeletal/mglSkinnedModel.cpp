@@ -0,0 +1,273 @@
+#include <mgl/models/skeletal/mglSkinnedModel.hpp>
+#include <utils/Logger.hpp>
+#include <utils/AssimpIO.hpp>
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mgl {
+
+namespace {
+
+	constexpr unsigned int IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices |
+	                                      aiProcess_LimitBoneWeights | aiProcess_GenSmoothNormals;
+	constexpr double DEFAULT_TICKS_PER_SECOND = 25.0;
+
+	math::mat4 toMat4(const aiMatrix4x4& m) {
+		math::mat4 result;
+		for (int r = 0; r < 4; r++) {
+			for (int c = 0; c < 4; c++) result(r, c) = m[r][c];
+		}
+		return result;
+	}
+
+	math::vec3 toVec3(const aiVector3D& v) {
+		return math::vec3(v.x, v.y, v.z);
+	}
+
+	// Adds the needed nodes below 'node' (included) to the skeleton, parents first
+	void addBones(const aiNode* node, i32 parent, const std::unordered_set<const aiNode*>& needed,
+	              const std::unordered_map<std::string, math::mat4>& inverseBinds, Skeleton& skeleton) {
+		if (!needed.count(node)) return;
+		Bone bone;
+		bone.name = node->mName.C_Str();
+		bone.parent = parent;
+		bone.bindLocal = toMat4(node->mTransformation);
+		const auto inverseBind = inverseBinds.find(bone.name);
+		bone.inverseBind = inverseBind != inverseBinds.end() ? inverseBind->second : math::mat4::identity();
+		const i32 index = skeleton.addBone(bone);
+		for (unsigned int c = 0; c < node->mNumChildren; c++) {
+			addBones(node->mChildren[c], index, needed, inverseBinds, skeleton);
+		}
+	}
+
+	void buildSkeleton(const aiScene* scene, Skeleton& skeleton) {
+		std::unordered_map<std::string, math::mat4> inverseBinds;
+		std::unordered_set<const aiNode*> needed;
+		for (unsigned int m = 0; m < scene->mNumMeshes; m++) {
+			const aiMesh* mesh = scene->mMeshes[m];
+			for (unsigned int b = 0; b < mesh->mNumBones; b++) {
+				const aiBone* bone = mesh->mBones[b];
+				inverseBinds.emplace(bone->mName.C_Str(), toMat4(bone->mOffsetMatrix));
+				for (const aiNode* node = scene->mRootNode->FindNode(bone->mName); node; node = node->mParent) {
+					if (!needed.insert(node).second) break;
+				}
+			}
+		}
+		addBones(scene->mRootNode, -1, needed, inverseBinds, skeleton);
+		skeleton.setRootTransform(math::inverse(toMat4(scene->mRootNode->mTransformation)));
+	}
+
+	// First morph target of every mesh, by mesh name and by the names of the nodes using it
+	using MorphOffsets = std::unordered_map<std::string, i32>;
+
+	void mapMorphNodes(const aiNode* node, const std::vector<i32>& firstTargets,
+	                   MorphOffsets& offsets) {
+		if (node->mNumMeshes > 0 && firstTargets[node->mMeshes[0]] >= 0) {
+			offsets.emplace(node->mName.C_Str(), firstTargets[node->mMeshes[0]]);
+		}
+		for (unsigned int c = 0; c < node->mNumChildren; c++) {
+			mapMorphNodes(node->mChildren[c], firstTargets, offsets);
+		}
+	}
+
+	/*
+		aiAnimMesh stores whole replacement attributes: keep only what they
+		change, with vertex indices in the merged geometry
+	*/
+	void readMorphTargets(const aiMesh* mesh, size_t baseVertex, SkinnedModel& model) {
+		const MeshData& data = model.mesh;
+		const std::span<const math::vec3> basePositions(data.positions.data() + baseVertex, mesh->mNumVertices);
+		std::span<const math::vec3> baseNormals;
+		if (!data.normals.empty() && mesh->HasNormals()) {
+			baseNormals = { data.normals.data() + baseVertex, mesh->mNumVertices };
+		}
+		std::vector<math::vec3> positions(mesh->mNumVertices), normals;
+		for (unsigned int a = 0; a < mesh->mNumAnimMeshes; a++) {
+			const aiAnimMesh* anim = mesh->mAnimMeshes[a];
+			if (anim->mNumVertices != mesh->mNumVertices) continue;
+			for (unsigned int v = 0; v < mesh->mNumVertices; v++) {
+				positions[v] = anim->HasPositions() ? toVec3(anim->mVertices[v]) : basePositions[v];
+			}
+			normals.clear();
+			if (!baseNormals.empty()) {
+				for (unsigned int v = 0; v < mesh->mNumVertices; v++) {
+					normals.push_back(anim->HasNormals() ? toVec3(anim->mNormals[v]) : baseNormals[v]);
+				}
+			}
+			std::string name = anim->mName.length > 0 ? anim->mName.C_Str() :
+				std::string(mesh->mName.C_Str()) + "#" + std::to_string(a);
+			MorphTarget target = MorphTarget::fromDense(std::move(name), basePositions, positions,
+				baseNormals, normals);
+			for (ui32& vertex : target.vertices) vertex += static_cast<ui32>(baseVertex);
+			model.morphs.addTarget(target);
+			model.morphWeights.push_back(anim->mWeight);
+		}
+	}
+
+	void readGeometry(const aiScene* scene, const Skeleton& skeleton, SkinnedModel& model,
+	                  MorphOffsets& morphOffsets) {
+		bool normals = false, texcoords = false;
+		size_t vertexCount = 0;
+		for (unsigned int m = 0; m < scene->mNumMeshes; m++) {
+			normals |= scene->mMeshes[m]->HasNormals();
+			texcoords |= scene->mMeshes[m]->HasTextureCoords(0);
+			vertexCount += scene->mMeshes[m]->mNumVertices;
+		}
+
+		MeshData& data = model.mesh;
+		SkinBuilder skin(vertexCount);
+		model.morphs = MorphTargets(vertexCount);
+		std::vector<i32> firstTargets(scene->mNumMeshes, -1);
+		for (unsigned int m = 0; m < scene->mNumMeshes; m++) {
+			const aiMesh* mesh = scene->mMeshes[m];
+			const size_t baseVertex = data.positions.size();
+			Submesh submesh;
+			submesh.baseVertex = static_cast<unsigned int>(baseVertex);
+			submesh.baseIndex = static_cast<unsigned int>(data.indices.size());
+
+			for (unsigned int v = 0; v < mesh->mNumVertices; v++) {
+				data.positions.push_back(toVec3(mesh->mVertices[v]));
+				if (normals) data.normals.push_back(mesh->HasNormals() ? toVec3(mesh->mNormals[v]) : math::vec3());
+				if (texcoords) {
+					const aiVector3D uv = mesh->HasTextureCoords(0) ? mesh->mTextureCoords[0][v] : aiVector3D();
+					data.texcoords.push_back(math::vec2(uv.x, uv.y));
+				}
+			}
+			for (unsigned int f = 0; f < mesh->mNumFaces; f++) {
+				const aiFace& face = mesh->mFaces[f];
+				if (face.mNumIndices != 3) continue; // points and lines
+				data.indices.insert(data.indices.end(), { face.mIndices[0], face.mIndices[1], face.mIndices[2] });
+			}
+			submesh.n_indices = static_cast<unsigned int>(data.indices.size()) - submesh.baseIndex;
+			data.submeshes.push_back(submesh);
+
+			if (mesh->mNumAnimMeshes > 0) {
+				firstTargets[m] = static_cast<i32>(model.morphs.size());
+				morphOffsets.emplace(mesh->mName.C_Str(), firstTargets[m]);
+				try {
+					readMorphTargets(mesh, baseVertex, model);
+				}
+				catch (const std::length_error&) {
+					MGL_WARN("Ignoring morph targets past the first {}", MorphTargets::MAX_TARGETS);
+				}
+			}
+
+			for (unsigned int b = 0; b < mesh->mNumBones; b++) {
+				const aiBone* bone = mesh->mBones[b];
+				const i32 index = skeleton.find(bone->mName.C_Str());
+				for (unsigned int w = 0; w < bone->mNumWeights; w++) {
+					skin.addInfluence(baseVertex + bone->mWeights[w].mVertexId, static_cast<ui32>(index),
+						bone->mWeights[w].mWeight);
+				}
+			}
+		}
+		model.skin = skin.build();
+		mapMorphNodes(scene->mRootNode, firstTargets, morphOffsets);
+	}
+
+	/*
+		Every key of an aiMeshMorphAnim lists the weights of some of the
+		mesh's targets: split them into one channel per target, where
+		targets missing from a key have weight 0
+	*/
+	void readMorphChannels(const aiMeshMorphAnim* anim, i32 firstTarget, size_t targetCount,
+	                       const std::function<float(double)>& seconds, AnimationClip& clip) {
+		std::unordered_map<ui32, size_t> channels;
+		for (unsigned int k = 0; k < anim->mNumKeys; k++) {
+			const aiMeshMorphKey& key = anim->mKeys[k];
+			for (unsigned int i = 0; i < key.mNumValuesAndWeights; i++) {
+				const i32 target = firstTarget + static_cast<i32>(key.mValues[i]);
+				if (static_cast<size_t>(target) >= targetCount || channels.count(key.mValues[i])) continue;
+				channels.emplace(key.mValues[i], clip.morphChannels.size());
+				clip.morphChannels.push_back({ target, {} });
+			}
+		}
+		for (unsigned int k = 0; k < anim->mNumKeys; k++) {
+			const aiMeshMorphKey& key = anim->mKeys[k];
+			const float time = seconds(key.mTime);
+			for (const auto& [value, channel] : channels) clip.morphChannels[channel].weights.push_back({ time, 0.0f });
+			for (unsigned int i = 0; i < key.mNumValuesAndWeights; i++) {
+				const auto channel = channels.find(key.mValues[i]);
+				if (channel == channels.end()) continue;
+				clip.morphChannels[channel->second].weights.back().value = static_cast<float>(key.mWeights[i]);
+			}
+		}
+	}
+
+	void readClips(const aiScene* scene, const SkinnedModel& model, const MorphOffsets& morphOffsets,
+	               std::vector<AnimationClip>& clips) {
+		const Skeleton& skeleton = model.skeleton;
+		for (unsigned int a = 0; a < scene->mNumAnimations; a++) {
+			const aiAnimation* animation = scene->mAnimations[a];
+			const double ticksPerSecond = animation->mTicksPerSecond > 0.0 ?
+				animation->mTicksPerSecond : DEFAULT_TICKS_PER_SECOND;
+			const std::function<float(double)> seconds = [ticksPerSecond](double ticks) {
+				return static_cast<float>(ticks / ticksPerSecond);
+			};
+
+			AnimationClip clip;
+			clip.name = animation->mName.C_Str();
+			clip.duration = seconds(animation->mDuration);
+			for (unsigned int c = 0; c < animation->mNumChannels; c++) {
+				const aiNodeAnim* node = animation->mChannels[c];
+				AnimationClip::Channel channel;
+				channel.bone = skeleton.find(node->mNodeName.C_Str());
+				if (channel.bone < 0) continue; // not part of the skeleton
+				for (unsigned int k = 0; k < node->mNumPositionKeys; k++) {
+					channel.translations.push_back({ seconds(node->mPositionKeys[k].mTime), toVec3(node->mPositionKeys[k].mValue) });
+				}
+				for (unsigned int k = 0; k < node->mNumRotationKeys; k++) {
+					const aiQuaternion& q = node->mRotationKeys[k].mValue;
+					channel.rotations.push_back({ seconds(node->mRotationKeys[k].mTime), math::quat(q.x, q.y, q.z, q.w) });
+				}
+				for (unsigned int k = 0; k < node->mNumScalingKeys; k++) {
+					channel.scales.push_back({ seconds(node->mScalingKeys[k].mTime), toVec3(node->mScalingKeys[k].mValue) });
+				}
+				clip.channels.push_back(std::move(channel));
+			}
+			for (unsigned int c = 0; c < animation->mNumMorphMeshChannels; c++) {
+				const aiMeshMorphAnim* anim = animation->mMorphMeshChannels[c];
+				const auto first = morphOffsets.find(anim->mName.C_Str());
+				if (first == morphOffsets.end()) continue;
+				readMorphChannels(anim, first->second, model.morphs.size(), seconds, clip);
+			}
+			clips.push_back(std::move(clip));
+		}
+	}
+
+}
+
+std::optional<SkinnedModel> SkinnedModel::load(const std::string& filename) {
+	Assimp::Importer importer;
+	importer.SetIOHandler(new util::AssimpIO());
+	const aiScene* scene = importer.ReadFile(filename, IMPORT_FLAGS);
+	if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) {
+		MGL_ERROR("Error while loading [{}]: {}", filename, importer.GetErrorString());
+		return std::nullopt;
+	}
+
+	SkinnedModel model;
+	try {
+		buildSkeleton(scene, model.skeleton);
+	}
+	catch (const std::length_error&) {
+		MGL_ERROR("Skeleton of [{}] has more than {} bones", filename, Skeleton::MAX_BONES);
+		return std::nullopt;
+	}
+	MorphOffsets morphOffsets;
+	readGeometry(scene, model.skeleton, model, morphOffsets);
+	readClips(scene, model, morphOffsets, model.clips);
+	MGL_INFO("Loaded skinned model [{}]: {} vertices, {} bones, {} morph target(s), {} clip(s)", filename,
+		model.mesh.positions.size(), model.skeleton.size(), model.morphs.size(), model.clips.size());
+	return model;
+}
+
+}
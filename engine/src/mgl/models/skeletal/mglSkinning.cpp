@@ -0,0 +1,261 @@
+#include <mgl/models/skeletal/mglSkinning.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MGL_SKINNING_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// The AVX path is compiled for AVX whatever the target flags, and only
+// called when the CPU supports it
+#if defined(MGL_SKINNING_X86) && (defined(__GNUC__) || defined(__clang__))
+#define MGL_TARGET_AVX __attribute__((target("avx")))
+#else
+#define MGL_TARGET_AVX
+#endif
+
+namespace mgl {
+
+namespace {
+
+	constexpr float WEIGHT_SCALE = 1.0f / 255.0f;
+
+	void validate(std::span<const math::vec3> positions, std::span<const math::vec3> normals,
+	              std::span<const VertexSkin> skin, std::span<const math::mat4> palette,
+	              std::span<math::vec3> outPositions, std::span<math::vec3> outNormals) {
+		if (skin.size() != positions.size() || outPositions.size() != positions.size() ||
+			normals.size() != outNormals.size() || (!normals.empty() && normals.size() != positions.size())) {
+			throw std::invalid_argument("Skinning::skin: attribute sizes do not match");
+		}
+		if (palette.empty() && !positions.empty()) {
+			throw std::invalid_argument("Skinning::skin: empty palette");
+		}
+	}
+
+	void store(const float* values, math::vec3& out) {
+		std::memcpy(out.data(), values, sizeof(float) * 3);
+	}
+
+	void normalize(math::vec3& v) {
+		const float length = v.length();
+		if (length > 0.0f) v /= length;
+	}
+
+#ifdef MGL_SKINNING_X86
+	constexpr size_t BATCH = 8;
+
+	// Transposes 8 rows of 8 floats in place
+	MGL_TARGET_AVX
+	inline void transpose8(__m256 rows[8]) {
+		__m256 t[8], u[8];
+		for (int i = 0; i < 8; i += 2) {
+			t[i] = _mm256_unpacklo_ps(rows[i], rows[i + 1]);
+			t[i + 1] = _mm256_unpackhi_ps(rows[i], rows[i + 1]);
+		}
+		for (int i = 0; i < 8; i += 4) {
+			u[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+			u[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+			u[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+			u[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+		}
+		for (int i = 0; i < 4; i++) {
+			rows[i] = _mm256_permute2f128_ps(u[i], u[i + 4], 0x20);
+			rows[i + 4] = _mm256_permute2f128_ps(u[i], u[i + 4], 0x31);
+		}
+	}
+
+	static_assert(sizeof(math::vec3) == 3 * sizeof(float), "vec3 arrays are read as packed floats");
+
+	// x, y, z of 8 packed vectors, one per lane
+	MGL_TARGET_AVX
+	inline void loadSoA(const math::vec3* v, __m256 soa[3]) {
+		const float* f = v->data();
+		const __m256 m03 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(f)), _mm_loadu_ps(f + 12), 1);
+		const __m256 m14 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(f + 4)), _mm_loadu_ps(f + 16), 1);
+		const __m256 m25 = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(f + 8)), _mm_loadu_ps(f + 20), 1);
+		const __m256 xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+		const __m256 yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+		soa[0] = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+		soa[1] = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+		soa[2] = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+	}
+
+	// Inverse of loadSoA
+	MGL_TARGET_AVX
+	inline void storeSoA(const __m256 soa[3], math::vec3* v) {
+		float* f = v->data();
+		const __m256 xy = _mm256_shuffle_ps(soa[0], soa[1], _MM_SHUFFLE(2, 0, 2, 0));
+		const __m256 yz = _mm256_shuffle_ps(soa[1], soa[2], _MM_SHUFFLE(3, 1, 3, 1));
+		const __m256 zx = _mm256_shuffle_ps(soa[2], soa[0], _MM_SHUFFLE(3, 1, 2, 0));
+		const __m256 m03 = _mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0));
+		const __m256 m14 = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+		const __m256 m25 = _mm256_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1));
+		_mm_storeu_ps(f, _mm256_castps256_ps128(m03));
+		_mm_storeu_ps(f + 4, _mm256_castps256_ps128(m14));
+		_mm_storeu_ps(f + 8, _mm256_castps256_ps128(m25));
+		_mm_storeu_ps(f + 12, _mm256_extractf128_ps(m03, 1));
+		_mm_storeu_ps(f + 16, _mm256_extractf128_ps(m14, 1));
+		_mm_storeu_ps(f + 20, _mm256_extractf128_ps(m25, 1));
+	}
+
+	/*
+		Skins 8 vertices: the 4 palette matrices of each vertex are blended
+		half a matrix per register, then the 8 blended matrices are transposed
+		so that each register holds one matrix element of all 8 vertices, and
+		the positions and normals are transformed and normalized in
+		structure-of-arrays form. Only the first 'count' skins are read, the
+		other lanes are skinned by a zero matrix
+	*/
+	MGL_TARGET_AVX
+	void skinBatchAvx(const math::vec3* positions, const math::vec3* normals, const VertexSkin* skin,
+	                  size_t count, const float* matrices, size_t lastBone,
+	                  math::vec3* outPositions, math::vec3* outNormals) {
+		const __m256 zero = _mm256_setzero_ps();
+
+		// columns 0-1 (low) and 2-3 (high) of each vertex's blended (column-major) matrix
+		__m256 low[BATCH], high[BATCH];
+		for (size_t l = 0; l < BATCH; l++) {
+			__m256 lo = zero, hi = zero;
+			for (int i = 0; l < count && i < 4; i++) {
+				if (skin[l].weights[i] == 0) continue;
+				const float* m = matrices + 16 * std::min<size_t>(skin[l].bones[i], lastBone);
+				const __m256 w = _mm256_set1_ps(skin[l].weights[i] * WEIGHT_SCALE);
+				lo = _mm256_add_ps(lo, _mm256_mul_ps(w, _mm256_loadu_ps(m)));
+				hi = _mm256_add_ps(hi, _mm256_mul_ps(w, _mm256_loadu_ps(m + 8)));
+			}
+			low[l] = lo;
+			high[l] = hi;
+		}
+		// element k of the 8 matrices: low[k] for k < 8, high[k - 8] after
+		transpose8(low);
+		transpose8(high);
+
+		__m256 p[3], result[3];
+		loadSoA(positions, p);
+		for (int r = 0; r < 3; r++) {
+			result[r] = _mm256_add_ps(
+				_mm256_add_ps(_mm256_mul_ps(low[r], p[0]), _mm256_mul_ps(low[4 + r], p[1])),
+				_mm256_add_ps(_mm256_mul_ps(high[r], p[2]), high[4 + r]));
+		}
+		storeSoA(result, outPositions);
+		if (!normals) return;
+
+		__m256 n[3];
+		loadSoA(normals, n);
+		for (int r = 0; r < 3; r++) {
+			result[r] = _mm256_add_ps(
+				_mm256_add_ps(_mm256_mul_ps(low[r], n[0]), _mm256_mul_ps(low[4 + r], n[1])),
+				_mm256_mul_ps(high[r], n[2]));
+		}
+		// zero-length normals are left as they are, like normalize()
+		const __m256 length = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(result[0], result[0]),
+			_mm256_add_ps(_mm256_mul_ps(result[1], result[1]), _mm256_mul_ps(result[2], result[2]))));
+		const __m256 scale = _mm256_blendv_ps(_mm256_set1_ps(1.0f), length, _mm256_cmp_ps(length, zero, _CMP_GT_OQ));
+		for (int r = 0; r < 3; r++) result[r] = _mm256_div_ps(result[r], scale);
+		storeSoA(result, outNormals);
+	}
+
+	MGL_TARGET_AVX
+	void skinAvx(std::span<const math::vec3> positions, std::span<const math::vec3> normals,
+	             std::span<const VertexSkin> skin, std::span<const math::mat4> palette,
+	             std::span<math::vec3> outPositions, std::span<math::vec3> outNormals) {
+		// validate() allows an empty palette with no vertices
+		if (positions.empty()) return;
+		const float* matrices = palette.data()->data();
+		const size_t lastBone = palette.size() - 1;
+		const bool hasNormals = !normals.empty();
+
+		size_t first = 0;
+		for (; first + BATCH <= positions.size(); first += BATCH) {
+			skinBatchAvx(positions.data() + first, hasNormals ? normals.data() + first : nullptr,
+				skin.data() + first, BATCH, matrices, lastBone,
+				outPositions.data() + first, hasNormals ? outNormals.data() + first : nullptr);
+		}
+
+		// the last, partial batch goes through zero-padded copies
+		const size_t count = positions.size() - first;
+		if (count == 0) return;
+		math::vec3 in[2][BATCH] = {}, out[2][BATCH];
+		std::copy_n(positions.data() + first, count, in[0]);
+		if (hasNormals) std::copy_n(normals.data() + first, count, in[1]);
+		skinBatchAvx(in[0], hasNormals ? in[1] : nullptr, skin.data() + first, count, matrices, lastBone,
+			out[0], out[1]);
+		std::copy_n(out[0], count, outPositions.data() + first);
+		if (hasNormals) std::copy_n(out[1], count, outNormals.data() + first);
+	}
+#endif
+
+}
+
+bool Skinning::hasAvx() {
+#if defined(MGL_SKINNING_X86) && (defined(__GNUC__) || defined(__clang__))
+	static const bool avx = __builtin_cpu_supports("avx");
+	return avx;
+#elif defined(MGL_SKINNING_X86) && defined(_MSC_VER)
+	static const bool avx = []() {
+		int info[4];
+		__cpuid(info, 1);
+		const bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+		return osSavesYmm && (info[2] & (1 << 28));
+	}();
+	return avx;
+#else
+	return false;
+#endif
+}
+
+void Skinning::skin(std::span<const math::vec3> positions, std::span<const math::vec3> normals,
+                    std::span<const VertexSkin> skin, std::span<const math::mat4> palette,
+                    std::span<math::vec3> outPositions, std::span<math::vec3> outNormals) {
+#ifdef MGL_SKINNING_X86
+	if (hasAvx()) {
+		validate(positions, normals, skin, palette, outPositions, outNormals);
+		skinAvx(positions, normals, skin, palette, outPositions, outNormals);
+		return;
+	}
+#endif
+	skinScalar(positions, normals, skin, palette, outPositions, outNormals);
+}
+
+void Skinning::skinScalar(std::span<const math::vec3> positions, std::span<const math::vec3> normals,
+                          std::span<const VertexSkin> skin, std::span<const math::mat4> palette,
+                          std::span<math::vec3> outPositions, std::span<math::vec3> outNormals) {
+	validate(positions, normals, skin, palette, outPositions, outNormals);
+	const float* matrices = palette.data() ? palette.data()->data() : nullptr;
+	const size_t lastBone = palette.empty() ? 0 : palette.size() - 1;
+
+	for (size_t v = 0; v < positions.size(); v++) {
+		float blended[16] = {};
+		for (int i = 0; i < 4; i++) {
+			const u8 weight = skin[v].weights[i];
+			if (weight == 0) continue;
+			const float* m = matrices + 16 * std::min<size_t>(skin[v].bones[i], lastBone);
+			const float w = weight * WEIGHT_SCALE;
+			for (int k = 0; k < 16; k++) blended[k] += w * m[k];
+		}
+
+		const math::vec3& p = positions[v];
+		float result[3];
+		for (int r = 0; r < 3; r++) {
+			result[r] = blended[r] * p[0] + blended[4 + r] * p[1] + blended[8 + r] * p[2] + blended[12 + r];
+		}
+		store(result, outPositions[v]);
+		if (!normals.empty()) {
+			const math::vec3& n = normals[v];
+			for (int r = 0; r < 3; r++) {
+				result[r] = blended[r] * n[0] + blended[4 + r] * n[1] + blended[8 + r] * n[2];
+			}
+			store(result, outNormals[v]);
+			normalize(outNormals[v]);
+		}
+	}
+}
+
+}
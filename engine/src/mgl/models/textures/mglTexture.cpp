@@ -3,6 +3,7 @@
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <optional>
 
 #include <mgl/models/textures/mglTexture.hpp>
 #include <utils/stb_image.h>
@@ -53,6 +54,77 @@ void Texture::genAndBindTextureOpenGL(GLuint  texType, GLuint channels,
     glBindTexture(texType, 0);
 }
 
+namespace {
+
+// S3TC is an extension - not in the core profile header
+constexpr GLenum COMPRESSED_RGB_S3TC_DXT1 = 0x83F0;
+constexpr GLenum COMPRESSED_RGBA_S3TC_DXT5 = 0x83F3;
+
+bool supportsS3tc() {
+    static const bool supported = [] {
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; i++) {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (name && std::string(name) == "GL_EXT_texture_compression_s3tc") return true;
+        }
+        return false;
+    }();
+    return supported;
+}
+
+GLenum pixelFormat(ui32 channels) {
+    return channels == 4 ? GL_RGBA
+         : channels == 3 ? GL_RGB
+         : channels == 2 ? GL_RG
+         : GL_RED;
+}
+
+// Decodes an image read through the VFS, nullptr if missing or invalid
+unsigned char* decodeImage(const file::Resource& source, int* width, int* height, int* channels) {
+    if (!source) return nullptr;
+    return stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(source.data()),
+            static_cast<int>(source.size()), width, height, channels, 0);
+}
+
+} // namespace
+
+void Texture::genAndBindCompiledTextureOpenGL(GLuint texType, const TextureCache::Entry& entry) {
+    using Format = TextureCompressor::Format;
+    const bool s3tc = entry.format == Format::BC1 || entry.format == Format::BC3;
+    const bool decode = s3tc && !supportsS3tc();
+    const GLenum compressed =
+          entry.format == Format::BC1 ? COMPRESSED_RGB_S3TC_DXT1
+        : entry.format == Format::BC3 ? COMPRESSED_RGBA_S3TC_DXT5
+        : entry.format == Format::BC4 ? GL_COMPRESSED_RED_RGTC1
+        : GL_COMPRESSED_RG_RGTC2;
+
+    glGenTextures(1, &id);
+    glBindTexture(texType, id);
+    // levels are tightly packed, whatever their row size
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (GLint l = 0; l < static_cast<GLint>(entry.levels.size()); l++) {
+        const TextureCache::Level& level = entry.levels[l];
+        if (entry.format == Format::RAW) {
+            const GLenum format = pixelFormat(entry.channels);
+            glTexImage2D(texType, l, format, level.width, level.height, 0, format,
+                GL_UNSIGNED_BYTE, level.data.data());
+        } else if (decode) {
+            const TextureCompressor::Image image =
+                TextureCompressor::decompress(level.data, entry.format, level.width, level.height);
+            const GLenum format = pixelFormat(image.channels);
+            glTexImage2D(texType, l, format, level.width, level.height, 0, format,
+                GL_UNSIGNED_BYTE, image.pixels.data());
+        } else {
+            glCompressedTexImage2D(texType, l, compressed, level.width, level.height, 0,
+                static_cast<GLsizei>(level.data.size()), level.data.data());
+        }
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(texType, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(entry.levels.size()) - 1);
+    glBindTexture(texType, 0);
+}
+
 ////////////////////////////////////////////////////////////////////// Texture2D
 
 void Texture2D::bind() { glBindTexture(GL_TEXTURE_2D, id); }
@@ -60,6 +132,18 @@ void Texture2D::bind() { glBindTexture(GL_TEXTURE_2D, id); }
 void Texture2D::unbind() { glBindTexture(GL_TEXTURE_2D, 0); }
 
 void Texture2D::load(const std::string &filename) {
+    // compiled by mgl-assetc: upload the mip chain straight from the mapping
+    const file::Resource source = file::vfs().open(filename);
+    if (source) {
+        if (std::optional<TextureCache::Entry> compiled = TextureCache::open(TextureCache::makeKey(source.bytes()))) {
+            #ifdef DEBUG
+            MGL_DEBUG("Loading compiled image: " + filename);
+            #endif
+            genAndBindCompiledTextureOpenGL(GL_TEXTURE_2D, *compiled);
+            return;
+        }
+    }
+
     stbi_set_flip_vertically_on_load(true);
     int width, height, channels;
 
@@ -67,8 +151,7 @@ void Texture2D::load(const std::string &filename) {
     MGL_DEBUG("Loading image: " + filename + "...");
     #endif
 
-    unsigned char *image = stbi_load(file::resource_path(filename).c_str(),
-            &width, &height, &channels, 0);
+    unsigned char *image = decodeImage(source, &width, &height, &channels);
     if (image == nullptr) {
         MGL_ERROR("Could not load image");
         exit(EXIT_FAILURE);
@@ -188,8 +271,7 @@ void Texture3D::load(const std::string& filename) {
     MGL_DEBUG("Loading image: " + filename + "...");
     #endif
 
-    unsigned char* image = stbi_load(file::resource_path(filename).c_str(),
-        &width, &height, &channels, 0);
+    unsigned char* image = decodeImage(file::vfs().open(filename), &width, &height, &channels);
     if (image == nullptr) {
         MGL_ERROR("Could not load image");
         exit(EXIT_FAILURE);
@@ -263,8 +345,7 @@ void TextureCubeMap::loadCubeMap(const std::string& folder, const std::string &f
         MGL_DEBUG("Loading cubemap file " + filename + "...");
 #endif
 
-        unsigned char* image = stbi_load(file::resource_path(filename).c_str(),
-                &width, &height, &channels, 0);
+        unsigned char* image = decodeImage(file::vfs().open(filename), &width, &height, &channels);
 
         channels =
             channels == 4 ? GL_RGBA
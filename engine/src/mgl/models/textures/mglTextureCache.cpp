@@ -0,0 +1,162 @@
+#include <mgl/models/textures/mglTextureCache.hpp>
+#include <utils/Logger.hpp>
+#include <utils/hash.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace mgl {
+
+namespace {
+
+	struct LevelInfo {
+		u64 offset;
+		u64 size;
+	};
+
+	struct Header {
+		char magic[4];
+		ui32 version;
+		u64 key;
+		ui32 width;
+		ui32 height;
+		ui32 channels;
+		ui32 format;
+		ui32 levelCount;
+		ui32 reserved;
+		LevelInfo levels[TextureCache::MAX_LEVELS];
+	};
+
+	constexpr char MAGIC[4] = { 'M', 'G', 'L', 'T' };
+	constexpr u64 ALIGNMENT = 16;
+
+	u64 alignUp(u64 value) {
+		return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+	}
+
+	std::filesystem::path& directory() {
+		static std::filesystem::path dir = file::exe_dir() / "cache" / "textures";
+		return dir;
+	}
+
+	ui32 levelDimension(ui32 size, ui32 level) {
+		return std::max(1u, size >> level);
+	}
+
+} // namespace
+
+void TextureCache::setDirectory(const std::filesystem::path& dir) {
+	directory() = dir;
+}
+
+std::filesystem::path TextureCache::getDirectory() {
+	return directory();
+}
+
+std::filesystem::path TextureCache::entryPath(u64 key) {
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.mgltex", static_cast<unsigned long long>(key));
+	return directory() / name;
+}
+
+u64 TextureCache::makeKey(std::span<const std::byte> source) {
+	return util::hashCombine(util::hash64(source.data(), source.size()), VERSION);
+}
+
+std::optional<TextureCache::Entry> TextureCache::open(u64 key) {
+	file::MappedFile file(entryPath(key));
+	if (!file || file.size() < sizeof(Header)) return std::nullopt;
+
+	Header header;
+	std::memcpy(&header, file.data(), sizeof(Header));
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+		header.version != VERSION || header.key != key) {
+		MGL_WARN("Ignoring stale or invalid texture cache entry {}", entryPath(key).string());
+		return std::nullopt;
+	}
+
+	// every level must be aligned, inside the file, and sized for its format
+	const auto format = static_cast<TextureCompressor::Format>(header.format);
+	bool valid = header.format <= static_cast<ui32>(TextureCompressor::Format::BC5) &&
+		header.channels >= 1 && header.channels <= 4 &&
+		header.levelCount >= 1 && header.levelCount <= MAX_LEVELS;
+	for (ui32 l = 0; valid && l < header.levelCount; l++) {
+		const LevelInfo& level = header.levels[l];
+		const size_t expected = TextureCompressor::levelSize(format, levelDimension(header.width, l),
+			levelDimension(header.height, l), header.channels);
+		valid = level.size == expected && level.offset % ALIGNMENT == 0 && level.offset + level.size <= file.size();
+	}
+	if (!valid) {
+		MGL_WARN("Ignoring corrupted texture cache entry {}", entryPath(key).string());
+		return std::nullopt;
+	}
+
+	Entry entry{ std::move(file), format, header.channels, {} };
+	for (ui32 l = 0; l < header.levelCount; l++) {
+		const LevelInfo& level = header.levels[l];
+		entry.levels.push_back({ levelDimension(header.width, l), levelDimension(header.height, l),
+			{ reinterpret_cast<const u8*>(entry.file.data() + level.offset), static_cast<size_t>(level.size) } });
+	}
+	return entry;
+}
+
+bool TextureCache::store(u64 key, TextureCompressor::Format format, ui32 channels,
+                         ui32 width, ui32 height, std::span<const std::vector<u8>> levels) {
+	if (levels.empty() || levels.size() > MAX_LEVELS) return false;
+
+	Header header{};
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.key = key;
+	header.width = width;
+	header.height = height;
+	header.channels = channels;
+	header.format = static_cast<ui32>(format);
+	header.levelCount = static_cast<ui32>(levels.size());
+	u64 offset = alignUp(sizeof(Header));
+	for (ui32 l = 0; l < header.levelCount; l++) {
+		header.levels[l] = { offset, levels[l].size() };
+		offset = alignUp(offset + levels[l].size());
+	}
+
+	std::error_code error;
+	std::filesystem::create_directories(directory(), error);
+
+	// write to a private temporary file, then publish it atomically so
+	// concurrent readers never observe a partially written entry
+	const std::filesystem::path path = entryPath(key);
+	std::filesystem::path tmp = path;
+	tmp += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+	{
+		std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+		if (!out) {
+			MGL_WARN("Could not write texture cache entry {}", path.string());
+			return false;
+		}
+		const char padding[ALIGNMENT] = {};
+		out.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		u64 written = sizeof(Header);
+		for (ui32 l = 0; l < header.levelCount; l++) {
+			out.write(padding, header.levels[l].offset - written);
+			out.write(reinterpret_cast<const char*>(levels[l].data()), levels[l].size());
+			written = header.levels[l].offset + levels[l].size();
+		}
+		if (!out) {
+			MGL_WARN("Could not write texture cache entry {}", path.string());
+			std::filesystem::remove(tmp, error);
+			return false;
+		}
+	}
+	std::filesystem::rename(tmp, path, error);
+	if (error) {
+		std::filesystem::remove(tmp, error);
+		return false;
+	}
+	return true;
+}
+
+}
@@ -0,0 +1,308 @@
+#include <mgl/models/textures/mglTextureCompressor.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+
+namespace mgl {
+
+namespace {
+
+	using Block = std::array<std::array<u8, 4>, 16>;
+
+	/// 4x4 texels starting at (x, y), edge texels repeated past the image bounds
+	Block gather(const TextureCompressor::Image& image, ui32 x, ui32 y) {
+		Block block{};
+		for (ui32 j = 0; j < 4; j++) {
+			const ui32 row = std::min(y + j, image.height - 1);
+			for (ui32 i = 0; i < 4; i++) {
+				const ui32 column = std::min(x + i, image.width - 1);
+				const u8* texel = &image.pixels[(size_t(row) * image.width + column) * image.channels];
+				for (ui32 c = 0; c < image.channels && c < 4; c++) block[j * 4 + i][c] = texel[c];
+			}
+		}
+		return block;
+	}
+
+	u16 pack565(const std::array<float, 3>& color) {
+		auto quantize = [](float value, int max) {
+			return static_cast<u16>(std::clamp(static_cast<int>(value / 255.0f * max + 0.5f), 0, max));
+		};
+		return static_cast<u16>((quantize(color[0], 31) << 11) | (quantize(color[1], 63) << 5) | quantize(color[2], 31));
+	}
+
+	std::array<int, 3> unpack565(u16 color) {
+		const int r = (color >> 11) & 31, g = (color >> 5) & 63, b = color & 31;
+		return { (r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2) };
+	}
+
+	void store16(u8* out, u16 value) {
+		out[0] = static_cast<u8>(value & 0xff);
+		out[1] = static_cast<u8>(value >> 8);
+	}
+
+	u16 load16(const u8* in) {
+		return static_cast<u16>(in[0] | (in[1] << 8));
+	}
+
+	/*
+		Endpoints are the texels furthest apart along the principal axis of
+		the block colors, found by power iteration on their covariance
+	*/
+	void encodeColor(const Block& block, u8* out) {
+		std::array<float, 3> mean{};
+		for (const auto& texel : block) {
+			for (int c = 0; c < 3; c++) mean[c] += texel[c] / 16.0f;
+		}
+		float covariance[3][3] = {};
+		for (const auto& texel : block) {
+			const float d[3] = { texel[0] - mean[0], texel[1] - mean[1], texel[2] - mean[2] };
+			for (int a = 0; a < 3; a++) {
+				for (int b = 0; b < 3; b++) covariance[a][b] += d[a] * d[b];
+			}
+		}
+		std::array<float, 3> axis = { 1.0f, 1.0f, 1.0f };
+		for (int iteration = 0; iteration < 8; iteration++) {
+			std::array<float, 3> next{};
+			for (int a = 0; a < 3; a++) {
+				for (int b = 0; b < 3; b++) next[a] += covariance[a][b] * axis[b];
+			}
+			const float scale = std::max({ std::abs(next[0]), std::abs(next[1]), std::abs(next[2]) });
+			if (scale < 1e-6f) break;
+			for (int c = 0; c < 3; c++) axis[c] = next[c] / scale;
+		}
+
+		size_t minTexel = 0, maxTexel = 0;
+		float minProjection = INFINITY, maxProjection = -INFINITY;
+		for (size_t t = 0; t < 16; t++) {
+			const float projection = block[t][0] * axis[0] + block[t][1] * axis[1] + block[t][2] * axis[2];
+			if (projection < minProjection) { minProjection = projection; minTexel = t; }
+			if (projection > maxProjection) { maxProjection = projection; maxTexel = t; }
+		}
+		auto color = [&block](size_t t) {
+			return std::array<float, 3>{ float(block[t][0]), float(block[t][1]), float(block[t][2]) };
+		};
+		u16 color0 = pack565(color(maxTexel)), color1 = pack565(color(minTexel));
+		// color0 > color1 selects the 4 color mode
+		if (color0 < color1) std::swap(color0, color1);
+		store16(out, color0);
+		store16(out + 2, color1);
+
+		u32 indices = 0;
+		if (color0 != color1) {
+			const std::array<int, 3> c0 = unpack565(color0), c1 = unpack565(color1);
+			std::array<std::array<int, 3>, 4> palette;
+			for (int c = 0; c < 3; c++) {
+				palette[0][c] = c0[c];
+				palette[1][c] = c1[c];
+				palette[2][c] = (2 * c0[c] + c1[c]) / 3;
+				palette[3][c] = (c0[c] + 2 * c1[c]) / 3;
+			}
+			for (size_t t = 0; t < 16; t++) {
+				u32 best = 0;
+				int bestDistance = INT32_MAX;
+				for (u32 p = 0; p < 4; p++) {
+					int distance = 0;
+					for (int c = 0; c < 3; c++) {
+						const int d = int(block[t][c]) - palette[p][c];
+						distance += d * d;
+					}
+					if (distance < bestDistance) { bestDistance = distance; best = p; }
+				}
+				indices |= best << (t * 2);
+			}
+		}
+		for (int b = 0; b < 4; b++) out[4 + b] = static_cast<u8>(indices >> (b * 8));
+	}
+
+	void encodeChannel(const Block& block, int channel, u8* out) {
+		u8 low = 255, high = 0;
+		for (const auto& texel : block) {
+			low = std::min(low, texel[channel]);
+			high = std::max(high, texel[channel]);
+		}
+		// high > low selects the 8 value mode
+		out[0] = high;
+		out[1] = low;
+		u64 indices = 0;
+		if (high != low) {
+			std::array<int, 8> palette = { high, low };
+			for (int i = 2; i < 8; i++) palette[i] = ((8 - i) * high + (i - 1) * low) / 7;
+			for (size_t t = 0; t < 16; t++) {
+				u64 best = 0;
+				int bestDistance = INT32_MAX;
+				for (u64 p = 0; p < 8; p++) {
+					const int distance = std::abs(int(block[t][channel]) - palette[p]);
+					if (distance < bestDistance) { bestDistance = distance; best = p; }
+				}
+				indices |= best << (t * 3);
+			}
+		}
+		for (int b = 0; b < 6; b++) out[2 + b] = static_cast<u8>(indices >> (b * 8));
+	}
+
+	void decodeColor(const u8* in, bool fourColors, u8* texels, ui32 channels, size_t stride) {
+		const u16 color0 = load16(in), color1 = load16(in + 2);
+		const std::array<int, 3> c0 = unpack565(color0), c1 = unpack565(color1);
+		std::array<std::array<int, 3>, 4> palette;
+		for (int c = 0; c < 3; c++) {
+			palette[0][c] = c0[c];
+			palette[1][c] = c1[c];
+			if (fourColors || color0 > color1) {
+				palette[2][c] = (2 * c0[c] + c1[c]) / 3;
+				palette[3][c] = (c0[c] + 2 * c1[c]) / 3;
+			} else {
+				palette[2][c] = (c0[c] + c1[c]) / 2;
+				palette[3][c] = 0;
+			}
+		}
+		const u32 indices = in[4] | (in[5] << 8) | (in[6] << 16) | (u32(in[7]) << 24);
+		for (size_t t = 0; t < 16; t++) {
+			u8* texel = texels + (t / 4) * stride + (t % 4) * channels;
+			const auto& color = palette[(indices >> (t * 2)) & 3];
+			for (int c = 0; c < 3; c++) texel[c] = static_cast<u8>(color[c]);
+		}
+	}
+
+	void decodeChannel(const u8* in, u8* texels, ui32 channels, size_t stride) {
+		const int a0 = in[0], a1 = in[1];
+		std::array<int, 8> palette = { a0, a1 };
+		if (a0 > a1) {
+			for (int i = 2; i < 8; i++) palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+		} else {
+			for (int i = 2; i < 6; i++) palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+		u64 indices = 0;
+		for (int b = 0; b < 6; b++) indices |= u64(in[2 + b]) << (b * 8);
+		for (size_t t = 0; t < 16; t++) {
+			texels[(t / 4) * stride + (t % 4) * channels] = static_cast<u8>(palette[(indices >> (t * 3)) & 7]);
+		}
+	}
+
+	size_t blockSize(TextureCompressor::Format format) {
+		return format == TextureCompressor::Format::BC1 || format == TextureCompressor::Format::BC4 ? 8 : 16;
+	}
+
+	ui32 channelsOf(TextureCompressor::Format format) {
+		switch (format) {
+		case TextureCompressor::Format::BC1: return 3;
+		case TextureCompressor::Format::BC3: return 4;
+		case TextureCompressor::Format::BC4: return 1;
+		case TextureCompressor::Format::BC5: return 2;
+		default: return 0;
+		}
+	}
+
+} // namespace
+
+TextureCompressor::Format TextureCompressor::formatFor(ui32 channels) {
+	switch (channels) {
+	case 1: return Format::BC4;
+	case 2: return Format::BC5;
+	case 3: return Format::BC1;
+	case 4: return Format::BC3;
+	default: throw std::invalid_argument("TextureCompressor::formatFor: 1 to 4 channels are supported");
+	}
+}
+
+size_t TextureCompressor::levelSize(Format format, ui32 width, ui32 height, ui32 channels) {
+	if (format == Format::RAW) return size_t(width) * height * channels;
+	return size_t((width + 3) / 4) * ((height + 3) / 4) * blockSize(format);
+}
+
+TextureCompressor::Image TextureCompressor::downsample(const Image& image) {
+	Image half;
+	half.width = std::max(1u, image.width / 2);
+	half.height = std::max(1u, image.height / 2);
+	half.channels = image.channels;
+	half.pixels.resize(size_t(half.width) * half.height * half.channels);
+	const ui32 footprintX = image.width > 1 ? 2 : 1, footprintY = image.height > 1 ? 2 : 1;
+	for (ui32 y = 0; y < half.height; y++) {
+		for (ui32 x = 0; x < half.width; x++) {
+			for (ui32 c = 0; c < image.channels; c++) {
+				ui32 sum = 0;
+				for (ui32 j = 0; j < footprintY; j++) {
+					for (ui32 i = 0; i < footprintX; i++) {
+						sum += image.pixels[(size_t(y * footprintY + j) * image.width + x * footprintX + i) * image.channels + c];
+					}
+				}
+				const ui32 count = footprintX * footprintY;
+				half.pixels[(size_t(y) * half.width + x) * half.channels + c] = static_cast<u8>((sum + count / 2) / count);
+			}
+		}
+	}
+	return half;
+}
+
+std::vector<TextureCompressor::Image> TextureCompressor::mipChain(Image image) {
+	std::vector<Image> levels;
+	levels.push_back(std::move(image));
+	while (levels.back().width > 1 || levels.back().height > 1) {
+		levels.push_back(downsample(levels.back()));
+	}
+	return levels;
+}
+
+std::vector<u8> TextureCompressor::compress(const Image& image, Format format) {
+	if (format == Format::RAW) return image.pixels;
+	if (image.channels < channelsOf(format)) {
+		throw std::invalid_argument("TextureCompressor::compress: the image has too few channels for the format");
+	}
+
+	std::vector<u8> data(levelSize(format, image.width, image.height, image.channels));
+	u8* out = data.data();
+	for (ui32 y = 0; y < image.height; y += 4) {
+		for (ui32 x = 0; x < image.width; x += 4) {
+			const Block block = gather(image, x, y);
+			switch (format) {
+			case Format::BC1: encodeColor(block, out); break;
+			case Format::BC3: encodeChannel(block, 3, out); encodeColor(block, out + 8); break;
+			case Format::BC4: encodeChannel(block, 0, out); break;
+			case Format::BC5: encodeChannel(block, 0, out); encodeChannel(block, 1, out + 8); break;
+			default: break;
+			}
+			out += blockSize(format);
+		}
+	}
+	return data;
+}
+
+TextureCompressor::Image TextureCompressor::decompress(std::span<const u8> data, Format format, ui32 width, ui32 height) {
+	if (format == Format::RAW) {
+		throw std::invalid_argument("TextureCompressor::decompress: not a block format");
+	}
+	const ui32 channels = channelsOf(format);
+	if (data.size() < levelSize(format, width, height, channels)) {
+		throw std::length_error("TextureCompressor::decompress: not enough data for the level size");
+	}
+
+	// decode into whole blocks, then crop to the level size
+	const ui32 paddedWidth = (width + 3) & ~3u, paddedHeight = (height + 3) & ~3u;
+	const size_t stride = size_t(paddedWidth) * channels;
+	std::vector<u8> padded(stride * paddedHeight);
+	const u8* in = data.data();
+	for (ui32 y = 0; y < paddedHeight; y += 4) {
+		for (ui32 x = 0; x < paddedWidth; x += 4) {
+			u8* texels = &padded[y * stride + size_t(x) * channels];
+			switch (format) {
+			case Format::BC1: decodeColor(in, false, texels, channels, stride); break;
+			case Format::BC3: decodeChannel(in, texels + 3, channels, stride); decodeColor(in + 8, true, texels, channels, stride); break;
+			case Format::BC4: decodeChannel(in, texels, channels, stride); break;
+			case Format::BC5: decodeChannel(in, texels, channels, stride); decodeChannel(in + 8, texels + 1, channels, stride); break;
+			default: break;
+			}
+			in += blockSize(format);
+		}
+	}
+
+	Image image{ width, height, channels, std::vector<u8>(size_t(width) * height * channels) };
+	for (ui32 y = 0; y < height; y++) {
+		std::copy_n(&padded[y * stride], size_t(width) * channels, &image.pixels[size_t(y) * width * channels]);
+	}
+	return image;
+}
+
+}
@@ -0,0 +1,352 @@
+#include <mgl/scene/mglFlatSceneHierarchy.hpp>
+#include <utils/ThreadPool.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace mgl {
+
+FlatSceneHierarchy::Handle FlatSceneHierarchy::create(Handle parent) {
+	const ui32 parentSlot = parent == NONE ? NONE : slotOf(parent);
+
+	Handle handle;
+	if (!freeHandles.empty()) {
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+	}
+	else {
+		handle = static_cast<Handle>(slots.size());
+		slots.push_back(NONE);
+	}
+
+	// appended - after its parent, so the order holds
+	const ui32 slot = static_cast<ui32>(handles.size());
+	locals.push_back(math::mat4::identity());
+	worlds.push_back(parentSlot == NONE ? math::mat4::identity() : worlds[parentSlot]);
+	parents.push_back(parentSlot);
+	childCounts.push_back(0);
+	handles.push_back(handle);
+	versions.push_back(0);
+	dirty.push_back(0);
+	if (parentSlot != NONE) childCounts[parentSlot]++;
+	slots[handle] = slot;
+	markDirty(slot);
+	byDepth = false;
+	return handle;
+}
+
+/*
+	The last node fills the hole. It has no children after it, so the order
+	only breaks if its parent now comes later, or (once unordered) if it has
+	children before it
+*/
+void FlatSceneHierarchy::destroy(Handle node) {
+	const ui32 slot = slotOf(node);
+	if (childCounts[slot] > 0) {
+		for (ui32 i = 0; i < parents.size(); i++) {
+			if (parents[i] != slot) continue;
+			parents[i] = NONE;
+			markDirty(i);
+		}
+	}
+	if (parents[slot] != NONE) childCounts[parents[slot]]--;
+
+	const ui32 last = static_cast<ui32>(handles.size() - 1);
+	if (slot != last) {
+		moveSlot(last, slot);
+		if (childCounts[slot] > 0) {
+			for (ui32& parent : parents) {
+				if (parent == last) parent = slot;
+			}
+			unordered = true;
+		}
+		if (parents[slot] != NONE && parents[slot] > slot) unordered = true;
+		if (dirty[slot]) markDirty(slot);
+	}
+	locals.pop_back();
+	worlds.pop_back();
+	parents.pop_back();
+	childCounts.pop_back();
+	handles.pop_back();
+	versions.pop_back();
+	dirty.pop_back();
+	// only the destroyed node itself was dirty
+	if (firstDirty != NONE && firstDirty >= handles.size()) firstDirty = NONE;
+
+	slots[node] = NONE;
+	freeHandles.push_back(node);
+	byDepth = false;
+}
+
+void FlatSceneHierarchy::setParent(Handle node, Handle parent) {
+	const ui32 slot = slotOf(node);
+	const ui32 parentSlot = parent == NONE ? NONE : slotOf(parent);
+	if (parents[slot] == parentSlot) return;
+	for (ui32 ancestor = parentSlot; ancestor != NONE; ancestor = parents[ancestor]) {
+		if (ancestor == slot) {
+			throw std::invalid_argument("setParent: a node cannot be parented to itself or its descendants");
+		}
+	}
+
+	if (parents[slot] != NONE) childCounts[parents[slot]]--;
+	parents[slot] = parentSlot;
+	if (parentSlot != NONE) {
+		childCounts[parentSlot]++;
+		if (parentSlot > slot) unordered = true;
+	}
+	markDirty(slot);
+	byDepth = false;
+}
+
+FlatSceneHierarchy::Handle FlatSceneHierarchy::getParent(Handle node) const {
+	const ui32 parent = parents[slotOf(node)];
+	return parent == NONE ? NONE : handles[parent];
+}
+
+void FlatSceneHierarchy::setLocalTransform(Handle node, const math::mat4& transform) {
+	const ui32 slot = slotOf(node);
+	if (locals[slot] == transform) return;
+	locals[slot] = transform;
+	markDirty(slot);
+}
+
+const math::mat4& FlatSceneHierarchy::getLocalTransform(Handle node) const {
+	return locals[slotOf(node)];
+}
+
+const math::mat4& FlatSceneHierarchy::getWorldTransform(Handle node) const {
+	return worlds[slotOf(node)];
+}
+
+ui32 FlatSceneHierarchy::getWorldVersion(Handle node) const {
+	return versions[slotOf(node)];
+}
+
+/*
+	A parent recomputed by this pass has this pass' version, so its children
+	follow without a separate propagation step
+*/
+void FlatSceneHierarchy::updateWorldTransforms() {
+	if (unordered) sortTopologically();
+
+	const ui32 version = ++updateCount;
+	const ui32 count = static_cast<ui32>(handles.size());
+	size_t updated = 0;
+	for (ui32 i = firstDirty == NONE ? count : firstDirty; i < count; i++) {
+		if (updateSlot(i, version)) updated++;
+	}
+	finishUpdate(updated);
+}
+
+/*
+	With the nodes laid out by depth, every level is a range of slots.
+	Levels run in order, each parallelFor returning only once the whole
+	level is final, and are split in fixed chunks, so nothing but the
+	scheduling depends on the number of workers
+*/
+void FlatSceneHierarchy::updateWorldTransforms(util::ThreadPool& pool) {
+	if (handles.size() < PARALLEL_MIN_NODES || firstDirty == NONE) {
+		updateWorldTransforms();
+		return;
+	}
+	if (unordered) sortTopologically();
+	if (!byDepth) sortByDepth();
+
+	const ui32 version = ++updateCount;
+	std::vector<size_t> updatedBy(pool.size(), 0);
+	size_t updated = 0;
+	for (size_t level = 0; level + 1 < levelStarts.size(); level++) {
+		const ui32 begin = std::max(levelStarts[level], firstDirty), end = levelStarts[level + 1];
+		if (begin >= end) continue;
+		if (end - begin < PARALLEL_CHUNK) {
+			for (ui32 i = begin; i < end; i++) {
+				if (updateSlot(i, version)) updated++;
+			}
+			continue;
+		}
+		const size_t chunks = (end - begin + PARALLEL_CHUNK - 1) / PARALLEL_CHUNK;
+		pool.parallelFor(chunks, [&](size_t chunk, size_t worker) {
+			const ui32 first = begin + static_cast<ui32>(chunk * PARALLEL_CHUNK);
+			const ui32 last = std::min(end, first + static_cast<ui32>(PARALLEL_CHUNK));
+			size_t chunkUpdated = 0;
+			for (ui32 i = first; i < last; i++) {
+				if (updateSlot(i, version)) chunkUpdated++;
+			}
+			updatedBy[worker] += chunkUpdated;
+		});
+	}
+	for (size_t workerUpdated : updatedBy) updated += workerUpdated;
+	finishUpdate(updated);
+}
+
+bool FlatSceneHierarchy::needsUpdate() const {
+	return firstDirty != NONE;
+}
+
+const FlatSceneHierarchy::UpdateCounters& FlatSceneHierarchy::getCounters() const {
+	return counters;
+}
+
+const FlatSceneHierarchy::UpdateCounters& FlatSceneHierarchy::getLastUpdate() const {
+	return lastUpdate;
+}
+
+void FlatSceneHierarchy::resetCounters() {
+	counters = {};
+}
+
+bool FlatSceneHierarchy::contains(Handle node) const {
+	return node < slots.size() && slots[node] != NONE;
+}
+
+size_t FlatSceneHierarchy::size() const {
+	return handles.size();
+}
+
+std::span<const math::mat4> FlatSceneHierarchy::localTransforms() const {
+	return locals;
+}
+
+std::span<const math::mat4> FlatSceneHierarchy::worldTransforms() const {
+	return worlds;
+}
+
+std::span<const ui32> FlatSceneHierarchy::parentIndices() const {
+	return parents;
+}
+
+ui32 FlatSceneHierarchy::slotOf(Handle node) const {
+	if (!contains(node)) throw std::invalid_argument("FlatSceneHierarchy: unknown node handle");
+	return slots[node];
+}
+
+void FlatSceneHierarchy::moveSlot(ui32 from, ui32 to) {
+	locals[to] = locals[from];
+	worlds[to] = worlds[from];
+	parents[to] = parents[from];
+	childCounts[to] = childCounts[from];
+	handles[to] = handles[from];
+	versions[to] = versions[from];
+	dirty[to] = dirty[from];
+	slots[handles[to]] = to;
+}
+
+void FlatSceneHierarchy::markDirty(ui32 slot) {
+	dirty[slot] = 1;
+	if (firstDirty == NONE || slot < firstDirty) firstDirty = slot;
+}
+
+bool FlatSceneHierarchy::updateSlot(ui32 slot, ui32 version) {
+	const ui32 parent = parents[slot];
+	if (!dirty[slot] && (parent == NONE || versions[parent] != version)) return false;
+	worlds[slot] = parent == NONE ? locals[slot] : worlds[parent] * locals[slot];
+	versions[slot] = version;
+	dirty[slot] = 0;
+	return true;
+}
+
+void FlatSceneHierarchy::finishUpdate(size_t updated) {
+	const size_t count = handles.size();
+	firstDirty = NONE;
+	lastUpdate = { 1, updated, count - updated };
+	counters.updates++;
+	counters.updated += updated;
+	counters.skipped += count - updated;
+}
+
+/*
+	Depths are known in a single pass, parents coming first. A stable sort
+	by depth keeps that order, and is skipped if the nodes already are by
+	depth - the usual case when only transforms changed
+*/
+void FlatSceneHierarchy::sortByDepth() {
+	const ui32 count = static_cast<ui32>(handles.size());
+
+	std::vector<ui32> depths(count);
+	levelStarts.assign(1, 0);
+	for (ui32 i = 0; i < count; i++) {
+		depths[i] = parents[i] == NONE ? 0 : depths[parents[i]] + 1;
+		if (depths[i] + 2 > levelStarts.size()) levelStarts.resize(depths[i] + 2, 0);
+		levelStarts[depths[i] + 1]++;
+	}
+	for (size_t level = 1; level < levelStarts.size(); level++) levelStarts[level] += levelStarts[level - 1];
+
+	if (!std::is_sorted(depths.begin(), depths.end())) {
+		std::vector<ui32> order(count);
+		std::vector<ui32> filled(levelStarts.begin(), levelStarts.end() - 1);
+		for (ui32 i = 0; i < count; i++) order[filled[depths[i]]++] = i;
+		reorder(order);
+	}
+	byDepth = true;
+}
+
+void FlatSceneHierarchy::sortTopologically() {
+	const ui32 count = static_cast<ui32>(handles.size());
+
+	// children of every slot, in slot order
+	std::vector<ui32> firstChild(count + 1, 0);
+	for (ui32 parent : parents) {
+		if (parent != NONE) firstChild[parent + 1]++;
+	}
+	for (ui32 i = 0; i < count; i++) firstChild[i + 1] += firstChild[i];
+	std::vector<ui32> children(firstChild[count]);
+	std::vector<ui32> filled(firstChild.begin(), firstChild.end() - 1);
+	for (ui32 i = 0; i < count; i++) {
+		if (parents[i] != NONE) children[filled[parents[i]]++] = i;
+	}
+
+	// depth-first from every root, first children first
+	std::vector<ui32> order;
+	order.reserve(count);
+	std::vector<ui32> stack;
+	for (ui32 root = 0; root < count; root++) {
+		if (parents[root] != NONE) continue;
+		stack.push_back(root);
+		while (!stack.empty()) {
+			const ui32 slot = stack.back();
+			stack.pop_back();
+			order.push_back(slot);
+			for (ui32 c = firstChild[slot + 1]; c > firstChild[slot]; c--) stack.push_back(children[c - 1]);
+		}
+	}
+	reorder(order);
+	unordered = false;
+	byDepth = false;
+}
+
+void FlatSceneHierarchy::reorder(const std::vector<ui32>& order) {
+	const ui32 count = static_cast<ui32>(handles.size());
+	std::vector<ui32> newSlots(count);
+	for (ui32 i = 0; i < count; i++) newSlots[order[i]] = i;
+
+	std::vector<math::mat4> sortedLocals(count), sortedWorlds(count);
+	std::vector<ui32> sortedParents(count), sortedChildCounts(count);
+	std::vector<Handle> sortedHandles(count);
+	std::vector<ui32> sortedVersions(count);
+	std::vector<u8> sortedDirty(count);
+	for (ui32 i = 0; i < count; i++) {
+		const ui32 old = order[i];
+		sortedLocals[i] = locals[old];
+		sortedWorlds[i] = worlds[old];
+		sortedParents[i] = parents[old] == NONE ? NONE : newSlots[parents[old]];
+		sortedChildCounts[i] = childCounts[old];
+		sortedHandles[i] = handles[old];
+		sortedVersions[i] = versions[old];
+		sortedDirty[i] = dirty[old];
+		slots[handles[old]] = i;
+	}
+	locals = std::move(sortedLocals);
+	worlds = std::move(sortedWorlds);
+	parents = std::move(sortedParents);
+	childCounts = std::move(sortedChildCounts);
+	handles = std::move(sortedHandles);
+	versions = std::move(sortedVersions);
+	dirty = std::move(sortedDirty);
+
+	firstDirty = NONE;
+	for (ui32 i = 0; i < count && firstDirty == NONE; i++) {
+		if (dirty[i]) firstDirty = i;
+	}
+}
+
+}
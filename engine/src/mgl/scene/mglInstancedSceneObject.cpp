@@ -0,0 +1,117 @@
+#include <mgl/scene/mglInstancedSceneObject.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace mgl {
+
+InstancedSceneObject::InstancedSceneObject(std::shared_ptr<Mesh> mesh, std::shared_ptr<Material> material,
+	std::shared_ptr<ShaderProgram> shaders)
+	: SceneNode(), shaders(shaders), mesh(mesh), material(material) {
+	glGenBuffers(1, &instanceBuffer);
+}
+
+InstancedSceneObject::~InstancedSceneObject() {
+	glDeleteBuffers(1, &instanceBuffer);
+}
+
+size_t InstancedSceneObject::addInstance(const math::mat4& transform) {
+	instances.push_back(transform);
+	instancesDirty = true;
+	return instances.size() - 1;
+}
+
+void InstancedSceneObject::setInstance(size_t index, const math::mat4& transform) {
+	instances.at(index) = transform;
+	instancesDirty = true;
+}
+
+const math::mat4& InstancedSceneObject::getInstance(size_t index) const {
+	return instances.at(index);
+}
+
+void InstancedSceneObject::removeInstance(size_t index) {
+	if (index >= instances.size()) {
+		throw std::out_of_range("removeInstance: no instance " + std::to_string(index));
+	}
+	instances[index] = instances.back();
+	instances.pop_back();
+	instancesDirty = true;
+}
+
+void InstancedSceneObject::clearInstances() {
+	instances.clear();
+	instancesDirty = true;
+}
+
+size_t InstancedSceneObject::getInstanceCount() const {
+	return instances.size();
+}
+
+void InstancedSceneObject::setShaderUniformCallback(SetShaderUniformCallback callback) {
+	shaderUniformCallbacks.push_back(callback);
+}
+
+void InstancedSceneObject::updateWorldBounds() {
+	instancesDirty = true;
+}
+
+/*
+	Model matrices are final: node transform, instance transform and, for
+	quantized meshes, the dequantization of positions stored in [0, 1]
+*/
+void InstancedSceneObject::uploadInstances() {
+	const bool quantized = mesh->getVertexLayout().quantized;
+	modelMatrices.resize(instances.size());
+	worldBounds = AABB();
+	for (size_t i = 0; i < instances.size(); i++) {
+		const math::mat4 world = AbsoluteTransform * instances[i];
+		worldBounds.expand(mesh->getBounds().box.transformed(world));
+		modelMatrices[i] = quantized ? world * mesh->getDequantization() : world;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+	const size_t size = modelMatrices.size() * sizeof(math::mat4);
+	if (modelMatrices.size() > instanceCapacity) {
+		instanceCapacity = modelMatrices.size();
+		glBufferData(GL_ARRAY_BUFFER, size, modelMatrices.data(), GL_DYNAMIC_DRAW);
+	}
+	else if (size > 0) {
+		glBufferSubData(GL_ARRAY_BUFFER, 0, size, modelMatrices.data());
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	instancesDirty = false;
+}
+
+void InstancedSceneObject::performDraw() {
+	updateAbsoluteTransform();
+	if (instancesDirty) uploadInstances();
+	if (instances.empty()) return;
+
+	shaders->bind();
+	if (material) material->updateShaders(*shaders);
+	if (scene) scene->updateShaders(*shaders); // update with global scene info
+	for (const auto& callback : shaderUniformCallbacks) {
+		callback(*shaders);
+	}
+	mesh->setDrawLod(0);
+	mesh->setInstances(instanceBuffer, static_cast<GLsizei>(instances.size()));
+	mesh->draw();
+	shaders->unbind();
+}
+
+void InstancedSceneObject::setScene(Scene* scene) {
+	this->scene = scene;
+}
+
+void InstancedSceneObject::setSkybox(std::shared_ptr<TextureSampler> skybox) {
+	// only add skybox to shaders that are expecting it
+	if (material && shaders->isUniform(skybox->uniform)) {
+		material->addTexture(skybox);
+	}
+}
+
+Material& InstancedSceneObject::getMaterial() {
+	return *material;
+}
+
+}
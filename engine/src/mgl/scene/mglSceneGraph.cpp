@@ -1,11 +1,13 @@
 #include <mgl/scene/mglSceneGraph.hpp>
 #include <mgl/mglConventions.hpp>
 #include <mgl/models/materials/mglBasicMaterial.hpp>
+#include <mgl/models/meshes/mglMeshFactory.hpp>
 #include <mgl/models/textures/mglTexture.hpp>
 #include <mgl/models/textures/mglTextureSampler.hpp>
 #include <mgl/scene/mglSceneObject.hpp>
 #include <mgl/shaders/ShaderBuilder.hpp>
 #include <utils/Logger.hpp>
+#include <utils/ThreadPool.hpp>
 
 namespace mgl {
 
@@ -66,8 +68,8 @@ void Scene::addCamera(const std::string& name, std::shared_ptr<Camera> camera) {
 }
 
 void Scene::setSkybox(const std::string& folder, const std::string& fileType) {
-	// import skybox mesh
-	meshes->import(SKYBOX, "models/cube-vtn.obj");
+	// skybox mesh - generated, no file to import
+	meshes->create(SKYBOX, mgl::MeshFactory::cube());
 	// create skybox shader
 	mgl::ShaderBuilder skyboxShaders = mgl::ShaderBuilder();
 	skyboxShaders.addShader(GL_VERTEX_SHADER, "shaders/skyboxVS.glsl");
@@ -105,6 +107,7 @@ void Scene::setSkybox(const std::string& folder, const std::string& fileType) {
 			glCullFace(GL_BACK);
 			glDepthFunc(GL_LESS);
 		});
+	skyboxObj->setCullFace(GL_FRONT);
 
 	this->skybox = skyboxObj;
 	graph->setSkybox(cubeTinfo);
@@ -130,6 +133,7 @@ void Scene::performDraw() {
 	// usually draw skybox at end for performance
 	// but we draw it first because we have transparent objects
 	// and we need to draw the background first to see the transparency
+	SceneNode::updateTransforms();
 	if (skybox) skybox->draw();
 	if (graph)  graph ->draw();
 }
@@ -146,15 +150,64 @@ void Scene::updateShaders(ShaderProgram& shaders) {
 SceneGraph* SceneNode::NO_PARENT = nullptr;
 
 SceneNode::SceneNode() : IDrawable(), Transform(), 
-	Parent(NO_PARENT), AbsoluteTransform(I) {}
+	Parent(NO_PARENT), AbsoluteTransform(I), handle(getHierarchy().create()) {
+	getHierarchy().setLocalTransform(handle, transformMatrix);
+}
+
+SceneNode::~SceneNode() {
+	getHierarchy().destroy(handle);
+}
+
+FlatSceneHierarchy& SceneNode::getHierarchy() {
+	// never destroyed - nodes may outlive static destruction
+	static FlatSceneHierarchy* hierarchy = new FlatSceneHierarchy();
+	return *hierarchy;
+}
+
+FlatSceneHierarchy::Handle SceneNode::getHandle() const {
+	return handle;
+}
+
+void SceneNode::updateTransforms() {
+	FlatSceneHierarchy& hierarchy = getHierarchy();
+	if (hierarchy.needsUpdate()) {
+		hierarchy.updateWorldTransforms(util::ThreadPool::shared());
+	}
+}
+
+void SceneNode::onTransformChanged() {
+	getHierarchy().setLocalTransform(handle, transformMatrix);
+}
 
 math::vec3 SceneNode::getAbsolutePosition() const {
 	return math::vec3(AbsoluteTransform * math::vec4(getPosition(), 1.0f));
 }
 
+const AABB& SceneNode::getWorldBounds() const {
+	return worldBounds;
+}
+
+void SceneNode::updateAbsoluteTransform() {
+	FlatSceneHierarchy& hierarchy = getHierarchy();
+	if (hierarchy.needsUpdate()) {
+		hierarchy.updateWorldTransforms();
+	}
+	const ui32 version = hierarchy.getWorldVersion(handle);
+	if (boundsDirty || version != worldVersion) {
+		AbsoluteTransform = hierarchy.getWorldTransform(handle);
+		worldVersion = version;
+		updateWorldBounds();
+		boundsDirty = false;
+	}
+}
+
 ////////////////////////////////////////////////////////////////// SceneGraph
 
 SceneGraph::~SceneGraph(void) {
+	// children kept alive elsewhere become roots
+	for (const auto& node : children) {
+		node.second->Parent = NO_PARENT;
+	}
 	children.clear();
 }
 
@@ -165,21 +218,27 @@ SceneGraph::SceneGraph(std::shared_ptr<SceneNode> child) : SceneGraph() {
 }
 
 void SceneGraph::add(std::shared_ptr<SceneNode> child) {
+	getHierarchy().setParent(child->getHandle(), getHandle());
 	children.insert(std::make_pair(child->getId(), child));
 	child->Parent = this;
 }
 
 void SceneGraph::remove(std::shared_ptr<SceneNode> child) {
-	child->Parent = NO_PARENT;
+	if (child->Parent == this) {
+		getHierarchy().setParent(child->getHandle(), FlatSceneHierarchy::NONE);
+		child->Parent = NO_PARENT;
+	}
 	children.erase(child->getId());
 }
 
 void SceneGraph::performDraw() {
-	AbsoluteTransform = Parent == NO_PARENT ? getTransformMatrix() :
-				  Parent->AbsoluteTransform * getTransformMatrix();
+	updateAbsoluteTransform();
 
+	// children refresh their bounds while drawing - gather them afterwards
+	worldBounds = AABB();
 	for (const auto& node : children) {
 		node.second->draw();
+		worldBounds.expand(node.second->getWorldBounds());
 	}
 }
 
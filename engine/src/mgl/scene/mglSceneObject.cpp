@@ -1,5 +1,7 @@
 #include <mgl/scene/mglSceneObject.hpp>
 #include <mgl/mglConventions.hpp>
+#include <mgl/camera/mglCamera.hpp>
+#include <algorithm>
 namespace mgl {
 
 SceneObject::SceneObject() : SceneNode() {}
@@ -26,7 +28,11 @@ SceneObject::~SceneObject() {}
 */
 void SceneObject::setUniforms() {
 	// TODO - allows no use of camera model, but is slower
-	if (shaders->isUniform(MODEL_MATRIX)) shaders->setUniform(MODEL_MATRIX, AbsoluteTransform);
+	if (shaders->isUniform(MODEL_MATRIX)) {
+		// quantized meshes store positions in [0, 1] within their bounds
+		shaders->setUniform(MODEL_MATRIX, mesh->getVertexLayout().quantized ?
+			AbsoluteTransform * mesh->getDequantization() : AbsoluteTransform);
+	}
 	
 	for (const auto& callback : shaderUniformCallbacks) {
 		callback(*shaders);
@@ -37,18 +43,79 @@ void SceneObject::setShaderUniformCallback(SetShaderUniformCallback callback) {
 	shaderUniformCallbacks.push_back(callback);
 }
 
+LodSelector& SceneObject::getLodSelector() {
+	return lodSelector;
+}
+
+void SceneObject::setCullFace(GLenum face) {
+	cullFace = face;
+}
+
+GLenum SceneObject::getCullFace() const {
+	return cullFace;
+}
+
+/*
+	Projects the object-space LOD errors to pixels at the distance of the
+	closest point of the bounding sphere, scaled by the largest axis scale
+	of the model matrix
+*/
+void SceneObject::selectLod() {
+	const Camera* camera = Camera::getActive();
+	if (!camera) return;
+
+	const BoundingSphere sphere = mesh->getBounds().sphere.transformed(AbsoluteTransform);
+	const float distance = std::max(
+		(sphere.center - camera->getPosition()).length() - std::max(sphere.radius, 0.0f), 0.0f);
+	float scale = 0.0f;
+	for (int c = 0; c < 3; c++) {
+		const math::vec3 axis(AbsoluteTransform(0, c), AbsoluteTransform(1, c), AbsoluteTransform(2, c));
+		scale = std::max(scale, axis.length());
+	}
+	const float pixelsPerUnit = scale * LodSelector::pixelsPerUnit(
+		camera->getProjectionMatrix(), static_cast<float>(camera->getViewportHeight()), distance);
+	lodSelector.select(mesh->getLodErrors(), pixelsPerUnit);
+}
+
+/*
+	Meshlet bounds live in object space - bring the frustum and camera there.
+	The cull face is the one declared with setCullFace rather than read back
+	from OpenGL, which would stall on every draw
+*/
+void SceneObject::cullMeshlets() {
+	const Camera* camera = Camera::getActive();
+	if (!camera) return;
+
+	const math::mat4 modelViewProjection =
+		camera->getProjectionMatrix() * camera->getViewMatrix() * AbsoluteTransform;
+	const math::vec3 position = camera->getPosition();
+	const math::vec4 local = math::inverse(AbsoluteTransform) * math::vec4(position[0], position[1], position[2], 1.0f);
+	mesh->cullMeshlets(modelViewProjection, math::vec3(local[0], local[1], local[2]), cullFace);
+}
+
+// World space box of the mesh bounds under the current absolute transform
+void SceneObject::updateWorldBounds() {
+	worldBounds = mesh ? mesh->getBounds().box.transformed(AbsoluteTransform) : AABB();
+}
+
 /*
 	Update associated shaders with current absolute model matrix,
 	material uniforms, and scene global information such as lights
 */
 void SceneObject::performDraw() {
-	AbsoluteTransform = (Parent == NO_PARENT) ? getTransformMatrix() :
-		Parent->AbsoluteTransform * getTransformMatrix();
+	updateAbsoluteTransform();
 
 	shaders->bind();
 	if (material) material->updateShaders(*shaders);
 	if (scene) scene->updateShaders(*shaders); // update with global scene info
 	setUniforms();
+	if (mesh->getLodCount() > 1) {
+		selectLod();
+	}
+	mesh->setDrawLod(lodSelector.getLevel());
+	if (lodSelector.getLevel() == 0 && !mesh->getMeshlets().empty()) {
+		cullMeshlets();
+	}
 	mesh->draw();
 	shaders->unbind();
 }
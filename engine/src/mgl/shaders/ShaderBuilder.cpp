@@ -1,5 +1,6 @@
 #include <mgl/shaders/ShaderBuilder.hpp>
 #include <mgl/shaders/ShaderProgram.hpp>
+#include <mgl/shaders/ShaderSource.hpp>
 #include <utils/file.hpp>
 #include <utils/Logger.hpp>
 #include <string>
@@ -25,13 +26,12 @@ void ShaderBuilder::addAttribute(const std::string &name, const i32 index) {
 
 
 ui32 ShaderBuilder::buildShader(const GLenum shader_type, const std::string &filename) {
-    // try reading shader from file
-    const std::string scode = file::readFile(filename);
-    if (scode == FILE_DOESNT_EXIST) {
-        MGL_ERROR("File not found: " + filename);
+    // try reading shader from file, or its compiled version
+    const std::optional<ShaderSource> source = ShaderSource::load(filename);
+    if (!source) {
         exit(EXIT_FAILURE);
     }
-    const GLchar *code = scode.c_str();
+    const GLchar *code = source->code.c_str();
     
     // specify type of shader we want to create
     const GLuint shader_id = glCreateShader(shader_type);
@@ -41,6 +41,10 @@ void ShaderProgram::setUniform(i32 loc, const math::vec3& v) { glUniform3fv(loc,
 void ShaderProgram::setUniform(i32 loc, const math::vec4& v) { glUniform4fv(loc, 1, v.data()); }
 void ShaderProgram::setUniform(i32 loc, const math::mat4& m) { glUniformMatrix4fv(loc, 1, GL_FALSE, m.data()); }
 
+void ShaderProgram::setUniform(i32 loc, std::span<const f32> v) {
+  glUniform1fv(loc, static_cast<GLsizei>(v.size()), v.data());
+}
+
 
 void ShaderProgram::assertUniform(const std::string &name) {
     if (!isUniform(name)) {
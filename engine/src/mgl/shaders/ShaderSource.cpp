@@ -0,0 +1,158 @@
+#include <mgl/shaders/ShaderSource.hpp>
+#include <utils/file.hpp>
+#include <utils/Logger.hpp>
+
+#include <fstream>
+#include <sstream>
+#include <unordered_set>
+
+namespace mgl {
+
+namespace {
+
+    std::filesystem::path& cacheDirectory() {
+        static std::filesystem::path dir = file::exe_dir() / "cache" / "shaders";
+        return dir;
+    }
+
+    std::filesystem::path compiledPath(const std::string &filename) {
+        return cacheDirectory() / filename;
+    }
+
+    std::filesystem::path dependencyPath(const std::string &filename) {
+        std::filesystem::path path = compiledPath(filename);
+        path += ".d";
+        return path;
+    }
+
+    // Path of the file included by line, if it is an #include "file" directive
+    std::optional<std::string> includedFile(const std::string &line) {
+        size_t i = line.find_first_not_of(" \t");
+        if (i == std::string::npos || line[i] != '#') return std::nullopt;
+        i = line.find_first_not_of(" \t", i + 1);
+        if (i == std::string::npos || line.compare(i, 7, "include") != 0) return std::nullopt;
+        const size_t open = line.find('"', i + 7);
+        const size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+        if (close == std::string::npos) return std::nullopt;
+        return line.substr(open + 1, close - open - 1);
+    }
+
+    bool expand(const std::string &filename, const std::string &includedFrom,
+                ShaderSource &source, std::unordered_set<std::string> &included) {
+        const std::string code = file::readFile(filename);
+        if (code == FILE_DOESNT_EXIST) {
+            if (includedFrom.empty()) {
+                MGL_ERROR("Shader file not found: {}", filename);
+            } else {
+                MGL_ERROR("Shader file not found: {} (included from {})", filename, includedFrom);
+            }
+            return false;
+        }
+
+        const size_t index = source.dependencies.size();
+        source.dependencies.push_back(filename);
+        std::istringstream lines(code);
+        std::string line;
+        for (size_t number = 1; std::getline(lines, line); number++) {
+            const std::optional<std::string> include = includedFile(line);
+            if (!include) {
+                source.code += line;
+                source.code += '\n';
+                continue;
+            }
+            const std::string path = (std::filesystem::path(filename).parent_path() / *include)
+                .lexically_normal().generic_string();
+            if (included.insert(path).second) {
+                source.code += "#line 1 " + std::to_string(source.dependencies.size()) + "\n";
+                if (!expand(path, filename, source, included)) return false;
+            }
+            source.code += "#line " + std::to_string(number + 1) + " " + std::to_string(index) + "\n";
+        }
+        return true;
+    }
+
+    std::optional<std::vector<std::string>> readDependencies(const std::string &filename) {
+        std::ifstream in(dependencyPath(filename));
+        if (!in) return std::nullopt;
+        std::vector<std::string> dependencies;
+        std::string dependency;
+        while (std::getline(in, dependency)) {
+            if (!dependency.empty()) dependencies.push_back(dependency);
+        }
+        if (dependencies.empty()) return std::nullopt;
+        return dependencies;
+    }
+
+} // namespace
+
+std::optional<ShaderSource> ShaderSource::preprocess(const std::string &filename) {
+    ShaderSource source;
+    std::unordered_set<std::string> included = {
+        std::filesystem::path(filename).lexically_normal().generic_string()
+    };
+    if (!expand(filename, {}, source, included)) {
+        return std::nullopt;
+    }
+    return source;
+}
+
+bool ShaderSource::isCompiled(const std::string &filename) {
+    std::error_code error;
+    const auto compiled = std::filesystem::last_write_time(compiledPath(filename), error);
+    if (error) return false;
+    const std::optional<std::vector<std::string>> dependencies = readDependencies(filename);
+    if (!dependencies) return false;
+    for (const std::string &dependency : *dependencies) {
+        const auto modified = std::filesystem::last_write_time(file::resource_path(dependency), error);
+        if (error || modified > compiled) return false;
+    }
+    return true;
+}
+
+std::optional<ShaderSource> ShaderSource::load(const std::string &filename) {
+    if (isCompiled(filename)) {
+        std::ifstream in(compiledPath(filename), std::ios::binary);
+        std::optional<std::vector<std::string>> dependencies = readDependencies(filename);
+        if (in && dependencies) {
+            std::ostringstream code;
+            code << in.rdbuf();
+            return ShaderSource{ code.str(), std::move(*dependencies) };
+        }
+    }
+    return preprocess(filename);
+}
+
+bool ShaderSource::store(const std::string &filename) const {
+    std::error_code error;
+    std::filesystem::create_directories(compiledPath(filename).parent_path(), error);
+
+    // the dependency list is written last - a source without one is never used
+    std::filesystem::remove(dependencyPath(filename), error);
+    {
+        std::ofstream out(compiledPath(filename), std::ios::binary | std::ios::trunc);
+        out << code;
+        if (!out) {
+            MGL_WARN("Could not write compiled shader {}", compiledPath(filename).string());
+            return false;
+        }
+    }
+    std::ofstream out(dependencyPath(filename), std::ios::trunc);
+    for (const std::string &dependency : dependencies) {
+        out << dependency << '\n';
+    }
+    if (!out) {
+        MGL_WARN("Could not write compiled shader {}", dependencyPath(filename).string());
+        return false;
+    }
+    return true;
+}
+
+void ShaderSource::setCacheDirectory(const std::filesystem::path &directory) {
+    cacheDirectory() = directory;
+}
+
+std::filesystem::path ShaderSource::getCacheDirectory() {
+    return cacheDirectory();
+}
+
+} // namespace mgl
@@ -44,6 +44,7 @@ void MyApp::createMeshes() {
     meshes = new mgl::MeshManager();
     meshes->meshConfigCallback([](mgl::Mesh* mesh) {
         mesh->joinIdenticalVertices();
+        mesh->buildMeshlets(); // the scanned statue is dense - cull its clusters
     });
 
     meshes->import("light", "models/sphere.obj");
@@ -269,6 +270,7 @@ void MyApp::createSceneGraph() {
         []() { // after
             glCullFace(GL_BACK);
         });
+    glassBackObj->setCullFace(GL_FRONT);
 
     mgl::SceneObject* glassFrontObj = new mgl::SceneObject(
         meshes->get("glass"),
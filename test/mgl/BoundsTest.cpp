@@ -0,0 +1,63 @@
+#include <mgl/mglBounds.hpp>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(BoundsTest, PointsAreEnclosed)
+{
+    const std::vector<mgl::math::vec3> points = {
+        mgl::math::vec3(-1.0f, 2.0f, 0.5f), mgl::math::vec3(3.0f, -2.0f, 1.0f), mgl::math::vec3(0.0f, 0.0f, -4.0f),
+    };
+    const mgl::Bounds bounds = mgl::Bounds::fromPoints(points);
+
+    EXPECT_TRUE(bounds.box.min == mgl::math::vec3(-1.0f, -2.0f, -4.0f));
+    EXPECT_TRUE(bounds.box.max == mgl::math::vec3(3.0f, 2.0f, 1.0f));
+    for (const mgl::math::vec3& p : points) {
+        EXPECT_LE((p - bounds.sphere.center).length(), bounds.sphere.radius + 1e-5f);
+    }
+    EXPECT_TRUE(mgl::AABB().empty());
+    EXPECT_TRUE(mgl::Bounds::fromPoints({}).sphere.empty());
+}
+
+TEST(BoundsTest, ArvoTransformMatchesTransformedCorners)
+{
+    mgl::AABB box;
+    box.expand(mgl::math::vec3(-1.0f, 0.0f, 2.0f));
+    box.expand(mgl::math::vec3(2.0f, 3.0f, 5.0f));
+
+    mgl::math::mat4 m = mgl::math::mat4::identity();
+    m(0, 0) = 0.0f;  m(0, 1) = -2.0f; m(0, 3) = 10.0f;
+    m(1, 0) = 1.0f;  m(1, 1) = 0.0f;  m(1, 2) = 0.5f;
+    m(2, 2) = -3.0f; m(2, 3) = 1.0f;
+
+    mgl::AABB expected;
+    for (int corner = 0; corner < 8; corner++) {
+        const mgl::math::vec4 p((corner & 1) ? box.max[0] : box.min[0],
+                                (corner & 2) ? box.max[1] : box.min[1],
+                                (corner & 4) ? box.max[2] : box.min[2], 1.0f);
+        const mgl::math::vec4 q = m * p;
+        expected.expand(mgl::math::vec3(q[0], q[1], q[2]));
+    }
+
+    const mgl::AABB transformed = box.transformed(m);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_NEAR(transformed.min[i], expected.min[i], 1e-5f);
+        EXPECT_NEAR(transformed.max[i], expected.max[i], 1e-5f);
+    }
+}
+
+TEST(BoundsTest, MergeEnclosesParts)
+{
+    const std::vector<mgl::math::vec3> a = { mgl::math::vec3(0.0f, 0.0f, 0.0f), mgl::math::vec3(1.0f, 1.0f, 1.0f) };
+    const std::vector<mgl::math::vec3> b = { mgl::math::vec3(5.0f, 0.0f, 0.0f), mgl::math::vec3(6.0f, 2.0f, 1.0f) };
+    const std::vector<mgl::Bounds> parts = { mgl::Bounds::fromPoints(a), mgl::Bounds(), mgl::Bounds::fromPoints(b) };
+    const mgl::Bounds merged = mgl::Bounds::merge(parts);
+
+    EXPECT_TRUE(merged.box.min == mgl::math::vec3(0.0f, 0.0f, 0.0f));
+    EXPECT_TRUE(merged.box.max == mgl::math::vec3(6.0f, 2.0f, 1.0f));
+    for (const auto* points : { &a, &b }) {
+        for (const mgl::math::vec3& p : *points) {
+            EXPECT_LE((p - merged.sphere.center).length(), merged.sphere.radius + 1e-5f);
+        }
+    }
+}
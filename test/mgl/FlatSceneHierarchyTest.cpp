@@ -0,0 +1,251 @@
+#include <mgl/scene/mglFlatSceneHierarchy.hpp>
+#include <mgl/scene/mglSceneGraph.hpp>
+#include <utils/ThreadPool.hpp>
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    using mgl::FlatSceneHierarchy;
+    using Handle = FlatSceneHierarchy::Handle;
+
+    mgl::math::mat4 translation(float x, float y, float z) {
+        return mgl::math::translate(mgl::math::mat4::identity(), mgl::math::vec3(x, y, z));
+    }
+
+    // world transform by walking up the parents
+    mgl::math::mat4 expectedWorld(const FlatSceneHierarchy& hierarchy, Handle node) {
+        mgl::math::mat4 world = hierarchy.getLocalTransform(node);
+        for (Handle parent = hierarchy.getParent(node); parent != FlatSceneHierarchy::NONE;
+             parent = hierarchy.getParent(parent)) {
+            world = hierarchy.getLocalTransform(parent) * world;
+        }
+        return world;
+    }
+
+    void expectParentsFirst(const FlatSceneHierarchy& hierarchy) {
+        const auto parents = hierarchy.parentIndices();
+        for (size_t i = 0; i < parents.size(); i++) {
+            if (parents[i] != FlatSceneHierarchy::NONE) {
+                EXPECT_LT(parents[i], i);
+            }
+        }
+    }
+
+    void expectNear(const mgl::math::mat4& a, const mgl::math::mat4& b) {
+        for (int r = 0; r < 4; r++) {
+            for (int c = 0; c < 4; c++) EXPECT_NEAR(a(r, c), b(r, c), 1e-3f);
+        }
+    }
+
+}
+
+TEST(FlatSceneHierarchyTest, ComposesWorldTransformsParentsFirst)
+{
+    FlatSceneHierarchy hierarchy;
+    const Handle root = hierarchy.create();
+    const Handle child = hierarchy.create(root);
+    const Handle grandchild = hierarchy.create(child);
+    hierarchy.setLocalTransform(root, translation(1, 0, 0));
+    hierarchy.setLocalTransform(child, translation(0, 2, 0));
+    hierarchy.setLocalTransform(grandchild, translation(0, 0, 3));
+    ASSERT_TRUE(hierarchy.needsUpdate());
+
+    hierarchy.updateWorldTransforms();
+    EXPECT_FALSE(hierarchy.needsUpdate());
+    EXPECT_EQ(hierarchy.getWorldTransform(grandchild), translation(1, 2, 3));
+
+    // under a node stored after it - the order is restored on update
+    const Handle late = hierarchy.create();
+    hierarchy.setLocalTransform(late, translation(10, 0, 0));
+    hierarchy.setParent(root, late);
+    hierarchy.updateWorldTransforms();
+    expectParentsFirst(hierarchy);
+    EXPECT_EQ(hierarchy.getParent(root), late);
+    EXPECT_EQ(hierarchy.getWorldTransform(grandchild), translation(11, 2, 3));
+
+    EXPECT_THROW(hierarchy.setParent(late, grandchild), std::invalid_argument);
+    EXPECT_THROW(hierarchy.setParent(late, late), std::invalid_argument);
+    EXPECT_THROW(hierarchy.create(1234), std::invalid_argument);
+}
+
+TEST(FlatSceneHierarchyTest, DestroyedNodesLeaveTheirChildrenAsRoots)
+{
+    FlatSceneHierarchy hierarchy;
+    const Handle root = hierarchy.create();
+    const Handle middle = hierarchy.create(root);
+    const Handle leaf = hierarchy.create(middle);
+    const Handle other = hierarchy.create(root);
+    hierarchy.setLocalTransform(root, translation(1, 0, 0));
+    hierarchy.setLocalTransform(leaf, translation(0, 1, 0));
+
+    hierarchy.destroy(middle);
+    EXPECT_FALSE(hierarchy.contains(middle));
+    EXPECT_EQ(hierarchy.size(), 3u);
+    EXPECT_EQ(hierarchy.getParent(leaf), FlatSceneHierarchy::NONE);
+    EXPECT_EQ(hierarchy.getParent(other), root);
+    hierarchy.updateWorldTransforms();
+    expectParentsFirst(hierarchy);
+    EXPECT_EQ(hierarchy.getWorldTransform(leaf), translation(0, 1, 0));
+    EXPECT_EQ(hierarchy.getWorldTransform(other), translation(1, 0, 0));
+    EXPECT_THROW(hierarchy.destroy(middle), std::invalid_argument);
+
+    // handles are reused
+    EXPECT_EQ(hierarchy.create(), middle);
+}
+
+TEST(FlatSceneHierarchyTest, MatchesTheHierarchyUnderRandomEdits)
+{
+    std::mt19937 random(7);
+    FlatSceneHierarchy hierarchy;
+    std::vector<Handle> nodes;
+    auto pick = [&]() { return nodes[std::uniform_int_distribution<size_t>(0, nodes.size() - 1)(random)]; };
+    std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+
+    for (int i = 0; i < 5000; i++) {
+        nodes.push_back(hierarchy.create(nodes.empty() || i % 50 == 0 ? FlatSceneHierarchy::NONE : pick()));
+        hierarchy.setLocalTransform(nodes.back(), translation(offset(random), offset(random), offset(random)));
+    }
+    for (int edit = 0; edit < 2000; edit++) {
+        const Handle node = pick();
+        switch (edit % 4) {
+        case 0: hierarchy.setLocalTransform(node, translation(offset(random), offset(random), offset(random))); break;
+        case 1:
+            try { hierarchy.setParent(node, pick()); }
+            catch (const std::invalid_argument&) {} // would create a cycle
+            break;
+        case 2: hierarchy.setParent(node, FlatSceneHierarchy::NONE); break;
+        case 3:
+            hierarchy.destroy(node);
+            std::erase(nodes, node);
+            break;
+        }
+        // incremental updates along the way must leave nothing stale
+        if (edit % 100 == 0) hierarchy.updateWorldTransforms();
+    }
+
+    hierarchy.updateWorldTransforms();
+    expectParentsFirst(hierarchy);
+    ASSERT_EQ(hierarchy.size(), nodes.size());
+    for (Handle node : nodes) {
+        expectNear(hierarchy.getWorldTransform(node), expectedWorld(hierarchy, node));
+    }
+}
+
+TEST(FlatSceneHierarchyTest, UpdatesOnlyDirtySubtrees)
+{
+    FlatSceneHierarchy hierarchy;
+    const Handle a = hierarchy.create();
+    const Handle aChild = hierarchy.create(a);
+    const Handle aGrandchild = hierarchy.create(aChild);
+    const Handle b = hierarchy.create();
+    const Handle bChild = hierarchy.create(b);
+    hierarchy.updateWorldTransforms();
+    EXPECT_EQ(hierarchy.getLastUpdate().updated, 5u);
+    EXPECT_FALSE(hierarchy.needsUpdate());
+
+    // nothing changed
+    hierarchy.updateWorldTransforms();
+    EXPECT_EQ(hierarchy.getLastUpdate().updated, 0u);
+    EXPECT_EQ(hierarchy.getLastUpdate().skipped, 5u);
+
+    // the same transform again does not dirty the node
+    hierarchy.setLocalTransform(b, hierarchy.getLocalTransform(b));
+    EXPECT_FALSE(hierarchy.needsUpdate());
+
+    const mgl::ui32 bVersion = hierarchy.getWorldVersion(bChild);
+    hierarchy.setLocalTransform(aChild, translation(0, 1, 0));
+    hierarchy.updateWorldTransforms();
+    EXPECT_EQ(hierarchy.getLastUpdate().updated, 2u);
+    EXPECT_EQ(hierarchy.getLastUpdate().skipped, 3u);
+    EXPECT_EQ(hierarchy.getWorldTransform(aGrandchild), translation(0, 1, 0));
+    EXPECT_EQ(hierarchy.getWorldVersion(bChild), bVersion);
+    EXPECT_NE(hierarchy.getWorldVersion(aGrandchild), bVersion);
+
+    // moving a subtree recomputes all of it
+    hierarchy.setParent(a, bChild);
+    hierarchy.setLocalTransform(b, translation(2, 0, 0));
+    hierarchy.updateWorldTransforms();
+    EXPECT_EQ(hierarchy.getLastUpdate().updated, 5u);
+    EXPECT_EQ(hierarchy.getWorldTransform(aGrandchild), translation(2, 1, 0));
+
+    EXPECT_EQ(hierarchy.getCounters().updates, 4u);
+    EXPECT_EQ(hierarchy.getCounters().updated, 12u);
+    EXPECT_EQ(hierarchy.getCounters().skipped, 8u);
+    hierarchy.resetCounters();
+    EXPECT_EQ(hierarchy.getCounters().updates, 0u);
+}
+
+TEST(FlatSceneHierarchyTest, ParallelUpdatesMatchTheSerialPass)
+{
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+    FlatSceneHierarchy serial, parallel;
+    std::vector<Handle> nodes;
+    auto pick = [&]() { return nodes[std::uniform_int_distribution<size_t>(0, nodes.size() - 1)(random)]; };
+    auto setLocal = [&](Handle node, const mgl::math::mat4& local) {
+        serial.setLocalTransform(node, local);
+        parallel.setLocalTransform(node, local);
+    };
+
+    // same handles in both, as long as they see the same edits
+    for (int i = 0; i < 20000; i++) {
+        const Handle parent = nodes.empty() || i % 500 == 0 ? FlatSceneHierarchy::NONE : pick();
+        nodes.push_back(serial.create(parent));
+        ASSERT_EQ(parallel.create(parent), nodes.back());
+        setLocal(nodes.back(), translation(offset(random), offset(random), offset(random)));
+    }
+
+    for (size_t workers : { 1u, 3u, 8u }) {
+        util::ThreadPool pool(workers);
+        for (int round = 0; round < 4; round++) {
+            serial.updateWorldTransforms();
+            parallel.updateWorldTransforms(pool);
+            EXPECT_EQ(parallel.getLastUpdate().updated, serial.getLastUpdate().updated);
+            for (Handle node : nodes) {
+                ASSERT_EQ(parallel.getWorldTransform(node), serial.getWorldTransform(node)) << workers << " workers";
+            }
+
+            for (int edit = 0; edit < 200; edit++) {
+                const Handle node = pick();
+                if (edit % 10 != 0) {
+                    setLocal(node, translation(offset(random), offset(random), offset(random)));
+                    continue;
+                }
+                const Handle parent = pick();
+                try { serial.setParent(node, parent); }
+                catch (const std::invalid_argument&) { continue; } // would create a cycle
+                parallel.setParent(node, parent);
+            }
+        }
+    }
+}
+
+TEST(FlatSceneHierarchyTest, SceneGraphNodesLiveInTheSharedHierarchy)
+{
+    FlatSceneHierarchy& hierarchy = mgl::SceneNode::getHierarchy();
+    const size_t nodes = hierarchy.size();
+    {
+        auto root = std::make_shared<mgl::SceneGraph>();
+        auto child = std::make_shared<mgl::SceneGraph>();
+        root->add(child);
+        root->translate(1.0f, 0.0f, 0.0f);
+        child->translate(0.0f, 2.0f, 0.0f);
+        EXPECT_EQ(hierarchy.size(), nodes + 2);
+        EXPECT_EQ(hierarchy.getParent(child->getHandle()), root->getHandle());
+        EXPECT_EQ(hierarchy.getLocalTransform(child->getHandle()), child->getTransformMatrix());
+
+        // drawing reads the world transforms
+        root->draw();
+        EXPECT_EQ(child->AbsoluteTransform, translation(1, 2, 0));
+
+        root->remove(child);
+        EXPECT_EQ(hierarchy.getParent(child->getHandle()), FlatSceneHierarchy::NONE);
+    }
+    EXPECT_EQ(hierarchy.size(), nodes);
+}
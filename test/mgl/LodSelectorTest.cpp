@@ -0,0 +1,44 @@
+#include <mgl/models/meshes/mglLodSelector.hpp>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+TEST(LodSelectorTest, PicksCoarsestLodUnderPixelError)
+{
+    const std::vector<float> errors = { 0.01f, 0.04f, 0.16f };
+    mgl::LodSelector selector;
+    selector.setHysteresis(0.0f);
+
+    EXPECT_EQ(selector.select(errors, 1000.0f), 0u);   // 10 px error at LOD 1
+    EXPECT_EQ(selector.select(errors, 20.0f), 2u);     // 0.8 px at LOD 2, 3.2 px at LOD 3
+    EXPECT_EQ(selector.select(errors, 1.0f), 3u);
+    EXPECT_EQ(selector.select({}, 1.0f), 0u);
+}
+
+TEST(LodSelectorTest, HysteresisKeepsLodNearThreshold)
+{
+    const std::vector<float> errors = { 0.01f };
+    mgl::LodSelector selector;
+    selector.setHysteresis(0.25f);
+
+    // LOD 1 error of 0.9 px is under the threshold but inside the dead band
+    EXPECT_EQ(selector.select(errors, 90.0f), 0u);
+    EXPECT_EQ(selector.select(errors, 70.0f), 1u);
+    // back up to 1.1 px: still inside the dead band, keep LOD 1
+    EXPECT_EQ(selector.select(errors, 110.0f), 1u);
+    EXPECT_EQ(selector.select(errors, 130.0f), 0u);
+}
+
+TEST(LodSelectorTest, PixelsPerUnit)
+{
+    // 90 degree vertical fov: one unit at distance 1 covers half the viewport
+    const mgl::math::mat4 perspective = mgl::math::perspective(1.5707964f, 1.0f, 0.1f, 100.0f);
+    EXPECT_NEAR(mgl::LodSelector::pixelsPerUnit(perspective, 800.0f, 1.0f), 400.0f, 1e-2f);
+    EXPECT_NEAR(mgl::LodSelector::pixelsPerUnit(perspective, 800.0f, 4.0f), 100.0f, 1e-2f);
+
+    // orthographic with a vertical extent of 4 units
+    mgl::math::mat4 ortho = mgl::math::mat4::identity();
+    ortho(0, 0) = ortho(1, 1) = 0.5f;
+    EXPECT_NEAR(mgl::LodSelector::pixelsPerUnit(ortho, 800.0f, 1.0f), 200.0f, 1e-2f);
+    EXPECT_NEAR(mgl::LodSelector::pixelsPerUnit(ortho, 800.0f, 50.0f), 200.0f, 1e-2f);
+}
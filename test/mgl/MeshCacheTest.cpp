@@ -0,0 +1,155 @@
+#include <mgl/models/meshes/mglMeshCache.hpp>
+#include <gtest/gtest.h>
+#include "../test_temp_dir.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+    mgl::MeshData makeQuad() {
+        mgl::MeshData data;
+        data.positions = {
+            mgl::math::vec3(0.0f, 0.0f, 0.0f), mgl::math::vec3(1.0f, 0.0f, 0.0f),
+            mgl::math::vec3(1.0f, 1.0f, 0.0f), mgl::math::vec3(0.0f, 1.0f, 0.0f),
+        };
+        data.normals.assign(4, mgl::math::vec3(0.0f, 0.0f, 1.0f));
+        data.texcoords = {
+            mgl::math::vec2(0.0f, 0.0f), mgl::math::vec2(1.0f, 0.0f),
+            mgl::math::vec2(1.0f, 1.0f), mgl::math::vec2(0.0f, 1.0f),
+        };
+        data.indices = { 0, 1, 2, 0, 2, 1 };
+        data.submeshes = { { 3, 0, 0 }, { 3, 3, 1 } };
+        return data;
+    }
+
+    mgl::MeshView viewOf(const mgl::MeshData& data) {
+        return { data.positions, data.indices, data.normals, data.texcoords, data.colors, data.submeshes,
+                 {}, {}, {} };
+    }
+
+    class MeshCacheTest : public mgl::test::TempDirTest {
+    protected:
+        void SetUp() override {
+            TempDirTest::SetUp();
+            mgl::MeshCache::setDirectory(dir);
+        }
+    };
+
+} // namespace
+
+TEST_F(MeshCacheTest, RoundTrip)
+{
+    const mgl::MeshData quad = makeQuad();
+    ASSERT_TRUE(mgl::MeshCache::store(42, viewOf(quad)));
+
+    auto entry = mgl::MeshCache::open(42);
+    ASSERT_TRUE(entry.has_value());
+    const mgl::MeshView& view = entry->view;
+
+    ASSERT_EQ(view.positions.size(), quad.positions.size());
+    ASSERT_EQ(view.indices.size(), quad.indices.size());
+    ASSERT_EQ(view.normals.size(), quad.normals.size());
+    ASSERT_EQ(view.texcoords.size(), quad.texcoords.size());
+    ASSERT_TRUE(view.colors.empty());
+    ASSERT_EQ(view.submeshes.size(), 2u);
+
+    for (size_t i = 0; i < quad.positions.size(); i++) {
+        EXPECT_TRUE(view.positions[i] == quad.positions[i]);
+        EXPECT_TRUE(view.texcoords[i] == quad.texcoords[i]);
+    }
+    for (size_t i = 0; i < quad.indices.size(); i++) {
+        EXPECT_EQ(view.indices[i], quad.indices[i]);
+    }
+    EXPECT_EQ(view.submeshes[1].baseIndex, 3u);
+    EXPECT_EQ(view.submeshes[1].baseVertex, 1u);
+}
+
+TEST_F(MeshCacheTest, LodAndMeshletSectionsRoundTrip)
+{
+    mgl::MeshData quad = makeQuad();
+    quad.indices.insert(quad.indices.end(), { 0, 1, 2 });
+    const std::vector<mgl::Submesh> lods = { { 3, 6, 0 }, { 0, 9, 1 } };
+    const std::vector<float> errors = { 0.25f };
+    mgl::Meshlet meshlet;
+    meshlet.n_indices = 3;
+    meshlet.baseIndex = 3;
+    meshlet.submesh = 1;
+    meshlet.radius = 0.75f;
+    const std::vector<mgl::Meshlet> meshlets = { mgl::Meshlet(), meshlet };
+    mgl::MeshView view = viewOf(quad);
+    view.lodSubmeshes = lods;
+    view.lodErrors = errors;
+    view.meshlets = meshlets;
+    ASSERT_TRUE(mgl::MeshCache::store(43, view));
+
+    auto entry = mgl::MeshCache::open(43);
+    ASSERT_TRUE(entry.has_value());
+    ASSERT_EQ(entry->view.lodSubmeshes.size(), 2u);
+    ASSERT_EQ(entry->view.lodErrors.size(), 1u);
+    EXPECT_EQ(entry->view.lodSubmeshes[0].baseIndex, 6u);
+    EXPECT_EQ(entry->view.lodSubmeshes[1].baseVertex, 1u);
+    EXPECT_FLOAT_EQ(entry->view.lodErrors[0], 0.25f);
+    ASSERT_EQ(entry->view.meshlets.size(), 2u);
+    EXPECT_EQ(entry->view.meshlets[1].submesh, 1u);
+    EXPECT_FLOAT_EQ(entry->view.meshlets[1].radius, 0.75f);
+}
+
+TEST_F(MeshCacheTest, MissingEntry)
+{
+    EXPECT_FALSE(mgl::MeshCache::open(7).has_value());
+}
+
+TEST_F(MeshCacheTest, RejectsCorruptedEntry)
+{
+    const mgl::MeshData quad = makeQuad();
+    ASSERT_TRUE(mgl::MeshCache::store(42, viewOf(quad)));
+
+    // truncate the entry so its sections point past the end of the file
+    const auto path = mgl::MeshCache::entryPath(42);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+    EXPECT_FALSE(mgl::MeshCache::open(42).has_value());
+}
+
+TEST_F(MeshCacheTest, RejectsOutOfRangeSubmeshes)
+{
+    // an index past the vertices of its submesh
+    mgl::MeshData quad = makeQuad();
+    quad.indices[5] = 3;
+    ASSERT_TRUE(mgl::MeshCache::store(44, viewOf(quad)));
+    EXPECT_FALSE(mgl::MeshCache::open(44).has_value());
+
+    // a LOD range past the indices
+    quad = makeQuad();
+    const std::vector<mgl::Submesh> lods = { { 3, 0, 0 }, { 3, 6, 1 } };
+    const std::vector<float> errors = { 0.25f };
+    mgl::MeshView view = viewOf(quad);
+    view.lodSubmeshes = lods;
+    view.lodErrors = errors;
+    ASSERT_TRUE(mgl::MeshCache::store(45, view));
+    EXPECT_FALSE(mgl::MeshCache::open(45).has_value());
+
+    // a meshlet outside its submesh
+    mgl::Meshlet meshlet;
+    meshlet.n_indices = 3;
+    meshlet.baseIndex = 3;
+    const std::vector<mgl::Meshlet> meshlets = { meshlet };
+    view = viewOf(quad);
+    view.meshlets = meshlets;
+    ASSERT_TRUE(mgl::MeshCache::store(46, view));
+    EXPECT_FALSE(mgl::MeshCache::open(46).has_value());
+}
+
+TEST_F(MeshCacheTest, KeyDependsOnContentAndFlags)
+{
+    const std::string a = "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n";
+    std::string b = a;
+    b[2] = '1';
+
+    const auto keyA = mgl::MeshCache::makeKey(std::as_bytes(std::span(a)), 0);
+    EXPECT_EQ(keyA, mgl::MeshCache::makeKey(std::as_bytes(std::span(a)), 0));
+    EXPECT_NE(keyA, mgl::MeshCache::makeKey(std::as_bytes(std::span(b)), 0));
+    EXPECT_NE(keyA, mgl::MeshCache::makeKey(std::as_bytes(std::span(a)), 1));
+}
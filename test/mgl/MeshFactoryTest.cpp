@@ -0,0 +1,117 @@
+#include <mgl/models/meshes/mglMeshFactory.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+    using mgl::MeshData;
+    using mgl::MeshFactory;
+
+    // indices in range, unit normals and front faces agreeing with the vertex normals
+    void expectWellFormed(const MeshData& data) {
+        ASSERT_EQ(data.positions.size(), data.normals.size());
+        ASSERT_EQ(data.positions.size(), data.texcoords.size());
+        ASSERT_EQ(data.indices.size() % 3, 0u);
+        for (const mgl::math::vec3& normal : data.normals) {
+            EXPECT_NEAR(normal.length(), 1.0f, 1e-5f);
+        }
+        for (size_t i = 0; i < data.indices.size(); i += 3) {
+            const mgl::ui32 a = data.indices[i], b = data.indices[i + 1], c = data.indices[i + 2];
+            ASSERT_LT(std::max({ a, b, c }), data.positions.size());
+            const mgl::math::vec3 face = cross(data.positions[b] - data.positions[a], data.positions[c] - data.positions[a]);
+            EXPECT_GT(face.length(), 0.0f) << "degenerate triangle " << i / 3;
+            EXPECT_GT(dot(face, data.normals[a] + data.normals[b] + data.normals[c]), 0.0f) << "triangle " << i / 3;
+        }
+    }
+
+    // closed convex shapes centered on the origin face away from it
+    void expectOutward(const MeshData& data) {
+        for (size_t i = 0; i < data.indices.size(); i += 3) {
+            const mgl::math::vec3& a = data.positions[data.indices[i]];
+            const mgl::math::vec3& b = data.positions[data.indices[i + 1]];
+            const mgl::math::vec3& c = data.positions[data.indices[i + 2]];
+            EXPECT_GT(dot(cross(b - a, c - a), a + b + c), 0.0f) << "triangle " << i / 3;
+        }
+    }
+
+}
+
+TEST(MeshFactoryTest, BuildsWellFormedPrimitives)
+{
+    const MeshData& cube = MeshFactory::cube(2.0f);
+    EXPECT_EQ(cube.positions.size(), 24u);
+    EXPECT_EQ(cube.indices.size(), 36u);
+    for (const mgl::math::vec3& position : cube.positions) {
+        for (int axis = 0; axis < 3; axis++) EXPECT_FLOAT_EQ(std::abs(position[axis]), 1.0f);
+    }
+    expectWellFormed(cube);
+    expectOutward(cube);
+
+    // triangles collapsed on the poles are dropped
+    const MeshData& uvSphere = MeshFactory::uvSphere(1.5f, 16, 8);
+    EXPECT_EQ(uvSphere.positions.size(), 17u * 9u);
+    EXPECT_EQ(uvSphere.indices.size(), 3u * 2u * 16u * (8u - 1u));
+    for (const mgl::math::vec3& position : uvSphere.positions) EXPECT_NEAR(position.length(), 1.5f, 1e-5f);
+    expectWellFormed(uvSphere);
+    expectOutward(uvSphere);
+
+    // shared midpoints: V - E + F = 2
+    const MeshData& icoSphere = MeshFactory::icoSphere(1.0f, 2);
+    EXPECT_EQ(icoSphere.indices.size(), 3u * 20u * 16u);
+    EXPECT_EQ(icoSphere.positions.size(), 162u);
+    expectWellFormed(icoSphere);
+    expectOutward(icoSphere);
+
+    const MeshData& cylinder = MeshFactory::cylinder(1.0f, 2.0f, 12, true);
+    EXPECT_EQ(cylinder.indices.size(), 3u * (2u * 12u + 2u * 12u));
+    expectWellFormed(cylinder);
+    expectOutward(cylinder);
+    EXPECT_EQ(MeshFactory::cylinder(1.0f, 2.0f, 12, false).indices.size(), 3u * 2u * 12u);
+
+    const MeshData& plane = MeshFactory::plane(4.0f, 2.0f, 4, 2);
+    EXPECT_EQ(plane.positions.size(), 5u * 3u);
+    EXPECT_EQ(plane.indices.size(), 3u * 2u * 8u);
+    expectWellFormed(plane);
+
+    const MeshData& torus = MeshFactory::torus(1.0f, 0.25f, 24, 8);
+    EXPECT_EQ(torus.indices.size(), 3u * 2u * 24u * 8u);
+    for (size_t v = 0; v < torus.positions.size(); v++) {
+        // every vertex lies on the tube, along its normal from the center circle
+        const mgl::math::vec3 center = torus.positions[v] - torus.normals[v] * 0.25f;
+        EXPECT_NEAR(center[1], 0.0f, 1e-5f);
+        EXPECT_NEAR(std::hypot(center[0], center[2]), 1.0f, 1e-5f);
+    }
+    expectWellFormed(torus);
+
+    const MeshData& triangle = MeshFactory::fullscreenTriangle();
+    EXPECT_EQ(triangle.indices.size(), 3u);
+    expectWellFormed(triangle);
+}
+
+TEST(MeshFactoryTest, CachesByParameters)
+{
+    const MeshData& first = MeshFactory::uvSphere(1.0f, 20, 10);
+    const size_t count = MeshFactory::cachedCount();
+    EXPECT_EQ(&MeshFactory::uvSphere(1.0f, 20, 10), &first);
+    EXPECT_EQ(MeshFactory::cachedCount(), count);
+
+    EXPECT_NE(&MeshFactory::uvSphere(1.0f, 20, 12), &first);
+    EXPECT_NE(&MeshFactory::uvSphere(2.0f, 20, 10), &first);
+    EXPECT_NE(&MeshFactory::icoSphere(1.0f, 0), &first);
+    EXPECT_EQ(MeshFactory::cachedCount(), count + 3);
+}
+
+TEST(MeshFactoryTest, RejectsInvalidParameters)
+{
+    EXPECT_THROW(MeshFactory::cube(0.0f), std::invalid_argument);
+    EXPECT_THROW(MeshFactory::cube(NAN), std::invalid_argument);
+    EXPECT_THROW(MeshFactory::uvSphere(1.0f, 2, 8), std::invalid_argument);
+    EXPECT_THROW(MeshFactory::uvSphere(1.0f, 8, 1), std::invalid_argument);
+    EXPECT_THROW(MeshFactory::icoSphere(1.0f, 9), std::invalid_argument);
+    EXPECT_THROW(MeshFactory::plane(1.0f, 1.0f, 0, 1), std::invalid_argument);
+    EXPECT_THROW(MeshFactory::cylinder(-1.0f), std::invalid_argument);
+    EXPECT_THROW(MeshFactory::torus(1.0f, 0.25f, 8, 2), std::invalid_argument);
+}
@@ -0,0 +1,104 @@
+#include <mgl/models/meshes/mglMeshOptimizer.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+namespace {
+
+    struct Grid {
+        std::vector<mgl::math::vec3> positions;
+        std::vector<mgl::ui32> indices;
+    };
+
+    // n x n quads, with the triangle order shuffled
+    Grid makeShuffledGrid(mgl::ui32 n) {
+        Grid grid;
+        for (mgl::ui32 y = 0; y <= n; y++)
+            for (mgl::ui32 x = 0; x <= n; x++)
+                grid.positions.emplace_back(float(x), float(y), 0.0f);
+
+        std::vector<std::array<mgl::ui32, 3>> triangles;
+        for (mgl::ui32 y = 0; y < n; y++) {
+            for (mgl::ui32 x = 0; x < n; x++) {
+                const mgl::ui32 v = y * (n + 1) + x;
+                triangles.push_back({ v, v + 1, v + n + 2 });
+                triangles.push_back({ v, v + n + 2, v + n + 1 });
+            }
+        }
+        std::mt19937 rng(7);
+        std::shuffle(triangles.begin(), triangles.end(), rng);
+        for (const auto& t : triangles) grid.indices.insert(grid.indices.end(), t.begin(), t.end());
+        return grid;
+    }
+
+    // Triangles as rotation-independent sorted tuples of their positions
+    std::vector<std::array<float, 9>> triangleSet(const std::vector<mgl::ui32>& indices,
+                                                  const std::vector<mgl::math::vec3>& positions) {
+        std::vector<std::array<float, 9>> set;
+        for (size_t t = 0; t < indices.size(); t += 3) {
+            std::array<std::array<float, 3>, 3> corners;
+            for (int k = 0; k < 3; k++) {
+                const mgl::math::vec3& p = positions[indices[t + k]];
+                corners[k] = { p[0], p[1], p[2] };
+            }
+            // keep winding: rotate so the smallest corner comes first
+            std::rotate(corners.begin(), std::min_element(corners.begin(), corners.end()), corners.end());
+            std::array<float, 9> flat;
+            for (int k = 0; k < 9; k++) flat[k] = corners[k / 3][k % 3];
+            set.push_back(flat);
+        }
+        std::sort(set.begin(), set.end());
+        return set;
+    }
+
+} // namespace
+
+TEST(MeshOptimizerTest, VertexCacheLowersAcmr)
+{
+    Grid grid = makeShuffledGrid(32);
+    const auto before = triangleSet(grid.indices, grid.positions);
+    const float acmrBefore = mgl::MeshOptimizer::acmr(grid.indices, grid.positions.size());
+
+    mgl::MeshOptimizer::optimizeVertexCache(grid.indices, grid.positions.size());
+
+    const float acmrAfter = mgl::MeshOptimizer::acmr(grid.indices, grid.positions.size());
+    EXPECT_LT(acmrAfter, 1.0f);
+    EXPECT_LT(acmrAfter, acmrBefore * 0.5f);
+    EXPECT_EQ(triangleSet(grid.indices, grid.positions), before);
+}
+
+TEST(MeshOptimizerTest, OverdrawKeepsTrianglesWithinBudget)
+{
+    Grid grid = makeShuffledGrid(32);
+    mgl::MeshOptimizer::optimizeVertexCache(grid.indices, grid.positions.size());
+    const auto before = triangleSet(grid.indices, grid.positions);
+    const float acmrBefore = mgl::MeshOptimizer::acmr(grid.indices, grid.positions.size());
+
+    mgl::MeshOptimizer::optimizeOverdraw(grid.indices, grid.positions, 1.05f);
+
+    EXPECT_EQ(triangleSet(grid.indices, grid.positions), before);
+    // splitting only at cache restarts or within budget keeps ACMR close
+    EXPECT_LT(mgl::MeshOptimizer::acmr(grid.indices, grid.positions.size()), acmrBefore * 1.25f);
+}
+
+TEST(MeshOptimizerTest, VertexFetchFollowsIndexOrder)
+{
+    Grid grid = makeShuffledGrid(8);
+    grid.positions.emplace_back(100.0f, 100.0f, 100.0f); // unreferenced
+    const auto before = triangleSet(grid.indices, grid.positions);
+
+    const std::vector<mgl::ui32> remap = mgl::MeshOptimizer::optimizeVertexFetch(grid.indices, grid.positions.size());
+    mgl::MeshOptimizer::remapVertices(std::span(grid.positions), std::span<const mgl::ui32>(remap));
+
+    // every index is at most one past the largest seen so far
+    mgl::ui32 next = 0;
+    for (mgl::ui32 index : grid.indices) {
+        ASSERT_LE(index, next);
+        if (index == next) next++;
+    }
+    EXPECT_EQ(triangleSet(grid.indices, grid.positions), before);
+    EXPECT_TRUE(grid.positions.back() == mgl::math::vec3(100.0f, 100.0f, 100.0f));
+}
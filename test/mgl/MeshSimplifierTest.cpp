@@ -0,0 +1,80 @@
+#include <mgl/models/meshes/mglMeshSimplifier.hpp>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+    // height field: an n x n grid bent into a smooth bump, with the
+    // border rows and columns locked by the simplifier
+    void makeGrid(int n, float amplitude, std::vector<mgl::math::vec3>& positions, std::vector<mgl::ui32>& indices) {
+        for (int y = 0; y <= n; y++) {
+            for (int x = 0; x <= n; x++) {
+                const float u = float(x) / n, v = float(y) / n;
+                positions.emplace_back(u, v, amplitude * std::sin(3.14159f * u) * std::sin(3.14159f * v));
+            }
+        }
+        for (int y = 0; y < n; y++) {
+            for (int x = 0; x < n; x++) {
+                const mgl::ui32 i = y * (n + 1) + x;
+                indices.insert(indices.end(), { i, i + 1, i + n + 2, i, i + n + 2, i + n + 1 });
+            }
+        }
+    }
+
+} // namespace
+
+TEST(MeshSimplifierTest, FlatGridReachesTargetWithoutError)
+{
+    std::vector<mgl::math::vec3> positions;
+    std::vector<mgl::ui32> indices;
+    makeGrid(16, 0.0f, positions, indices);
+
+    float error = -1.0f;
+    const std::vector<mgl::ui32> simplified =
+        mgl::MeshSimplifier::simplify(indices, positions, {}, {}, indices.size() / 4, &error);
+
+    EXPECT_EQ(simplified.size() % 3, 0u);
+    EXPECT_LE(simplified.size(), indices.size() / 4 + 6);
+    EXPECT_NEAR(error, 0.0f, 1e-5f);
+    for (mgl::ui32 index : simplified) {
+        ASSERT_LT(index, positions.size());
+    }
+}
+
+TEST(MeshSimplifierTest, CurvedGridErrorGrowsWithReduction)
+{
+    std::vector<mgl::math::vec3> positions;
+    std::vector<mgl::ui32> indices;
+    makeGrid(24, 0.3f, positions, indices);
+
+    float mild = 0.0f, strong = 0.0f;
+    const auto half = mgl::MeshSimplifier::simplify(indices, positions, {}, {}, indices.size() / 2, &mild);
+    const auto tenth = mgl::MeshSimplifier::simplify(indices, positions, {}, {}, indices.size() / 10, &strong);
+
+    EXPECT_LT(tenth.size(), half.size());
+    EXPECT_GT(mild, 0.0f);
+    EXPECT_LE(mild, strong);
+    EXPECT_LT(strong, 0.3f);
+}
+
+TEST(MeshSimplifierTest, BorderAndSeamVerticesAreKept)
+{
+    std::vector<mgl::math::vec3> positions;
+    std::vector<mgl::ui32> indices;
+    makeGrid(8, 0.0f, positions, indices);
+
+    const auto simplified = mgl::MeshSimplifier::simplify(indices, positions, {}, {}, 0);
+    std::vector<bool> used(positions.size(), false);
+    for (mgl::ui32 index : simplified) used[index] = true;
+
+    // every border vertex of the grid must survive
+    for (size_t v = 0; v < positions.size(); v++) {
+        const mgl::math::vec3& p = positions[v];
+        const bool border = p[0] == 0.0f || p[0] == 1.0f || p[1] == 0.0f || p[1] == 1.0f;
+        if (border) {
+            EXPECT_TRUE(used[v]) << v;
+        }
+    }
+}
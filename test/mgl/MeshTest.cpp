@@ -0,0 +1,93 @@
+#include <mgl/models/meshes/mglMesh.hpp>
+#include <mgl/models/meshes/mglMeshFactory.hpp>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+    using mgl::MeshData;
+    using mgl::Submesh;
+
+    // a grid split in two submeshes indexing the same vertices, both from baseVertex 0
+    MeshData sharedVertexSubmeshes() {
+        MeshData data = mgl::MeshFactory::plane(2.0f, 2.0f, 16, 16);
+        const unsigned int half = static_cast<unsigned int>(data.indices.size() / 6 * 3);
+        data.submeshes = {
+            { half, 0, 0 },
+            { static_cast<unsigned int>(data.indices.size()) - half, half, 0 },
+        };
+        return data;
+    }
+
+    // every range of 'submeshes' indexes vertices that exist
+    void expectInRange(const mgl::MeshView& view, std::span<const Submesh> submeshes) {
+        for (const Submesh& submesh : submeshes) {
+            ASSERT_LE(size_t(submesh.baseIndex) + submesh.n_indices, view.indices.size());
+            for (unsigned int i = 0; i < submesh.n_indices; i++) {
+                EXPECT_LT(size_t(submesh.baseVertex) + view.indices[submesh.baseIndex + i], view.positions.size());
+            }
+        }
+    }
+
+}
+
+TEST(MeshTest, BuildsLodsOfSubmeshesSharingVertices)
+{
+    mgl::Mesh mesh;
+    mesh.generateLods(2, 0.5f);
+    mesh.loadData(sharedVertexSubmeshes());
+
+    const mgl::MeshView view = mesh.view();
+    ASSERT_FALSE(view.lodErrors.empty());
+    ASSERT_EQ(view.lodSubmeshes.size(), 2 * view.lodErrors.size());
+    expectInRange(view, view.lodSubmeshes);
+    for (size_t s = 0; s < 2; s++) {
+        EXPECT_GT(view.lodSubmeshes[s].n_indices, 0u);
+        EXPECT_LT(view.lodSubmeshes[s].n_indices, view.submeshes[s].n_indices);
+    }
+}
+
+TEST(MeshTest, BuildsMeshletsOfSubmeshesSharingVertices)
+{
+    mgl::Mesh mesh;
+    mesh.buildMeshlets(64, 124);
+    mesh.loadData(sharedVertexSubmeshes());
+
+    const mgl::MeshView view = mesh.view();
+    ASSERT_FALSE(view.meshlets.empty());
+    size_t indices[2] = {};
+    for (const mgl::Meshlet& meshlet : view.meshlets) {
+        ASSERT_LT(meshlet.submesh, 2u);
+        const Submesh& submesh = view.submeshes[meshlet.submesh];
+        EXPECT_GE(meshlet.baseIndex, submesh.baseIndex);
+        EXPECT_LE(meshlet.baseIndex + meshlet.n_indices, submesh.baseIndex + submesh.n_indices);
+        indices[meshlet.submesh] += meshlet.n_indices;
+    }
+    EXPECT_EQ(indices[0], view.submeshes[0].n_indices);
+    EXPECT_EQ(indices[1], view.submeshes[1].n_indices);
+    expectInRange(view, view.submeshes);
+}
+
+TEST(MeshTest, ContentKeyFollowsDataAndOptions)
+{
+    const MeshData data = mgl::MeshFactory::plane(2.0f, 2.0f, 4, 4);
+    mgl::Mesh mesh, same;
+    EXPECT_EQ(mesh.contentKey(data), same.contentKey(data));
+
+    // draw state is not part of the content
+    same.setDrawLod(1);
+    EXPECT_EQ(mesh.contentKey(data), same.contentKey(data));
+
+    MeshData moved = data;
+    moved.positions[0][1] += 1.0f;
+    EXPECT_NE(mesh.contentKey(data), mesh.contentKey(moved));
+
+    mgl::Mesh withLods, withMeshlets, quantized;
+    withLods.generateLods();
+    withMeshlets.buildMeshlets();
+    quantized.quantizeAttributes();
+    EXPECT_NE(withLods.contentKey(data), mesh.contentKey(data));
+    EXPECT_NE(withMeshlets.contentKey(data), mesh.contentKey(data));
+    EXPECT_NE(quantized.contentKey(data), mesh.contentKey(data));
+}
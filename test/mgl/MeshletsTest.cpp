@@ -0,0 +1,98 @@
+#include <mgl/models/meshes/mglMeshlets.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <set>
+#include <vector>
+
+namespace {
+
+    // flat n x n grid in the z = 0 plane, facing +z
+    void makeGrid(int n, std::vector<mgl::math::vec3>& positions, std::vector<mgl::ui32>& indices) {
+        for (int y = 0; y <= n; y++) {
+            for (int x = 0; x <= n; x++) {
+                positions.emplace_back(float(x), float(y), 0.0f);
+            }
+        }
+        for (int y = 0; y < n; y++) {
+            for (int x = 0; x < n; x++) {
+                const mgl::ui32 i = y * (n + 1) + x;
+                indices.insert(indices.end(), { i, i + 1, i + n + 2, i, i + n + 2, i + n + 1 });
+            }
+        }
+    }
+
+    std::multiset<std::array<mgl::ui32, 3>> triangles(const std::vector<mgl::ui32>& indices) {
+        std::multiset<std::array<mgl::ui32, 3>> result;
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            // rotate so the smallest index comes first, keeping the winding
+            std::array<mgl::ui32, 3> t = { indices[i], indices[i + 1], indices[i + 2] };
+            std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+            result.insert(t);
+        }
+        return result;
+    }
+
+} // namespace
+
+TEST(MeshletsTest, ClustersRespectLimitsAndKeepTriangles)
+{
+    std::vector<mgl::math::vec3> positions;
+    std::vector<mgl::ui32> indices;
+    makeGrid(32, positions, indices);
+    std::vector<mgl::ui32> clustered = indices;
+
+    const auto meshlets = mgl::Meshlets::build(clustered, positions);
+    EXPECT_EQ(triangles(clustered), triangles(indices));
+
+    size_t next = 0;
+    for (const mgl::Meshlet& meshlet : meshlets) {
+        EXPECT_EQ(meshlet.baseIndex, next);
+        next += meshlet.n_indices;
+        EXPECT_LE(meshlet.n_indices / 3, mgl::Meshlets::MAX_TRIANGLES);
+        const std::set<mgl::ui32> vertices(clustered.begin() + meshlet.baseIndex,
+                                           clustered.begin() + meshlet.baseIndex + meshlet.n_indices);
+        EXPECT_LE(vertices.size(), mgl::Meshlets::MAX_VERTICES);
+        for (mgl::ui32 v : vertices) {
+            EXPECT_LE((positions[v] - meshlet.center).length(), meshlet.radius + 1e-4f);
+        }
+        // flat grid: tight cone around +z
+        EXPECT_NEAR(meshlet.coneAxis[2], 1.0f, 1e-4f);
+        EXPECT_NEAR(meshlet.coneCutoff, 0.0f, 1e-3f);
+    }
+    EXPECT_EQ(next, clustered.size());
+    // 2048 triangles: greedy growth should stay close to the vertex limit
+    EXPECT_LE(meshlets.size(), 40u);
+}
+
+TEST(MeshletsTest, CullsBackFacingAndOutsideClusters)
+{
+    mgl::Meshlet meshlet;
+    meshlet.center = mgl::math::vec3(0.0f, 0.0f, 0.0f);
+    meshlet.radius = 1.0f;
+    meshlet.coneAxis = mgl::math::vec3(0.0f, 0.0f, 1.0f);
+    meshlet.coneCutoff = 0.1f;
+
+    // looking down -z from z = 10, 90 degree fov
+    const mgl::math::mat4 viewProjection =
+        mgl::math::perspective(1.5707964f, 1.0f, 0.1f, 100.0f) *
+        mgl::math::lookAt(mgl::math::vec3(0.0f, 0.0f, 10.0f), mgl::math::vec3(0.0f, 0.0f, 0.0f),
+                          mgl::math::vec3(0.0f, 1.0f, 0.0f));
+    const auto planes = mgl::Meshlets::frustumPlanes(viewProjection);
+    const mgl::math::vec3 front(0.0f, 0.0f, 10.0f);
+    EXPECT_TRUE(mgl::Meshlets::isVisible(meshlet, planes, front));
+    EXPECT_FALSE(mgl::Meshlets::isVisible(meshlet, planes, front, GL_FRONT));
+    EXPECT_TRUE(mgl::Meshlets::isVisible(meshlet, planes, front, GL_NONE));
+
+    // same view from behind the cluster
+    const auto behindPlanes = mgl::Meshlets::frustumPlanes(
+        mgl::math::perspective(1.5707964f, 1.0f, 0.1f, 100.0f) *
+        mgl::math::lookAt(mgl::math::vec3(0.0f, 0.0f, -10.0f), mgl::math::vec3(0.0f, 0.0f, 0.0f),
+                          mgl::math::vec3(0.0f, 1.0f, 0.0f)));
+    EXPECT_FALSE(mgl::Meshlets::isVisible(meshlet, behindPlanes, mgl::math::vec3(0.0f, 0.0f, -10.0f)));
+
+    // off to the side of the frustum
+    meshlet.center = mgl::math::vec3(50.0f, 0.0f, 0.0f);
+    EXPECT_FALSE(mgl::Meshlets::isVisible(meshlet, planes, front, GL_NONE));
+}
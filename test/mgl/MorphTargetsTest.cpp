@@ -0,0 +1,84 @@
+#include <mgl/models/skeletal/mglAnimationClip.hpp>
+#include <mgl/models/skeletal/mglMorphTargets.hpp>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+    std::vector<mgl::math::vec3> line(size_t count) {
+        std::vector<mgl::math::vec3> positions;
+        for (size_t v = 0; v < count; v++) positions.emplace_back(float(v), 0.0f, 0.0f);
+        return positions;
+    }
+
+}
+
+TEST(MorphTargetsTest, FromDenseKeepsOnlyMovedVertices)
+{
+    const std::vector<mgl::math::vec3> base = line(100);
+    std::vector<mgl::math::vec3> moved = base;
+    moved[3][1] = 1.0f;
+    moved[42][2] = -2.0f;
+
+    const mgl::MorphTarget target = mgl::MorphTarget::fromDense("smile", base, moved);
+    ASSERT_EQ(target.vertices.size(), 2u);
+    EXPECT_EQ(target.vertices[0], 3u);
+    EXPECT_EQ(target.vertices[1], 42u);
+    EXPECT_FLOAT_EQ(target.positions[1][2], -2.0f);
+    EXPECT_TRUE(target.normals.empty());
+
+    mgl::MorphTargets targets(base.size());
+    targets.addTarget(target);
+    // sparse: far less than a dense copy of the positions
+    EXPECT_LT(targets.getMemoryUsage(), base.size() * sizeof(mgl::math::vec3) / 4);
+    EXPECT_EQ(targets.find("smile"), 0);
+}
+
+TEST(MorphTargetsTest, ApplyBlendsWeightedDeltas)
+{
+    const std::vector<mgl::math::vec3> base = line(8);
+    const std::vector<mgl::math::vec3> normals(8, mgl::math::vec3(0.0f, 0.0f, 1.0f));
+
+    mgl::MorphTargets targets(base.size());
+    targets.addTarget({ "up", { 1, 2 }, { mgl::math::vec3(0, 2, 0), mgl::math::vec3(0, 4, 0) }, {} });
+    targets.addTarget({ "tilt", { 2, 7 }, { mgl::math::vec3(1, 0, 0), mgl::math::vec3(0, 0, 3) },
+                        { mgl::math::vec3(1, 0, -1), mgl::math::vec3(0, 0, 0) } });
+    EXPECT_TRUE(targets.hasNormals());
+
+    std::vector<mgl::math::vec3> positions(8), outNormals(8);
+    const std::vector<float> weights = { 0.5f, 1.0f };
+    targets.apply(weights, base, normals, positions, outNormals);
+
+    EXPECT_FLOAT_EQ(positions[0][0], 0.0f);
+    EXPECT_FLOAT_EQ(positions[1][1], 1.0f);
+    EXPECT_FLOAT_EQ(positions[2][0], 3.0f);
+    EXPECT_FLOAT_EQ(positions[2][1], 2.0f);
+    EXPECT_FLOAT_EQ(positions[7][2], 3.0f);
+    // (0,0,1) + (1,0,-1) renormalized
+    EXPECT_NEAR(outNormals[2][0], 1.0f, 1e-6f);
+    EXPECT_NEAR(outNormals[1][2], 1.0f, 1e-6f);
+
+    EXPECT_THROW(targets.addTarget({ "bad", { 8 }, { mgl::math::vec3(1, 0, 0) }, {} }), std::out_of_range);
+    EXPECT_THROW(targets.apply(std::vector<float>{ 1.0f }, base, normals, positions, outNormals),
+                 std::invalid_argument);
+}
+
+TEST(MorphTargetsTest, AnimatorSamplesMorphWeights)
+{
+    mgl::AnimationClip clip;
+    clip.duration = 1.0f;
+    clip.morphChannels.push_back({ 1, { { 0.0f, 0.0f }, { 1.0f, 1.0f } } });
+
+    const mgl::Skeleton skeleton;
+    mgl::Animator animator(skeleton);
+    const std::vector<float> rest = { 0.25f, 0.0f };
+    animator.setMorphWeights(rest);
+    animator.play(&clip, false);
+    animator.update(0.5f);
+
+    ASSERT_EQ(animator.getMorphWeights().size(), 2u);
+    EXPECT_FLOAT_EQ(animator.getMorphWeights()[0], 0.25f);
+    EXPECT_FLOAT_EQ(animator.getMorphWeights()[1], 0.5f);
+    EXPECT_TRUE(animator.getPalette().empty());
+}
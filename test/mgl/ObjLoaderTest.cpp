@@ -0,0 +1,193 @@
+#include <mgl/models/meshes/mglObjLoader.hpp>
+#include <gtest/gtest.h>
+
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+
+    // position, normal and texcoord of every triangle corner, in draw order
+    using Corners = std::vector<std::vector<float>>;
+
+    Corners corners(const mgl::MeshData& mesh) {
+        Corners result;
+        for (const mgl::Submesh& submesh : mesh.submeshes) {
+            for (unsigned int i = 0; i < submesh.n_indices; i++) {
+                const size_t v = submesh.baseVertex + mesh.indices[submesh.baseIndex + i];
+                std::vector<float> corner;
+                for (int c = 0; c < 3; c++) corner.push_back(mesh.positions[v][c]);
+                for (int c = 0; c < 3; c++) corner.push_back(mesh.normals.empty() ? 0.0f : mesh.normals[v][c]);
+                for (int c = 0; c < 2; c++) corner.push_back(mesh.texcoords.empty() ? 0.0f : mesh.texcoords[v][c]);
+                result.push_back(corner);
+            }
+        }
+        return result;
+    }
+
+    Corners corners(const aiScene& scene) {
+        Corners result;
+        for (unsigned int m = 0; m < scene.mNumMeshes; m++) {
+            const aiMesh& mesh = *scene.mMeshes[m];
+            for (unsigned int f = 0; f < mesh.mNumFaces; f++) {
+                for (unsigned int k = 0; k < mesh.mFaces[f].mNumIndices; k++) {
+                    const unsigned int v = mesh.mFaces[f].mIndices[k];
+                    std::vector<float> corner;
+                    for (int c = 0; c < 3; c++) corner.push_back(mesh.mVertices[v][c]);
+                    for (int c = 0; c < 3; c++) corner.push_back(mesh.HasNormals() ? mesh.mNormals[v][c] : 0.0f);
+                    for (int c = 0; c < 2; c++) corner.push_back(mesh.HasTextureCoords(0) ? mesh.mTextureCoords[0][v][c] : 0.0f);
+                    result.push_back(corner);
+                }
+            }
+        }
+        return result;
+    }
+
+    std::filesystem::path model(const std::string& name) {
+        return std::filesystem::path(__FILE__).parent_path().parent_path().parent_path() /
+            "examples/lighting-showcase/resources/models" / name;
+    }
+
+    const char* QUADS =
+        "# two quads sharing an edge\n"
+        "v 0 0 0\n"
+        "v 1 0 0\n"
+        "v 1 1 0\n"
+        "v 0 1 0\n"
+        "v 2 0 0 1 0 0\n"
+        "v 2 1 0\n"
+        "vt 0 0\n"
+        "vt 1 1\n"
+        "vn 0 0 1\n"
+        "o left\n"
+        "usemtl red\n"
+        "f 1/1/1 2/1/1 3/2/1 4/2/1\n"
+        "o right\n"
+        "usemtl blue\n"
+        "f -5/1/-1 -2/1/-1 -1/2/-1 -4/2/-1\n";
+
+}
+
+TEST(ObjLoaderTest, TriangulatesAndWeldsFaces)
+{
+    const std::optional<mgl::ObjLoader::Model> model = mgl::ObjLoader::parse(QUADS);
+    ASSERT_TRUE(model.has_value());
+    const mgl::MeshData& mesh = model->mesh;
+
+    // one submesh per object, fans of two triangles, corners welded per submesh
+    ASSERT_EQ(mesh.submeshes.size(), 2u);
+    EXPECT_EQ(mesh.indices.size(), 12u);
+    EXPECT_EQ(mesh.positions.size(), 8u);
+    EXPECT_EQ(mesh.submeshes[1].baseVertex, 4u);
+    EXPECT_EQ(mesh.submeshes[1].baseIndex, 6u);
+    const std::vector<mgl::ui32> fan = { 0, 1, 2, 0, 2, 3 };
+    EXPECT_EQ(std::vector<mgl::ui32>(mesh.indices.begin(), mesh.indices.begin() + 6), fan);
+
+    // relative indices resolve against the vertices read so far
+    EXPECT_FLOAT_EQ(mesh.positions[4][0], 1.0f);
+    EXPECT_FLOAT_EQ(mesh.positions[5][0], 2.0f);
+    EXPECT_FLOAT_EQ(mesh.texcoords[6][1], 1.0f);
+    EXPECT_FLOAT_EQ(mesh.normals[7][2], 1.0f);
+
+    // vertex colors default to white where not given
+    ASSERT_EQ(mesh.colors.size(), 8u);
+    EXPECT_FLOAT_EQ(mesh.colors[5][1], 0.0f);
+    EXPECT_FLOAT_EQ(mesh.colors[4][1], 1.0f);
+
+    // no material library was given
+    EXPECT_EQ(model->submeshMaterials, std::vector<mgl::i32>({ -1, -1 }));
+}
+
+TEST(ObjLoaderTest, SmallChunksParseLikeOne)
+{
+    std::string text;
+    for (int y = 0; y <= 20; y++) {
+        for (int x = 0; x <= 20; x++) {
+            text += "v " + std::to_string(x) + " " + std::to_string(y) + " " + std::to_string(x * y * 0.01f) + "\n";
+            text += "vt " + std::to_string(x / 20.0f) + " " + std::to_string(y / 20.0f) + "\n";
+        }
+        if (y % 7 == 0) text += "g band" + std::to_string(y) + "\n";
+        if (y == 0) continue;
+        for (int x = 1; x <= 20; x++) {
+            const int a = (y - 1) * 21 + x, b = y * 21 + x;
+            text += "f " + std::to_string(a) + "/" + std::to_string(a) + " " + std::to_string(a + 1) + "/" +
+                std::to_string(a + 1) + " " + std::to_string(b + 1) + "/" + std::to_string(b + 1) + " " +
+                std::to_string(b) + "/" + std::to_string(b) + "\n";
+        }
+    }
+
+    mgl::ObjLoader::Options whole;
+    whole.chunkSize = text.size();
+    mgl::ObjLoader::Options chunked;
+    chunked.chunkSize = 16;
+    chunked.flipUVs = true;
+    const std::optional<mgl::ObjLoader::Model> one = mgl::ObjLoader::parse(text, whole);
+    const std::optional<mgl::ObjLoader::Model> many = mgl::ObjLoader::parse(text, chunked);
+    ASSERT_TRUE(one.has_value());
+    ASSERT_TRUE(many.has_value());
+
+    EXPECT_EQ(one->mesh.submeshes.size(), 3u);
+    EXPECT_EQ(many->mesh.indices, one->mesh.indices);
+    ASSERT_EQ(many->mesh.positions.size(), one->mesh.positions.size());
+    for (size_t v = 0; v < one->mesh.positions.size(); v++) {
+        for (int c = 0; c < 3; c++) EXPECT_EQ(many->mesh.positions[v][c], one->mesh.positions[v][c]);
+        EXPECT_FLOAT_EQ(many->mesh.texcoords[v][1], 1.0f - one->mesh.texcoords[v][1]);
+    }
+}
+
+TEST(ObjLoaderTest, RejectsMalformedInput)
+{
+    EXPECT_FALSE(mgl::ObjLoader::parse("v 0 0 0\nv 1 0 0\nf 1 2 3\n").has_value());
+    EXPECT_FALSE(mgl::ObjLoader::parse("v 0 0 zero\n").has_value());
+    EXPECT_FALSE(mgl::ObjLoader::parse("v 0 0 0\nf 1/x 1 1\n").has_value());
+}
+
+TEST(ObjLoaderTest, ParsesMaterials)
+{
+    const std::vector<mgl::ObjLoader::Material> materials = mgl::ObjLoader::parseMaterials(
+        "newmtl red\n"
+        "Kd 1 0 0\n"
+        "Ns 96.5\n"
+        "Tr 0.25\n"
+        "newmtl textured\n"
+        "Ka 0.1 0.1 0.1\n"
+        "d 0.5\n"
+        "map_Kd textures/wood.png\n");
+    ASSERT_EQ(materials.size(), 2u);
+    EXPECT_EQ(materials[0].name, "red");
+    EXPECT_FLOAT_EQ(materials[0].diffuse[1], 0.0f);
+    EXPECT_FLOAT_EQ(materials[0].shininess, 96.5f);
+    EXPECT_FLOAT_EQ(materials[0].opacity, 0.75f);
+    EXPECT_FLOAT_EQ(materials[1].ambient[2], 0.1f);
+    EXPECT_FLOAT_EQ(materials[1].opacity, 0.5f);
+    EXPECT_EQ(materials[1].diffuseMap, "textures/wood.png");
+}
+
+// The native loader must build the same triangles as the Assimp path it replaces
+TEST(ObjLoaderTest, MatchesAssimp)
+{
+    for (const char* name : { "cube-vtn.obj", "teapot-vn-smooth.obj", "torus-vtn-smooth.obj", "monkey-torus-vtn-flat.obj" }) {
+        SCOPED_TRACE(name);
+        const std::filesystem::path path = model(name);
+        if (!std::filesystem::exists(path)) GTEST_SKIP() << "example models not found";
+
+        const std::optional<mgl::ObjLoader::Model> native = mgl::ObjLoader::load(path);
+        ASSERT_TRUE(native.has_value());
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(path.string(), aiProcess_Triangulate);
+        ASSERT_NE(scene, nullptr);
+
+        const Corners expected = corners(*scene);
+        const Corners actual = corners(native->mesh);
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < expected.size(); i++) {
+            for (size_t c = 0; c < expected[i].size(); c++) {
+                ASSERT_NEAR(actual[i][c], expected[i][c], 1e-5f) << "corner " << i;
+            }
+        }
+    }
+}
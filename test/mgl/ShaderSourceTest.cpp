@@ -0,0 +1,82 @@
+#include <mgl/shaders/ShaderSource.hpp>
+#include <utils/file.hpp>
+#include <gtest/gtest.h>
+#include "../test_temp_dir.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+    class ShaderSourceTest : public mgl::test::TempDirTest {
+    protected:
+        std::filesystem::path resources;
+
+        void SetUp() override {
+            TempDirTest::SetUp();
+            resources = file::resource_dir();
+            file::set_resource_dir(dir / "resources");
+            mgl::ShaderSource::setCacheDirectory(dir / "cache");
+
+            write("shaders/main.glsl", "#version 330 core\n#include \"lib/light.glsl\"\n#include \"common.glsl\"\nvoid main() {}\n");
+            write("shaders/common.glsl", "const float PI = 3.14159;\n");
+            write("shaders/lib/light.glsl", "#include \"../common.glsl\"\nvec3 light() { return vec3(PI); }\n");
+        }
+
+        void TearDown() override {
+            file::set_resource_dir(resources);
+            TempDirTest::TearDown();
+        }
+
+        void write(const std::string& name, const std::string& code) {
+            const std::filesystem::path path = dir / "resources" / name;
+            std::filesystem::create_directories(path.parent_path());
+            std::ofstream(path) << code;
+        }
+    };
+
+    size_t occurrences(const std::string& text, const std::string& pattern) {
+        size_t count = 0;
+        for (size_t i = text.find(pattern); i != std::string::npos; i = text.find(pattern, i + 1)) count++;
+        return count;
+    }
+
+} // namespace
+
+TEST_F(ShaderSourceTest, ExpandsEveryIncludeOnce)
+{
+    const std::optional<mgl::ShaderSource> source = mgl::ShaderSource::preprocess("shaders/main.glsl");
+    ASSERT_TRUE(source.has_value());
+    EXPECT_EQ(source->dependencies,
+        std::vector<std::string>({ "shaders/main.glsl", "shaders/lib/light.glsl", "shaders/common.glsl" }));
+    EXPECT_EQ(occurrences(source->code, "const float PI"), 1u);
+    EXPECT_EQ(occurrences(source->code, "#include"), 0u);
+    EXPECT_EQ(source->code.rfind("#version 330 core\n", 0), 0u);
+    EXPECT_LT(source->code.find("const float PI"), source->code.find("vec3 light()"));
+}
+
+TEST_F(ShaderSourceTest, MissingIncludeFails)
+{
+    write("shaders/broken.glsl", "#include \"missing.glsl\"\n");
+    EXPECT_FALSE(mgl::ShaderSource::preprocess("shaders/broken.glsl").has_value());
+}
+
+TEST_F(ShaderSourceTest, CompiledSourceIsUsedUntilADependencyChanges)
+{
+    EXPECT_FALSE(mgl::ShaderSource::isCompiled("shaders/main.glsl"));
+    const std::optional<mgl::ShaderSource> source = mgl::ShaderSource::preprocess("shaders/main.glsl");
+    ASSERT_TRUE(source.has_value());
+    ASSERT_TRUE(source->store("shaders/main.glsl"));
+    EXPECT_TRUE(mgl::ShaderSource::isCompiled("shaders/main.glsl"));
+
+    // edits of the compiled copy show it is the one loaded
+    std::ofstream(dir / "cache" / "shaders/main.glsl") << "compiled";
+    EXPECT_EQ(mgl::ShaderSource::load("shaders/main.glsl")->code, "compiled");
+
+    const std::filesystem::path common = dir / "resources" / "shaders/common.glsl";
+    std::filesystem::last_write_time(common, std::filesystem::last_write_time(common) + std::chrono::hours(1));
+    EXPECT_FALSE(mgl::ShaderSource::isCompiled("shaders/main.glsl"));
+    EXPECT_NE(mgl::ShaderSource::load("shaders/main.glsl")->code, "compiled");
+}
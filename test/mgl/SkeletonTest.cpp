@@ -0,0 +1,101 @@
+#include <mgl/models/skeletal/mglAnimationClip.hpp>
+#include <mgl/models/skeletal/mglSkeleton.hpp>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+    mgl::math::mat4 translation(float x, float y, float z) {
+        mgl::math::mat4 m = mgl::math::mat4::identity();
+        m(0, 3) = x;
+        m(1, 3) = y;
+        m(2, 3) = z;
+        return m;
+    }
+
+    // root at the origin, child one unit up the y axis
+    mgl::Skeleton makeArm() {
+        mgl::Skeleton skeleton;
+        skeleton.addBone({ "root", -1, mgl::math::mat4::identity(), mgl::math::mat4::identity() });
+        skeleton.addBone({ "child", 0, translation(0, 1, 0), translation(0, -1, 0) });
+        return skeleton;
+    }
+
+}
+
+TEST(SkeletonTest, BindPosePaletteIsIdentity)
+{
+    const mgl::Skeleton skeleton = makeArm();
+    std::vector<mgl::math::mat4> local(2), global(2), palette(2);
+    skeleton.bindPose(local);
+    skeleton.computePalette(local, global, palette);
+
+    EXPECT_FLOAT_EQ(global[1](1, 3), 1.0f);
+    for (const mgl::math::mat4& m : palette) {
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+                EXPECT_NEAR(m(r, c), r == c ? 1.0f : 0.0f, 1e-6f);
+    }
+    EXPECT_EQ(skeleton.find("child"), 1);
+    EXPECT_EQ(skeleton.find("missing"), -1);
+    EXPECT_THROW(skeleton.computePalette(local, global, std::span<mgl::math::mat4>(palette.data(), 1)),
+                 std::invalid_argument);
+}
+
+TEST(SkeletonTest, SkinBuilderKeepsStrongestFourNormalized)
+{
+    mgl::SkinBuilder builder(2);
+    builder.addInfluence(0, 1, 0.1f);
+    builder.addInfluence(0, 2, 0.4f);
+    builder.addInfluence(0, 3, 0.2f);
+    builder.addInfluence(0, 4, 0.2f);
+    builder.addInfluence(0, 5, 0.3f); // drops bone 1
+    const std::vector<mgl::VertexSkin> skin = builder.build();
+
+    EXPECT_EQ(skin[0].bones[0], 2);
+    EXPECT_EQ(skin[0].bones[1], 5);
+    int sum = 0;
+    for (int i = 0; i < 4; i++) {
+        EXPECT_NE(skin[0].bones[i], 1);
+        sum += skin[0].weights[i];
+    }
+    EXPECT_EQ(sum, 255);
+
+    // no influences: bound to bone 0
+    EXPECT_EQ(skin[1].bones[0], 0);
+    EXPECT_EQ(skin[1].weights[0], 255);
+    EXPECT_THROW(builder.addInfluence(2, 0, 1.0f), std::out_of_range);
+}
+
+TEST(SkeletonTest, ClipInterpolatesKeysAndLoops)
+{
+    const mgl::Skeleton skeleton = makeArm();
+    mgl::AnimationClip clip;
+    clip.duration = 2.0f;
+    mgl::AnimationClip::Channel channel;
+    channel.bone = 1;
+    channel.translations = { { 0.0f, mgl::math::vec3(0, 1, 0) }, { 2.0f, mgl::math::vec3(0, 3, 0) } };
+    // a quarter turn around z over the clip
+    channel.rotations = { { 0.0f, mgl::math::quat::identity() },
+                          { 2.0f, mgl::math::quat::fromZ(1.5707964f) } };
+    clip.channels.push_back(channel);
+
+    std::vector<mgl::math::mat4> local(2);
+    skeleton.bindPose(local);
+    clip.sample(1.0f, local);
+    EXPECT_NEAR(local[1](1, 3), 2.0f, 1e-5f);
+    // 45 degrees: x axis maps to (cos, sin)
+    EXPECT_NEAR(local[1](0, 0), 0.70710677f, 1e-5f);
+    EXPECT_NEAR(local[1](1, 0), 0.70710677f, 1e-5f);
+
+    mgl::Animator animator(skeleton);
+    animator.play(&clip);
+    animator.update(2.5f); // loops back to 0.5 s
+    EXPECT_NEAR(animator.getTime(), 0.5f, 1e-6f);
+    // the joint is at the pivot of the rotation, so it only follows the translation
+    const mgl::math::mat4& child = animator.getPalette()[1];
+    const mgl::math::vec4 joint = child * mgl::math::vec4(0.0f, 1.0f, 0.0f, 1.0f);
+    EXPECT_NEAR(joint[0], 0.0f, 1e-5f);
+    EXPECT_NEAR(joint[1], 1.5f, 1e-5f);
+}
@@ -0,0 +1,84 @@
+#include <mgl/models/skeletal/mglSkinning.hpp>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace {
+
+    mgl::math::mat4 translation(float x, float y, float z) {
+        mgl::math::mat4 m = mgl::math::mat4::identity();
+        m(0, 3) = x;
+        m(1, 3) = y;
+        m(2, 3) = z;
+        return m;
+    }
+
+}
+
+TEST(SkinningTest, ScalarBlendsBoneMatrices)
+{
+    const std::vector<mgl::math::mat4> palette = { translation(2, 0, 0), translation(0, 4, 0) };
+    const std::vector<mgl::math::vec3> positions = { mgl::math::vec3(1, 1, 1), mgl::math::vec3(0, 0, 0) };
+    const std::vector<mgl::math::vec3> normals = { mgl::math::vec3(0, 0, 1), mgl::math::vec3(1, 0, 0) };
+    std::vector<mgl::VertexSkin> skin(2);
+    skin[0] = { { 0, 1, 0, 0 }, { 128, 127, 0, 0 } };
+    skin[1] = { { 7, 0, 0, 0 }, { 255, 0, 0, 0 } }; // out of range: clamped to bone 1
+
+    std::vector<mgl::math::vec3> outPositions(2), outNormals(2);
+    mgl::Skinning::skinScalar(positions, normals, skin, palette, outPositions, outNormals);
+
+    EXPECT_NEAR(outPositions[0][0], 1.0f + 2.0f * 128.0f / 255.0f, 1e-5f);
+    EXPECT_NEAR(outPositions[0][1], 1.0f + 4.0f * 127.0f / 255.0f, 1e-5f);
+    EXPECT_NEAR(outPositions[0][2], 1.0f, 1e-5f);
+    EXPECT_NEAR(outPositions[1][1], 4.0f, 1e-5f);
+    EXPECT_NEAR(outNormals[0][2], 1.0f, 1e-5f);
+    EXPECT_NEAR(outNormals[1][0], 1.0f, 1e-5f);
+
+    std::vector<mgl::math::vec3> tooFew(1);
+    EXPECT_THROW(mgl::Skinning::skinScalar(positions, {}, skin, palette, tooFew, {}), std::invalid_argument);
+}
+
+TEST(SkinningTest, DispatchMatchesScalar)
+{
+    std::vector<mgl::math::mat4> palette;
+    for (int b = 0; b < 8; b++) {
+        mgl::math::mat4 m = mgl::math::quat::fromY(0.3f * b).toMat4();
+        m(0, 3) = float(b);
+        m(2, 3) = -0.5f * b;
+        palette.push_back(m);
+    }
+    std::vector<mgl::math::vec3> positions, normals;
+    std::vector<mgl::VertexSkin> skin;
+    for (int v = 0; v < 37; v++) {
+        positions.emplace_back(0.1f * v, 1.0f - 0.05f * v, 0.2f * (v % 5));
+        normals.push_back(normalize(mgl::math::vec3(1.0f, 0.1f * v, 0.5f)));
+        skin.push_back({ { mgl::u8(v % 8), mgl::u8((v + 3) % 8), mgl::u8((v + 5) % 8), 0 }, { 150, 70, 35, 0 } });
+    }
+    skin[9].weights = { 0, 0, 0, 0 }; // zero matrix: a zero-length normal is kept as is
+
+    std::vector<mgl::math::vec3> scalarPositions(37), scalarNormals(37), positionsOut(37), normalsOut(37);
+    mgl::Skinning::skinScalar(positions, normals, skin, palette, scalarPositions, scalarNormals);
+    mgl::Skinning::skin(positions, normals, skin, palette, positionsOut, normalsOut);
+    for (size_t v = 0; v < positions.size(); v++) {
+        for (int i = 0; i < 3; i++) {
+            EXPECT_NEAR(positionsOut[v][i], scalarPositions[v][i], 1e-4f);
+            EXPECT_NEAR(normalsOut[v][i], scalarNormals[v][i], 1e-4f);
+        }
+    }
+
+    // positions only, over a partial batch
+    positions.resize(13);
+    skin.resize(13);
+    positionsOut.assign(13, mgl::math::vec3(-1.0f, -1.0f, -1.0f));
+    mgl::Skinning::skin(positions, {}, skin, palette, positionsOut, {});
+    for (size_t v = 0; v < positions.size(); v++) {
+        for (int i = 0; i < 3; i++) EXPECT_NEAR(positionsOut[v][i], scalarPositions[v][i], 1e-4f);
+    }
+}
+
+TEST(SkinningTest, SkinsNothingWithoutVertices)
+{
+    std::vector<mgl::math::vec3> none;
+    EXPECT_NO_THROW(mgl::Skinning::skin({}, {}, {}, {}, none, none));
+    EXPECT_NO_THROW(mgl::Skinning::skinScalar({}, {}, {}, {}, none, none));
+}
@@ -0,0 +1,55 @@
+#include <mgl/models/textures/mglTextureCache.hpp>
+#include <gtest/gtest.h>
+#include "../test_temp_dir.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+    class TextureCacheTest : public mgl::test::TempDirTest {
+    protected:
+        void SetUp() override {
+            TempDirTest::SetUp();
+            mgl::TextureCache::setDirectory(dir);
+        }
+    };
+
+} // namespace
+
+TEST_F(TextureCacheTest, RoundTrip)
+{
+    using mgl::TextureCompressor;
+    const std::vector<TextureCompressor::Image> mips =
+        TextureCompressor::mipChain({ 8, 4, 3, std::vector<mgl::u8>(8 * 4 * 3, 200) });
+    std::vector<std::vector<mgl::u8>> levels;
+    for (const TextureCompressor::Image& mip : mips) {
+        levels.push_back(TextureCompressor::compress(mip, TextureCompressor::Format::BC1));
+    }
+    ASSERT_TRUE(mgl::TextureCache::store(7, TextureCompressor::Format::BC1, 3, 8, 4, levels));
+
+    const auto entry = mgl::TextureCache::open(7);
+    ASSERT_TRUE(entry.has_value());
+    EXPECT_EQ(entry->format, TextureCompressor::Format::BC1);
+    EXPECT_EQ(entry->channels, 3u);
+    ASSERT_EQ(entry->levels.size(), 4u);
+    EXPECT_EQ(entry->levels[1].width, 4u);
+    EXPECT_EQ(entry->levels[3].height, 1u);
+    for (size_t l = 0; l < levels.size(); l++) {
+        EXPECT_EQ(std::vector<mgl::u8>(entry->levels[l].data.begin(), entry->levels[l].data.end()), levels[l]);
+    }
+    EXPECT_FALSE(mgl::TextureCache::open(8).has_value());
+}
+
+TEST_F(TextureCacheTest, RejectsTruncatedEntries)
+{
+    using mgl::TextureCompressor;
+    const std::vector<std::vector<mgl::u8>> levels = { std::vector<mgl::u8>(16 * 16 * 4, 1) };
+    ASSERT_TRUE(mgl::TextureCache::store(9, TextureCompressor::Format::RAW, 4, 16, 16, levels));
+
+    const std::filesystem::path path = mgl::TextureCache::entryPath(9);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_FALSE(mgl::TextureCache::open(9).has_value());
+}
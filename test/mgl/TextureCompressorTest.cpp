@@ -0,0 +1,87 @@
+#include <mgl/models/textures/mglTextureCompressor.hpp>
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+    using mgl::TextureCompressor;
+
+    // smooth gradients: a diagonal one of colors, and horizontal / vertical
+    // ones for the other channels
+    TextureCompressor::Image gradient(mgl::ui32 width, mgl::ui32 height, mgl::ui32 channels) {
+        TextureCompressor::Image image{ width, height, channels, {} };
+        for (mgl::ui32 y = 0; y < height; y++) {
+            for (mgl::ui32 x = 0; x < width; x++) {
+                const mgl::ui32 horizontal = x * 255 / width, vertical = y * 255 / height;
+                const mgl::ui32 diagonal = (horizontal + vertical) / 2;
+                const mgl::ui32 texel[4][4] = {
+                    { horizontal },
+                    { horizontal, vertical },
+                    { diagonal, 255 - diagonal, diagonal / 2 },
+                    { diagonal, 255 - diagonal, diagonal / 2, vertical },
+                };
+                for (mgl::ui32 c = 0; c < channels; c++) image.pixels.push_back(static_cast<mgl::u8>(texel[channels - 1][c]));
+            }
+        }
+        return image;
+    }
+
+    int maxError(const TextureCompressor::Image& a, const TextureCompressor::Image& b) {
+        int error = 0;
+        for (size_t i = 0; i < a.pixels.size(); i++) {
+            error = std::max(error, std::abs(int(a.pixels[i]) - int(b.pixels[i])));
+        }
+        return error;
+    }
+
+}
+
+TEST(TextureCompressorTest, MipChainHalvesDownToOneTexel)
+{
+    TextureCompressor::Image image{ 5, 2, 1, { 0, 10, 20, 30, 40, 50, 60, 70, 80, 90 } };
+    const std::vector<TextureCompressor::Image> mips = TextureCompressor::mipChain(image);
+    ASSERT_EQ(mips.size(), 3u);
+    EXPECT_EQ(mips[1].width, 2u);
+    EXPECT_EQ(mips[1].height, 1u);
+    EXPECT_EQ(mips[2].width, 1u);
+    EXPECT_EQ(mips[2].height, 1u);
+    // (0 + 10 + 50 + 60) / 4
+    EXPECT_EQ(mips[1].pixels[0], 30);
+    // the last column has no pair and is dropped
+    EXPECT_EQ(mips[1].pixels[1], 50);
+    EXPECT_EQ(mips[2].pixels[0], 40);
+}
+
+TEST(TextureCompressorTest, BlocksRoundTripWithinTolerance)
+{
+    for (mgl::ui32 channels = 1; channels <= 4; channels++) {
+        SCOPED_TRACE(channels);
+        // not a multiple of the block size
+        const TextureCompressor::Image image = gradient(22, 13, channels);
+        const TextureCompressor::Format format = TextureCompressor::formatFor(channels);
+        const std::vector<mgl::u8> blocks = TextureCompressor::compress(image, format);
+        EXPECT_EQ(blocks.size(), TextureCompressor::levelSize(format, 22, 13, channels));
+
+        const TextureCompressor::Image decoded = TextureCompressor::decompress(blocks, format, 22, 13);
+        ASSERT_EQ(decoded.channels, channels);
+        ASSERT_EQ(decoded.pixels.size(), image.pixels.size());
+        // 565 endpoints and 4 color palettes vs 8 value ones
+        EXPECT_LE(maxError(image, decoded), channels >= 3 ? 12 : 6);
+    }
+}
+
+TEST(TextureCompressorTest, FlatBlocksAreExact)
+{
+    TextureCompressor::Image image{ 4, 4, 4, {} };
+    for (int t = 0; t < 16; t++) image.pixels.insert(image.pixels.end(), { 255, 0, 255, 128 });
+    const std::vector<mgl::u8> blocks = TextureCompressor::compress(image, TextureCompressor::Format::BC3);
+    const TextureCompressor::Image decoded =
+        TextureCompressor::decompress(blocks, TextureCompressor::Format::BC3, 4, 4);
+    EXPECT_EQ(decoded.pixels, image.pixels);
+
+    image.channels = 1;
+    EXPECT_THROW(TextureCompressor::compress(image, TextureCompressor::Format::BC3), std::invalid_argument);
+    EXPECT_THROW(TextureCompressor::formatFor(5), std::invalid_argument);
+}
@@ -0,0 +1,73 @@
+#include <mgl/models/meshes/mglVertexQuantizer.hpp>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+    float snorm10(mgl::ui32 packed, int component) {
+        int value = static_cast<int>((packed >> (10 * component)) & 0x3ffu);
+        if (value >= 512) value -= 1024;
+        return std::max(value / 511.0f, -1.0f);
+    }
+
+} // namespace
+
+TEST(VertexQuantizerTest, PositionsRoundTripThroughDequantization)
+{
+    const std::vector<mgl::math::vec3> positions = {
+        mgl::math::vec3(-2.0f, 0.5f, 10.0f),
+        mgl::math::vec3(3.0f, 1.5f, 12.0f),
+        mgl::math::vec3(0.25f, 0.75f, 11.0f),
+    };
+    const mgl::VertexQuantizer quantizer = mgl::VertexQuantizer::fromPositions(positions);
+
+    for (const mgl::math::vec3& p : positions) {
+        mgl::u16 q[4];
+        quantizer.position(p, q);
+        const mgl::math::vec4 unit(q[0] / 65535.0f, q[1] / 65535.0f, q[2] / 65535.0f, 1.0f);
+        const mgl::math::vec4 restored = quantizer.dequantization() * unit;
+        for (int i = 0; i < 3; i++) {
+            EXPECT_NEAR(restored[i], p[i], 1e-4f);
+        }
+    }
+}
+
+TEST(VertexQuantizerTest, NormalsSurviveNormalMatrixOfDequantization)
+{
+    // non-uniform bounds: the normal matrix of the dequantization is diag(1 / extent)
+    const mgl::math::vec3 min(0.0f, 0.0f, 0.0f), max(10.0f, 1.0f, 0.1f);
+    const mgl::VertexQuantizer quantizer(min, max);
+    const mgl::math::vec3 normal = mgl::math::vec3(1.0f, 2.0f, -3.0f).normalized();
+
+    const mgl::ui32 packed = quantizer.normal(normal);
+    mgl::math::vec3 restored(snorm10(packed, 0) / 10.0f, snorm10(packed, 1) / 1.0f, snorm10(packed, 2) / 0.1f);
+    restored = restored.normalized();
+
+    for (int i = 0; i < 3; i++) {
+        EXPECT_NEAR(restored[i], normal[i], 0.02f);
+    }
+}
+
+TEST(VertexQuantizerTest, HalfFloatConversion)
+{
+    for (float value : { 0.0f, 1.0f, -2.25f, 0.333f, 1024.5f, 65504.0f, 6.1e-5f, 3.0e-7f }) {
+        const float restored = mgl::VertexQuantizer::fromHalf(mgl::VertexQuantizer::toHalf(value));
+        EXPECT_NEAR(restored, value, std::abs(value) * 1e-3f + 6e-8f) << value;
+    }
+    EXPECT_TRUE(std::isinf(mgl::VertexQuantizer::fromHalf(mgl::VertexQuantizer::toHalf(70000.0f))));
+    EXPECT_TRUE(std::isnan(mgl::VertexQuantizer::fromHalf(
+        mgl::VertexQuantizer::toHalf(std::numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST(VertexQuantizerTest, ColorsClampToUnorm8)
+{
+    mgl::u8 out[4];
+    mgl::VertexQuantizer::color(mgl::math::vec4(0.0f, 0.5f, 1.0f, 2.0f), out);
+    EXPECT_EQ(out[0], 0);
+    EXPECT_EQ(out[1], 128);
+    EXPECT_EQ(out[2], 255);
+    EXPECT_EQ(out[3], 255);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <gtest/gtest.h>
+
+#include <cctype>
+#include <filesystem>
+#include <string>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace mgl::test {
+
+// Fresh directory under the system temp directory, named after the running
+// test and the process, so test processes run in parallel (ctest -j) never
+// share one
+inline std::filesystem::path uniqueTempDir()
+{
+    const ::testing::TestInfo* info = ::testing::UnitTest::GetInstance()->current_test_info();
+#ifdef _WIN32
+    const int pid = _getpid();
+#else
+    const int pid = static_cast<int>(getpid());
+#endif
+    std::string name = std::string("mgl-") + info->test_suite_name() + "-" + info->name() + "-" + std::to_string(pid);
+    for (char& c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '-') c = '_'; // parameterized names hold '/'
+    }
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    return dir;
+}
+
+// Fixture owning a uniqueTempDir(), removed after the test
+class TempDirTest : public ::testing::Test {
+protected:
+    std::filesystem::path dir;
+
+    void SetUp() override { dir = uniqueTempDir(); }
+    void TearDown() override { std::filesystem::remove_all(dir); }
+};
+
+} // namespace mgl::test
@@ -0,0 +1,95 @@
+#include <utils/file.hpp>
+#include <gtest/gtest.h>
+#include "../test_temp_dir.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace {
+
+    class FileTest : public mgl::test::TempDirTest {
+    protected:
+        std::filesystem::path resources;
+
+        void SetUp() override {
+            TempDirTest::SetUp();
+            resources = file::resource_dir();
+            file::set_resource_dir(dir / "resources");
+        }
+
+        void TearDown() override {
+            file::vfs().unmountAll();
+            file::set_resource_dir(resources);
+            TempDirTest::TearDown();
+        }
+
+        std::filesystem::path write(const std::filesystem::path& path, const std::string& text) {
+            std::filesystem::create_directories(path.parent_path());
+            std::ofstream(path, std::ios::binary) << text;
+            return path;
+        }
+    };
+
+} // namespace
+
+TEST_F(FileTest, PackRoundTripsAlignedEntries)
+{
+    const std::filesystem::path pack = dir / "assets.mglpack";
+    ASSERT_TRUE(file::PackFile::write(pack, {
+        { "shaders/a.glsl", write(dir / "in/a", "abc") },
+        { "empty.txt", write(dir / "in/empty", "") },
+        { "models/b.obj", write(dir / "in/b", "v 0 0 0\n") },
+    }));
+
+    const auto opened = file::PackFile::open(pack);
+    ASSERT_NE(opened, nullptr);
+    EXPECT_EQ(opened->size(), 3u);
+    const file::Resource a = opened->find("shaders/a.glsl");
+    ASSERT_TRUE(a);
+    EXPECT_EQ(a.text(), "abc");
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(a.data()) % 16, 0u);
+    EXPECT_EQ(opened->find("models/b.obj").text(), "v 0 0 0\n");
+    // packed empty files are found
+    EXPECT_TRUE(opened->find("empty.txt"));
+    EXPECT_EQ(opened->find("empty.txt").size(), 0u);
+    EXPECT_FALSE(opened->find("missing"));
+
+    write(dir / "bad.mglpack", "not a pack");
+    EXPECT_EQ(file::PackFile::open(dir / "bad.mglpack"), nullptr);
+    EXPECT_EQ(file::PackFile::open(dir / "missing.mglpack"), nullptr);
+}
+
+TEST_F(FileTest, MountedPacksTakePrecedenceOverLooseFiles)
+{
+    write(dir / "resources/shaders/a.glsl", "loose");
+    write(dir / "resources/only-loose.txt", "only loose");
+    ASSERT_TRUE(file::PackFile::write(dir / "first.mglpack", { { "shaders/a.glsl", write(dir / "in/a1", "first") } }));
+    ASSERT_TRUE(file::PackFile::write(dir / "second.mglpack", { { "shaders/a.glsl", write(dir / "in/a2", "second") } }));
+
+    EXPECT_EQ(file::readFile("shaders/a.glsl"), "loose");
+    ASSERT_TRUE(file::vfs().mount(dir / "first.mglpack"));
+    EXPECT_EQ(file::readFile("shaders/a.glsl"), "first");
+    ASSERT_TRUE(file::vfs().mount(dir / "second.mglpack"));
+    // paths are normalized before the lookup
+    EXPECT_EQ(file::readFile("shaders/../shaders/./a.glsl"), "second");
+    EXPECT_EQ(file::readFile("only-loose.txt"), "only loose");
+    EXPECT_EQ(file::readFile("missing.txt"), FILE_DOESNT_EXIST);
+    EXPECT_FALSE(file::vfs().mount(dir / "missing.mglpack"));
+
+    // absolute paths name loose files
+    EXPECT_EQ(file::vfs().open((dir / "resources/shaders/a.glsl").string()).text(), "loose");
+}
+
+TEST_F(FileTest, ResourcesOutliveTheirPack)
+{
+    ASSERT_TRUE(file::PackFile::write(dir / "assets.mglpack", { { "a.txt", write(dir / "in/a", "packed") } }));
+    ASSERT_TRUE(file::vfs().mount(dir / "assets.mglpack"));
+    const file::Resource resource = file::vfs().open("a.txt");
+    file::vfs().unmountAll();
+    std::filesystem::remove(dir / "assets.mglpack");
+
+    EXPECT_FALSE(file::vfs().exists("a.txt"));
+    ASSERT_TRUE(resource);
+    EXPECT_EQ(resource.text(), "packed");
+}
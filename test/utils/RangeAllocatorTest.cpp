@@ -0,0 +1,55 @@
+#include <utils/RangeAllocator.hpp>
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+
+TEST(RangeAllocatorTest, AllocatesFirstFitAndMergesFreedRanges)
+{
+    util::RangeAllocator allocator(100);
+    const size_t a = allocator.allocate(30);
+    const size_t b = allocator.allocate(30);
+    const size_t c = allocator.allocate(30);
+    ASSERT_EQ(a, 0u);
+    ASSERT_EQ(b, 30u);
+    ASSERT_EQ(c, 60u);
+    ASSERT_EQ(allocator.allocate(20), util::RangeAllocator::INVALID);
+
+    allocator.free(a);
+    allocator.free(c);
+    ASSERT_EQ(allocator.freeRangeCount(), 2u);
+    ASSERT_EQ(allocator.largestFree(), 40u);
+    ASSERT_GT(allocator.fragmentation(), 0.0f);
+
+    // the hole at the front is reused first
+    ASSERT_EQ(allocator.allocate(10), 0u);
+
+    allocator.free(0);
+    allocator.free(b);
+    ASSERT_EQ(allocator.freeRangeCount(), 1u);
+    ASSERT_EQ(allocator.largestFree(), 100u);
+    ASSERT_EQ(allocator.used(), 0u);
+    ASSERT_FLOAT_EQ(allocator.fragmentation(), 0.0f);
+}
+
+TEST(RangeAllocatorTest, AlignsOffsetsAndKeepsPadding)
+{
+    util::RangeAllocator allocator(64);
+    ASSERT_EQ(allocator.allocate(3), 0u);
+    const size_t aligned = allocator.allocate(8, 4);
+    ASSERT_EQ(aligned, 4u);
+    ASSERT_EQ(allocator.sizeOf(aligned), 8u);
+    // the padding between both ranges is still usable
+    ASSERT_EQ(allocator.allocate(1), 3u);
+}
+
+TEST(RangeAllocatorTest, GrowsIntoTrailingFreeRange)
+{
+    util::RangeAllocator allocator(10);
+    allocator.allocate(6);
+    ASSERT_EQ(allocator.allocate(10), util::RangeAllocator::INVALID);
+    allocator.grow(20);
+    ASSERT_EQ(allocator.freeRangeCount(), 1u);
+    ASSERT_EQ(allocator.allocate(10), 6u);
+    ASSERT_EQ(allocator.capacity(), 20u);
+    ASSERT_THROW(allocator.free(1), std::invalid_argument);
+}
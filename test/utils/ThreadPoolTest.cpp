@@ -0,0 +1,56 @@
+#include <utils/ThreadPool.hpp>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+TEST(ThreadPoolTest, VisitsEveryIndexOnce)
+{
+    util::ThreadPool pool(4);
+    std::vector<std::atomic<int>> visits(1000);
+
+    pool.parallelFor(visits.size(), [&](size_t i, size_t worker) {
+        ASSERT_LT(worker, pool.size());
+        visits[i]++;
+    });
+
+    for (const auto& v : visits) {
+        ASSERT_EQ(v.load(), 1);
+    }
+}
+
+TEST(ThreadPoolTest, ConsecutiveLoops)
+{
+    util::ThreadPool pool(3);
+    std::atomic<size_t> total{ 0 };
+
+    for (size_t round = 1; round <= 200; round++) {
+        pool.parallelFor(round, [&](size_t, size_t) { total++; });
+    }
+    ASSERT_EQ(total.load(), 200u * 201u / 2u);
+}
+
+TEST(ThreadPoolTest, EmptyLoop)
+{
+    util::ThreadPool pool(2);
+    bool called = false;
+    pool.parallelFor(0, [&](size_t, size_t) { called = true; });
+    ASSERT_FALSE(called);
+}
+
+TEST(ThreadPoolTest, NestedLoopRunsInline)
+{
+    util::ThreadPool pool(2);
+    std::vector<std::atomic<int>> visits(16 * 8);
+
+    pool.parallelFor(16, [&](size_t outer, size_t worker) {
+        pool.parallelFor(8, [&](size_t inner, size_t innerWorker) {
+            ASSERT_EQ(innerWorker, worker);
+            visits[outer * 8 + inner]++;
+        });
+    });
+
+    for (const auto& v : visits) {
+        ASSERT_EQ(v.load(), 1);
+    }
+}
@@ -0,0 +1,285 @@
+/*
+    mgl-assetc - compiles a resources directory into the engine's runtime caches.
+
+    usage: mgl-assetc [options] <resources-dir> [<cache-dir>]
+
+    Every asset is compiled into the cache the engine reads it from, keyed so
+    that loading becomes a memory mapping and an upload:
+    - meshes (any format Assimp reads) -> <cache-dir>/meshes, see MeshCache
+    - images -> <cache-dir>/textures, mip chains block compressed, see TextureCache
+    - shaders -> <cache-dir>/shaders, includes expanded, see ShaderSource
+
+    <cache-dir> defaults to <exe_dir>/cache, where applications built next to
+    the tool look. Mesh cache keys include the import settings, so the mesh
+    options must mirror the application's mesh configuration exactly - e.g.
+    --join-vertices --meshlets for a callback calling joinIdenticalVertices()
+    and buildMeshlets(). Any other entry is never looked up.
+
+    Assets are compiled in parallel on all cores. Only the ones whose inputs
+    changed since the last run are rebuilt.
+
+    With --pack, every resource file is also archived into a single pack (see
+    file::PackFile). Applications mount <exe_dir>/resources.mglpack at startup
+    and read resources from it instead of the loose files.
+*/
+
+#include <mgl/models/meshes/mglMesh.hpp>
+#include <mgl/models/meshes/mglMeshCache.hpp>
+#include <mgl/models/textures/mglTextureCache.hpp>
+#include <mgl/models/textures/mglTextureCompressor.hpp>
+#include <mgl/shaders/ShaderSource.hpp>
+#include <utils/Logger.hpp>
+#include <utils/ThreadPool.hpp>
+#include <utils/file.hpp>
+#include <utils/stb_image.h>
+
+#include <assimp/Importer.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    struct Options {
+        fs::path resources;
+        fs::path cache;
+        fs::path pack;
+        bool rawTextures = false;
+        bool force = false;
+        bool optimize = false;
+        unsigned lods = 0;
+        bool meshlets = false;
+        bool smoothNormals = false;
+        bool flipUVs = false;
+        bool joinVertices = false;
+        unsigned assimpFlags = 0;
+        bool nativeObj = true;
+    };
+
+    enum class Kind { MESH, TEXTURE, SHADER };
+    enum class Status { UP_TO_DATE, BUILT, FAILED };
+
+    struct Asset {
+        Kind kind;
+        std::string path; // relative to the resources directory
+    };
+
+    void usage() {
+        std::cerr <<
+            "usage: mgl-assetc [options] <resources-dir> [<cache-dir>]\n"
+            "  <cache-dir>        output directory (default: <exe_dir>/cache)\n"
+            "  --force            rebuild every asset\n"
+            "  --raw-textures     keep texture mips uncompressed\n"
+            "  --optimize         run the vertex cache, overdraw and vertex fetch passes on meshes\n"
+            "  --lods <n>         generate n simplified LODs per mesh\n"
+            "  --meshlets         build meshlets with the default limits\n"
+            "  --smooth-normals   generate smooth normals for meshes without normals\n"
+            "  --flip-uvs         flip mesh texture coordinates vertically\n"
+            "  --join-vertices    weld identical mesh vertices\n"
+            "  --assimp-flags <m> extra aiProcess flags for meshes (decimal or 0x hex mask)\n"
+            "  --no-native-obj    import .obj files through Assimp instead of ObjLoader\n"
+            "  --pack <file>      also archive the resources into a pack file\n";
+    }
+
+    bool parseArguments(int argc, char** argv, Options& options) {
+        std::vector<std::string> positional;
+        for (int i = 1; i < argc; i++) {
+            const std::string argument = argv[i];
+            if (argument == "--force") options.force = true;
+            else if (argument == "--raw-textures") options.rawTextures = true;
+            else if (argument == "--optimize") options.optimize = true;
+            else if (argument == "--meshlets") options.meshlets = true;
+            else if (argument == "--smooth-normals") options.smoothNormals = true;
+            else if (argument == "--flip-uvs") options.flipUVs = true;
+            else if (argument == "--join-vertices") options.joinVertices = true;
+            else if (argument == "--no-native-obj") options.nativeObj = false;
+            else if (argument == "--assimp-flags" && i + 1 < argc) {
+                options.assimpFlags = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 0));
+            }
+            else if (argument == "--lods" && i + 1 < argc) options.lods = static_cast<unsigned>(std::atoi(argv[++i]));
+            else if (argument == "--pack" && i + 1 < argc) options.pack = fs::absolute(argv[++i]).lexically_normal();
+            else if (argument.starts_with("-")) return false;
+            else positional.push_back(argument);
+        }
+        if (positional.empty() || positional.size() > 2) return false;
+        options.resources = fs::absolute(positional[0]).lexically_normal();
+        options.cache = positional.size() > 1 ? fs::absolute(positional[1]).lexically_normal() : file::exe_dir() / "cache";
+        return fs::is_directory(options.resources);
+    }
+
+    void configure(mgl::Mesh& mesh, const Options& options) {
+        if (options.assimpFlags != 0) mesh.setAssimpFlags(options.assimpFlags);
+        if (options.joinVertices) mesh.joinIdenticalVertices();
+        if (options.smoothNormals) mesh.generateSmoothNormals();
+        if (options.flipUVs) mesh.flipUVs();
+        if (options.optimize) {
+            mesh.optimizeVertexCache();
+            mesh.optimizeOverdraw();
+            mesh.optimizeVertexFetch();
+        }
+        if (options.lods > 0) mesh.generateLods(options.lods);
+        if (options.meshlets) mesh.buildMeshlets();
+        if (!options.nativeObj) mesh.useNativeObj(false);
+    }
+
+    // Whether path is inside the output directory, which may live inside the resources
+    bool inCache(const fs::path& path, const Options& options) {
+        const fs::path relative = path.lexically_relative(options.cache);
+        return !relative.empty() && *relative.begin() != "..";
+    }
+
+    std::vector<Asset> findAssets(const Options& options) {
+        static const std::vector<std::string> IMAGES = { ".png", ".jpg", ".jpeg", ".tga", ".bmp", ".psd", ".gif" };
+        static const std::vector<std::string> SHADERS = { ".glsl", ".vert", ".frag", ".geom", ".comp", ".tesc", ".tese" };
+        auto contains = [](const std::vector<std::string>& list, const std::string& extension) {
+            return std::find(list.begin(), list.end(), extension) != list.end();
+        };
+
+        Assimp::Importer importer;
+        std::vector<Asset> assets;
+        for (const fs::directory_entry& entry : fs::recursive_directory_iterator(options.resources)) {
+            if (!entry.is_regular_file()) continue;
+            if (inCache(entry.path(), options)) continue;
+            const fs::path relative = entry.path().lexically_relative(options.resources);
+
+            std::string extension = entry.path().extension().string();
+            std::transform(extension.begin(), extension.end(), extension.begin(),
+                [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            if (contains(IMAGES, extension)) assets.push_back({ Kind::TEXTURE, relative.generic_string() });
+            else if (contains(SHADERS, extension)) assets.push_back({ Kind::SHADER, relative.generic_string() });
+            else if (importer.IsExtensionSupported(extension)) assets.push_back({ Kind::MESH, relative.generic_string() });
+        }
+        // largest files first, so they do not end up last on a single core
+        std::sort(assets.begin(), assets.end(), [&options](const Asset& a, const Asset& b) {
+            return fs::file_size(options.resources / a.path) > fs::file_size(options.resources / b.path);
+        });
+        return assets;
+    }
+
+    Status compileMesh(const Asset& asset, const Options& options, Assimp::Importer& importer) {
+        mgl::Mesh mesh;
+        configure(mesh, options);
+        const mgl::u64 key = mesh.cacheKey(asset.path);
+        if (key == 0) return Status::FAILED;
+        if (options.force) {
+            std::error_code error;
+            fs::remove(mgl::MeshCache::entryPath(key), error);
+        } else if (mgl::MeshCache::open(key)) {
+            return Status::UP_TO_DATE;
+        }
+        // load() writes the cache entry
+        return mesh.load(asset.path, importer, key) ? Status::BUILT : Status::FAILED;
+    }
+
+    Status compileTexture(const Asset& asset, const Options& options) {
+        using mgl::TextureCompressor;
+        const file::Resource source = file::vfs().open(asset.path);
+        if (!source) return Status::FAILED;
+        const mgl::u64 key = mgl::TextureCache::makeKey(source.bytes());
+        if (!options.force) {
+            const auto compiled = mgl::TextureCache::open(key);
+            if (compiled && (compiled->format == TextureCompressor::Format::RAW) == options.rawTextures) {
+                return Status::UP_TO_DATE;
+            }
+        }
+
+        int width, height, channels;
+        stbi_uc* pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(source.data()),
+            static_cast<int>(source.size()), &width, &height, &channels, 0);
+        if (!pixels) {
+            MGL_ERROR("Could not decode image [{}]: {}", asset.path, stbi_failure_reason());
+            return Status::FAILED;
+        }
+        TextureCompressor::Image image{ mgl::ui32(width), mgl::ui32(height), mgl::ui32(channels),
+            std::vector<mgl::u8>(pixels, pixels + size_t(width) * height * channels) };
+        stbi_image_free(pixels);
+
+        std::vector<TextureCompressor::Image> mips = TextureCompressor::mipChain(std::move(image));
+        if (mips.size() > mgl::TextureCache::MAX_LEVELS) {
+            MGL_ERROR("Image [{}] is too large ({}x{})", asset.path, width, height);
+            return Status::FAILED;
+        }
+        const TextureCompressor::Format format = options.rawTextures
+            ? TextureCompressor::Format::RAW : TextureCompressor::formatFor(mips[0].channels);
+        std::vector<std::vector<mgl::u8>> levels;
+        for (const TextureCompressor::Image& mip : mips) {
+            levels.push_back(TextureCompressor::compress(mip, format));
+        }
+        return mgl::TextureCache::store(key, format, mips[0].channels, mips[0].width, mips[0].height, levels)
+            ? Status::BUILT : Status::FAILED;
+    }
+
+    Status compileShader(const Asset& asset, const Options& options) {
+        if (!options.force && mgl::ShaderSource::isCompiled(asset.path)) {
+            return Status::UP_TO_DATE;
+        }
+        const std::optional<mgl::ShaderSource> source = mgl::ShaderSource::preprocess(asset.path);
+        return source && source->store(asset.path) ? Status::BUILT : Status::FAILED;
+    }
+
+    bool writePack(const Options& options) {
+        std::vector<file::PackFile::Input> inputs;
+        for (const fs::directory_entry& entry : fs::recursive_directory_iterator(options.resources)) {
+            if (!entry.is_regular_file() || inCache(entry.path(), options) || entry.path() == options.pack) continue;
+            inputs.push_back({ entry.path().lexically_relative(options.resources).generic_string(), entry.path() });
+        }
+        if (!file::PackFile::write(options.pack, inputs)) {
+            MGL_ERROR("Could not write pack {}", options.pack.string());
+            return false;
+        }
+        MGL_INFO("Packed {} file(s) -> {}", inputs.size(), options.pack.string());
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArguments(argc, argv, options)) {
+        usage();
+        return EXIT_FAILURE;
+    }
+    mgl::log::init((options.cache / "mgl-assetc.log").string());
+
+    file::set_resource_dir(options.resources);
+    mgl::MeshCache::setDirectory(options.cache / "meshes");
+    mgl::TextureCache::setDirectory(options.cache / "textures");
+    mgl::ShaderSource::setCacheDirectory(options.cache / "shaders");
+    // images are stored the way Texture2D uploads them
+    stbi_set_flip_vertically_on_load(true);
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<Asset> assets = findAssets(options);
+
+    // Assimp importers are not thread-safe - each worker reuses its own
+    util::ThreadPool& pool = util::ThreadPool::shared();
+    std::vector<Assimp::Importer> importers(pool.size());
+    std::vector<Status> results(assets.size());
+    pool.parallelFor(assets.size(), [&](size_t i, size_t worker) {
+        const Asset& asset = assets[i];
+        switch (asset.kind) {
+        case Kind::MESH:    results[i] = compileMesh(asset, options, importers[worker]); break;
+        case Kind::TEXTURE: results[i] = compileTexture(asset, options); break;
+        case Kind::SHADER:  results[i] = compileShader(asset, options); break;
+        }
+        if (results[i] == Status::BUILT) MGL_INFO("Compiled {}", asset.path);
+        if (results[i] == Status::FAILED) MGL_ERROR("Failed to compile {}", asset.path);
+    });
+
+    const auto count = [&results](Status status) { return std::count(results.begin(), results.end(), status); };
+    const auto elapsed = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+    MGL_INFO("{} asset(s) compiled, {} up to date, {} failed in {:.1f} ms [{} threads] -> {}",
+        count(Status::BUILT), count(Status::UP_TO_DATE), count(Status::FAILED), elapsed,
+        pool.size(), options.cache.string());
+    const bool packed = options.pack.empty() || writePack(options);
+    return count(Status::FAILED) == 0 && packed ? EXIT_SUCCESS : EXIT_FAILURE;
+}